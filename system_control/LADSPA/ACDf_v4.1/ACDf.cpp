@@ -35,14 +35,13 @@
 #include <ladspa.h>
 #include <string>
 #include <iostream>
+#include "ACDf_coefficients.h"
+#include "silence_gate.h"
+#include "telemetry.h"
 using namespace std;
 
 
 #define D_(s) (s)
-#define DENORMALKILLER 1.e-15; //1.e-15 corresponds to -300dB
-  //DENORMALKILLER is added to the filter output to avoid denormal values that 
-  //may slow the calculation on some hardware when very small values are
-  //produced. The added signal is a square wave at the Nyquist frequency.
 
 
 //order of parameters:
@@ -53,8 +52,13 @@ using namespace std;
 #define ACDf_QP           4 
 #define ACDf_FZ           5 
 #define ACDf_QZ           6 
-#define ACDf_INPUT        7 
-#define ACDf_OUTPUT       8 
+#define ACDf_RAMP         7 
+#define ACDf_INPUT        8 
+#define ACDf_OUTPUT       9 
+#define ACDf_NUM_PORTS    10
+#define ACDf_NUM_FILTER_PARAMS 7 //type through qz
+
+#define ACDf_FADE_CHUNK   64 //number of samples processed per pass during a crossfade
 
 
 static LADSPA_Descriptor *ACDfDescriptor = NULL;
@@ -74,8 +78,18 @@ typedef struct {
 	LADSPA_Data *Qp;
 	LADSPA_Data *Fz;
 	LADSPA_Data *Qz;
+	LADSPA_Data *ramp;
   LADSPA_Data rate;
   biquad * filter;
+  //the parameter values that were used to calculate the filter. When they change
+  //  the new filter is faded in while the previous one is faded out.
+  LADSPA_Data settings[ACDf_NUM_FILTER_PARAMS];
+  biquad * previous;
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  unsigned int fade_blocks; //total number of blocks of the crossfade
+  unsigned int fade_remaining; //number of blocks left in the crossfade
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
 	LADSPA_Data *input;
 	LADSPA_Data *output;
 } ACDf;
@@ -100,6 +114,9 @@ LADSPA_Handle instantiateACDf(const LADSPA_Descriptor *descriptor,
 	biquad *f = NULL;
 	f = (biquad *)malloc(sizeof(biquad));
 	pluginData->filter = f;
+	pluginData->previous = (biquad *)malloc(sizeof(biquad));
+	pluginData->run_adding_gain = 1.0;
+  pluginData->meter.record = NULL;
 
   return (LADSPA_Handle)pluginData;
 }
@@ -129,6 +146,9 @@ void connectPortACDf(LADSPA_Handle instance, unsigned long port, LADSPA_Data *da
 	case ACDf_QZ:
 		pluginData->Qz = data;
 		break;
+	case ACDf_RAMP:
+		pluginData->ramp = data;
+		break;
 	case ACDf_INPUT:
 		pluginData->input = data;
 		break;
@@ -139,9 +159,9 @@ void connectPortACDf(LADSPA_Handle instance, unsigned long port, LADSPA_Data *da
 }
 
 
-void activateACDf(LADSPA_Handle instance) {
-  ACDf *pluginData = (ACDf *)instance;
-	biquad *f = pluginData->filter;
+static void calculate_filter(ACDf *pluginData, biquad *f) {
+  //calculates the filter coefficients from the current parameter values and 
+  //  remembers the values so that changes can be detected by run
   const LADSPA_Data ftype = *(pluginData->type);
   const LADSPA_Data fpolarity = *(pluginData->polarity); 
   const LADSPA_Data dBgain = *(pluginData->gain);
@@ -151,269 +171,71 @@ void activateACDf(LADSPA_Handle instance) {
   double Qz = *(pluginData->Qz);
   const LADSPA_Data SR = pluginData->rate;
 
-	//initialize some values...
-  f->x1 = 0.0;
-	f->x2 = 0.0;
-	f->y1 = DENORMALKILLER;
-	f->y2 = DENORMALKILLER;
-  f->dn = DENORMALKILLER;
+  pluginData->settings[ACDf_TYPE] = ftype;
+  pluginData->settings[ACDf_POLARITY] = fpolarity;
+  pluginData->settings[ACDf_GAIN] = dBgain;
+  pluginData->settings[ACDf_FP] = Fp;
+  pluginData->settings[ACDf_QP] = Qp;
+  pluginData->settings[ACDf_FZ] = Fz;
+  pluginData->settings[ACDf_QZ] = Qz;
 
 /* ====== BEGIN CODE TO CALCULATE FILTER TRANSFER FUNCTION COEFFICIENTS ========== */
-  double Aa0, Aa1, Aa2, Ab0, Ab1, Ab2; //analog TF coefficients
-  double Da0, Da1, Da2, Db0, Db1, Db2; //IIR digital TF coefficients
-  double voltage_gain; //voltage gain
-  double p_voltage_gain; //voltage gain including polarity
-  double Wp, Wz, Wp2, Wz2; //for analog radian frequency
-  bool reversed_polarity = false;
-  const double K = 2.0*SR;
-  const double K2 = K*K;
-  int type; //type is used internally to select filter
-  type = roundf((float)ftype); //round to nearest integer 
-  voltage_gain = pow(10.0,(0.05*dBgain)); //calculate voltage gain
-  p_voltage_gain = voltage_gain;
-  //if reverse polarity is indicated, multiply p_voltage_gain by -1
-  if (( fpolarity < -0.99 ) && (fpolarity > -1.01 )) {
-    p_voltage_gain *= -1.0;
-    reversed_polarity = true;
-  }
-  //error checking :
-  //  if  parameters are invalid, return silence.
-  if ( (Fp > 0.5*SR) || (Fp < 0) ) type = -1;
-  if ( (Fz > 0.5*SR) || (Fz < 0) ) type = -1;
-
-  //calculate analog domain radian frequencies  
-  Wp = 2.0*M_PI*Fp;
-  Wz = 2.0*M_PI*Fz;
-  //apply pre-warping 
-  Wp = K*tan( Wp/K );
-  Wz = K*tan( Wz/K );
-  //calculate square of pre-warped radian frequencies
-  Wp2 = Wp*Wp;
-  Wz2 = Wz*Wz;
-  //initialize these analog coefficient values to zero
-  Aa1 = Aa2 = Ab0 = Ab1 = Ab2 = 0.0;
-  //and initialize the value of analog coefficient a0 to 1.0
-  Aa0 = 1.0;
-
-  switch (type) {
-  case 0: //gain with polarity
-    Ab0 = p_voltage_gain;
-  break;
-  case 1: //1st order lowpass filter with gain and polarity
-    Ab0 = Wp * p_voltage_gain;
-    Aa1 = 1.0;
-    Aa0 = Wp;
-  break;
-  case 2: //1st order highpass filter with gain and polarity
-    Ab1 = p_voltage_gain;
-    Aa1 = 1.0;
-    Aa0 = Wp;
-  break;
-  case 3: //first order all-pass filter with polarity 
-    Ab1 = 1.0;
-    Ab0 = -1.0 * Wp;
-    if (reversed_polarity) {
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    } 
-    Aa1 = 1.0;
-    Aa0 = Wp;
-  break;
-  case 4: //1st order low shelf specified by gain, polarity, and Fp (used as center of shelf)
-    Wz = Wp * pow(10.0,(dBgain/40.0));
-    Wp = Wp2 / Wz;
-    Ab1 = 1.0;
-    Ab0 = Wz;
-    if (reversed_polarity) {
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    }
-    Aa1 = 1.0;
-    Aa0 = Wp;
-  break;
-  case 5: //1st order high shelf specified by gain, polarity, and Fp (used as center of shelf) 
-    Wz = Wp * pow(10.0,(-dBgain/40.0));
-    Wp = Wp2 / Wz;
-    Ab1 = 1.0 * voltage_gain;
-    Ab0 = Wz * voltage_gain;
-    if (reversed_polarity) {
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    }
-    Aa1 = 1.0;
-    Aa0 = Wp;
-  break;
-  case 21: //2nd order lowpass filter specified by gain, polarity, Fp, Qp
-    Ab0 = p_voltage_gain * Wp2;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 22: //2nd order highpass filter specified by gain, polarity, Fp, Qp
-    Ab2 = p_voltage_gain;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 23: //2nd order all-pass filter specified by gain, polarity, Fp, Qp
-    Ab2 = 1.0;
-    Ab1 = -1.0 * Wp/Qp;
-    Ab0 = Wp2;
-    if (reversed_polarity) {
-      Ab2 *= -1.0;
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    }
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 24: //2nd order low shelf specified by Fp (used as center of shelf), gain, Q, and polarity
-    Qz = Qp;
-    Wz = Wp * pow(10.0,(dBgain/80.0));
-    Wp = Wp2 / Wz;
-    Wz2 = Wz*Wz;
-    Wp2 = Wp*Wp;
-    Ab2 = 1.0;
-    Ab1 = Wz/Qz;
-    Ab0 = Wz2;
-    if (reversed_polarity) {
-      Ab2 *= -1.0;
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    }
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 25: //2nd order high shelf specified by Fp (used as center of shelf), gain, Q, and polarity
-    Qz = Qp;
-    Wz = Wp * pow(10.0,(-dBgain/80.0));
-    Wp = Wp2 / Wz;
-    Wz2 = Wz*Wz;
-    Wp2 = Wp*Wp;
-    Ab2 = voltage_gain;
-    Ab1 = voltage_gain * Wz/Qz;
-    Ab0 = voltage_gain * Wz2;
-    if (reversed_polarity) {
-      Ab2 *= -1.0;
-      Ab1 *= -1.0;
-      Ab0 *= -1.0;
-    }
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 26: //parametric EQ specified by gain, Fp, Qp 
-    Ab2 = 1.0;
-    Ab1 = Wp/Qp;
-    if (voltage_gain > 1.0) Ab1 *= voltage_gain;
-    Ab0 = Wp2;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    if (voltage_gain < 1.0) Aa1 /= voltage_gain;
-    Aa0 = Wp2;
-  break;
-  case 27: //2nd order notch specified by gain, polarity, Fp, Qp, Fz
-    Ab2 = p_voltage_gain;
-    Ab0 = p_voltage_gain * Wz2;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 28: //general biquadratic filter specified by gain, polarity, Fp,Qp,Fz,Qz 
-    Ab2 = p_voltage_gain;
-    Ab1 = p_voltage_gain * Wz/Qz;
-    Ab0 = p_voltage_gain * Wz2;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  case 77: //2nd order notch specified by polarity, Fp, Qp, Fz and with automatic gain calculation
-    // NOTE: the gain is automatically calculated for the LowPass notch and
-    //    any gain supplied by the user is ignored. Gain is calcualted as follows:
-    //     when Fp < Fz gain in dB = 40 log10( tan(p Fp/SR) / tan(p Fz/SR) )
-    //     otherwise gain in dB = 0
-    p_voltage_gain = voltage_gain = 1.0;
-    if (Fp < Fz ) {
-      //This is a Lowpass Notch filter. Calculate voltage gain and p_voltage_gain such that the
-      //  passband level is set to 0dB
-      voltage_gain = tan( M_PI*Fp/SR) / tan( M_PI*Fz/SR );
-      voltage_gain = pow( voltage_gain, 2.0 ); //calculate voltage gain
-      p_voltage_gain = voltage_gain;
-    }
-    //if reverse polarity is indicated, multiply p_voltage_gain by -1
-    if (( fpolarity < -0.99 ) && (fpolarity > -1.01 )) {
-      p_voltage_gain *= -1.0;
-      reversed_polarity = true;
-    }
-    //calculate analog TF coefficients
-    Ab2 = p_voltage_gain;
-    Ab0 = p_voltage_gain * Wz2;
-    Aa2 = 1.0;
-    Aa1 = Wp/Qp;
-    Aa0 = Wp2;
-  break;
-  default:
-    //if user supplies a non-supported filter type silence is returned
-    type = -1;
-  } //end switch-case, done computing analog transfer function coefficients 
-
-  //convert continuous time TF coefficients to discrete time TF coefficients
-  //  and put into normalized form: 
-  if (type < 1) { 
-    Da0 = 1.0;
-    Db0 = p_voltage_gain; //type = 0: gain stage
-    if (type == -1 ) {
-      //type is set to -1 if undefined types are supplied by user
-      Db0 = 0.0; //returns silence
-    }
-    Db1 = Db2 = Da1 = Da2 = 0.0; //not used for type = 0 or type = -1
-    //above is already in normalized form because Da0 = 1.0
-  } else if (type < 20 ) {
-    //convert the 1st order analog TF coefficients to z^-1 domain TF coefficients
-    Db0 = Ab1*K + Ab0;
-    Db1 = Ab0 - Ab1*K;
-    Da0 = Aa1*K + Aa0;
-    Da1 = Aa0 - Aa1*K;
-    //convert to normalized form by dividing thru by Da0:
-    Db0 /= Da0;
-    Db1 /= Da0;
-    Da1 /= Da0;
-    Da2 = 0.0; //not used, set to zero
-    Db2 = 0.0; //not used, set to zero
-  } else {
-    //convert the 2nd order analog TF coefficients to z^-1 domain TF coefficients
-    Db0 = Ab2*K2 + Ab1*K + Ab0;
-    Db1 = 2.0*Ab0 - 2.0*Ab2*K2;
-    Db2 = Ab2*K2 - Ab1*K + Ab0;
-    Da0 = Aa2*K2 + Aa1*K + Aa0;
-    Da1 = 2.0*Aa0 - 2.0*Aa2*K2;
-    Da2 = Aa2*K2 - Aa1*K + Aa0;
-    //convert to normalized form by dividing thru by Da0:
-    Db0 /= Da0;
-    Db1 /= Da0;
-    Db2 /= Da0;
-    Da1 /= Da0;
-    Da2 /= Da0;
-  }
-  //for all types, copy results into the respective plugin filter variables  
-  f->b0 = Db0;
-  f->b1 = Db1;
-  f->b2 = Db2;
-  f->a1 = Da1;
-  f->a2 = Da2;
-  //save the transfer function parameters into the plugin filter object
-	pluginData->filter = f;
+  //the calculation is shared with the other ACDf family plugins, see ACDf_coefficients.h
+  ACDf_coefficients c;
+  calculate_ACDf_coefficients(ftype, fpolarity, dBgain, Fp, Qp, Fz, Qz, SR, &c);
+  //copy results into the respective plugin filter variables  
+  f->b0 = c.b0;
+  f->b1 = c.b1;
+  f->b2 = c.b2;
+  f->a1 = c.a1;
+  f->a2 = c.a2;
 /* ======= END CODE TO CALCULATE FILTER TRANSFER FUNCTION COEFFICIENTS =========== */
-} //end activateACDf
+} //end calculate_filter
+
+
+static bool parameters_changed(const ACDf *pluginData) {
+  //compares the parameter values with those that were used to calculate the filter
+  return *(pluginData->type) != pluginData->settings[ACDf_TYPE]
+      || *(pluginData->polarity) != pluginData->settings[ACDf_POLARITY]
+      || *(pluginData->gain) != pluginData->settings[ACDf_GAIN]
+      || *(pluginData->Fp) != pluginData->settings[ACDf_FP]
+      || *(pluginData->Qp) != pluginData->settings[ACDf_QP]
+      || *(pluginData->Fz) != pluginData->settings[ACDf_FZ]
+      || *(pluginData->Qz) != pluginData->settings[ACDf_QZ];
+}
 
 
-void runACDf(LADSPA_Handle instance, unsigned long sample_count) {
+static void clear_biquad(biquad *f) {
+  //sets the state of the filter to that of a newly activated one
+  f->x1 = 0.0;
+  f->x2 = 0.0;
+  f->y1 = DENORMALKILLER;
+  f->y2 = DENORMALKILLER;
+  f->dn = DENORMALKILLER;
+}
+
+
+void activateACDf(LADSPA_Handle instance) {
   ACDf *pluginData = (ACDf *)instance;
-  const LADSPA_Data *input = pluginData->input;
-  LADSPA_Data *output = pluginData->output;
 	biquad *f = pluginData->filter;
+
+	//initialize some values...
+  clear_biquad(f);
+  pluginData->fade_blocks = 0;
+  pluginData->fade_remaining = 0;
+
+  calculate_filter(pluginData, f);
+  set_silence_gate(&pluginData->gate, silence_decay_samples(f->a1, f->a2));
+
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "type %g Fp %g Qp %g", *(pluginData->type), *(pluginData->Fp), *(pluginData->Qp));
+  telemetry_open(&pluginData->meter, "ACDf", info, 1, pluginData->rate);
+} //end activateACDf
+
+
+static inline void run_biquad(biquad *f, const LADSPA_Data *input, LADSPA_Data *output,
+                              unsigned long sample_count, const bool adding, const LADSPA_Data gain) {
+  //when adding is true the result, multiplied by gain, is added to the output
   double x,y;
 	unsigned long pos;
 
@@ -423,7 +245,7 @@ void runACDf(LADSPA_Handle instance, unsigned long sample_count) {
       x = (double)input[pos];
       y = f->b0 * x + f->dn;
       f->dn = -f->dn;
-      output[pos] = (LADSPA_Data)y;
+      if (adding) output[pos] += gain * (LADSPA_Data)y; else output[pos] = (LADSPA_Data)y;
   	}
     return;
   }
@@ -436,7 +258,7 @@ void runACDf(LADSPA_Handle instance, unsigned long sample_count) {
       f->dn = -f->dn;
       f->x1 = x;
       f->y1 = y;
-      output[pos] = (LADSPA_Data)y;
+      if (adding) output[pos] += gain * (LADSPA_Data)y; else output[pos] = (LADSPA_Data)y;
   	}
     return;
   }
@@ -450,14 +272,107 @@ void runACDf(LADSPA_Handle instance, unsigned long sample_count) {
     f->x1 = x;
     f->y2 = f->y1;
     f->y1 = y;
-    output[pos] = (LADSPA_Data)y;
+    if (adding) output[pos] += gain * (LADSPA_Data)y; else output[pos] = (LADSPA_Data)y;
 	}
+} //end run_biquad
+
+
+static inline void processACDf(ACDf *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
+  const LADSPA_Data *input = pluginData->input;
+  LADSPA_Data *output = pluginData->output;
+	biquad *f = pluginData->filter;
+	biquad *previous = pluginData->previous;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  LADSPA_Data faded_out[ACDf_FADE_CHUNK], faded_in[ACDf_FADE_CHUNK];
+  LADSPA_Data y;
+  double g, g_start, g_step;
+  unsigned long pos, chunk, i;
+
+  //check for new parameter values. A change that is made during a crossfade is 
+  //  picked up once the crossfade has finished.
+  if ( pluginData->fade_remaining == 0  &&  parameters_changed(pluginData) ) {
+    //keep the current filter, including its state, for the crossfade
+    *previous = *f;
+    //the new filter continues from the state of the current one. A gain stage
+    //  does not update the state and a first order filter only updates x1 and y1.
+    if ( f->a1 == 0.0  &&  f->a2 == 0.0 ) {
+      f->x1 = 0.0;
+      f->y1 = DENORMALKILLER;
+    }
+    if ( f->a2 == 0.0 ) {
+      f->x2 = 0.0;
+      f->y2 = DENORMALKILLER;
+    }
+    calculate_filter(pluginData, f);
+    pluginData->fade_blocks = (unsigned int)( *(pluginData->ramp) + 0.5 );
+    pluginData->fade_remaining = pluginData->fade_blocks;
+    //the hold time of the silence gate depends on the new coefficients
+    set_silence_gate(&pluginData->gate, silence_decay_samples(f->a1, f->a2));
+  }
+
+  if ( pluginData->fade_remaining == 0 ) {
+    if ( silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count) ) {
+      write_silence(output, sample_count, adding);
+      return;
+    }
+    run_biquad(f, input, output, sample_count, adding, gain);
+    if ( silence_gate_closing(&pluginData->gate) ) clear_biquad(f);
+    return;
+  }
+
+  //crossfade from the previous filter to the new one. The weight of the new
+  //  filter rises linearly over fade_blocks blocks. Both filters are calculated
+  //  in short chunks so that the input is read before it may be overwritten by
+  //  the output (the host may use the same buffer for both).
+  g_start = (double)(pluginData->fade_blocks - pluginData->fade_remaining) / pluginData->fade_blocks;
+  g_step = 1.0 / ( (double)pluginData->fade_blocks * sample_count );
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > ACDf_FADE_CHUNK) chunk = ACDf_FADE_CHUNK;
+    run_biquad(previous, input + pos, faded_out, chunk, false, 1.0);
+    run_biquad(f, input + pos, faded_in, chunk, false, 1.0);
+    for (i = 0; i < chunk; i++) {
+      g = g_start + g_step * (pos + i + 1);
+      y = (LADSPA_Data)( faded_out[i] + g * (faded_in[i] - faded_out[i]) );
+      if (adding) output[pos+i] += gain * y; else output[pos+i] = y;
+    }
+  }
+  pluginData->fade_remaining -= 1;
+} //end processACDf
+
+
+static inline void meterACDf(ACDf *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, &pluginData->output, sample_count, state, start);
+}
+
+
+void runACDf(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDf *)instance)->meter);
+  processACDf((ACDf *)instance, sample_count, false);
+  meterACDf((ACDf *)instance, sample_count, start);
 } //end runACDf.
 
 
+void runAddingACDf(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDf *)instance)->meter);
+  processACDf((ACDf *)instance, sample_count, true);
+  meterACDf((ACDf *)instance, sample_count, start);
+} //end runAddingACDf
+
+
+void setRunAddingGainACDf(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((ACDf *)instance)->run_adding_gain = gain;
+}
+
+
 void cleanupACDf(LADSPA_Handle instance) {
 	ACDf *pluginData = (ACDf *)instance;
+	telemetry_close(&pluginData->meter);
 	free(pluginData->filter);
+	free(pluginData->previous);
 	free(instance);
 }
 
@@ -480,14 +395,14 @@ public:
       ACDfDescriptor->Name = strdup(text.c_str());
       ACDfDescriptor->Maker = "Charlie Laub, 2024";
       ACDfDescriptor->Copyright = "GPLv3";
-      ACDfDescriptor->PortCount = 9;
+      ACDfDescriptor->PortCount = ACDf_NUM_PORTS;
 
       //create storage for port_descriptors, port_range_hints, and port_names        
-      port_descriptors = (LADSPA_PortDescriptor *)calloc(9,sizeof(LADSPA_PortDescriptor));
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(ACDf_NUM_PORTS,sizeof(LADSPA_PortDescriptor));
       ACDfDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
-      port_range_hints = (LADSPA_PortRangeHint *)calloc(9,sizeof(LADSPA_PortRangeHint));
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(ACDf_NUM_PORTS,sizeof(LADSPA_PortRangeHint));
       ACDfDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
-      port_names = (char **)calloc(9, sizeof(char*));
+      port_names = (char **)calloc(ACDf_NUM_PORTS, sizeof(char*));
       ACDfDescriptor->PortNames = (const char **)port_names;
       //done creating storage. now set the descriptor, range_hints, and name for each port:
 
@@ -547,6 +462,14 @@ public:
       port_range_hints[ACDf_QZ].LowerBound = 0.01;
       port_range_hints[ACDf_QZ].UpperBound = 100;
 
+      //port = ACDf_RAMP: number of blocks over which a parameter change is crossfaded
+      port_descriptors[ACDf_RAMP] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "ramp";
+      port_names[ACDf_RAMP] = strdup(text.c_str());
+      port_range_hints[ACDf_RAMP].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_LOW;
+      port_range_hints[ACDf_RAMP].LowerBound = 0;
+      port_range_hints[ACDf_RAMP].UpperBound = 16;
+
       //port = ACDf_INPUT   
       port_descriptors[ACDf_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
       text = "Input";
@@ -569,8 +492,8 @@ public:
       ACDfDescriptor->deactivate = NULL;
       ACDfDescriptor->instantiate = instantiateACDf;
       ACDfDescriptor->run = runACDf;
-      ACDfDescriptor->run_adding = NULL;
-      ACDfDescriptor->set_run_adding_gain = NULL;
+      ACDfDescriptor->run_adding = runAddingACDf;
+      ACDfDescriptor->set_run_adding_gain = setRunAddingGainACDf;
     }
   }
   ~Initialiser() {
@@ -0,0 +1,480 @@
+/* ACDfBank LADSPA plugin, version 1.0
+   Copyright 2019-2025 Charlie Laub, GPLv3
+
+  ACDfBank is the filter bank member of the ACDf family. It has one audio input
+  and 2 to 5 audio outputs, one for each band of a loudspeaker crossover. Each
+  channel count has its own plugin label:
+    ACDfBank2, ACDfBank3, ACDfBank4, ACDfBank5
+
+  The input first passes through up to ACDfB_SHARED_SECTIONS "shared" ACDf
+  filters, e.g. an input EQ or a subsonic filter that all bands need. These are
+  calculated only once. The result is then filtered by up to ACDf_MAX_SECTIONS
+  ACDf filters for each band. The band filters are calculated side by side:
+  section n of every band is held in one vector with one lane per band, so
+  that the same operation is carried out for all bands at once, while the
+  samples are still in the cache. Bands with fewer sections are padded with
+  sections that pass the signal unchanged. The vectors use the GCC vector
+  extensions and the instruction set is chosen at run time, see cpu_dispatch.h.
+
+  The parameters of the shared sections are named stype1, spolarity1, ... sqz4
+  and those of band B are named bBtype1, bBpolarity1, ... bBqz8, e.g. b2fp1.
+  The number of sections used for each part is printed when the plugin is
+  activated.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include "ACDf_coefficients.h"
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define ACDfB_MAX_BANDS        5  //maximum number of bands (outputs)
+#define ACDfB_MAX_LANES        8  //vector lanes needed for ACDfB_MAX_BANDS bands
+#define ACDfB_SHARED_SECTIONS  4  //number of shared sections
+#define ACDfB_CHUNK           64  //number of samples processed per pass through the sections
+#define ACDfB_ALIGNMENT       64  //alignment of the filter state, in bytes
+#define ACDfB_FIRST_ID      5231  //UniqueID of the first descriptor
+
+//the parameters of the shared sections occupy the first ports. They are
+//  followed by the ACDf_SECTION_PORTS parameters of each band, the input port
+//  and then the output port of each band.
+#define ACDfB_SHARED_PORTS   (ACDfB_SHARED_SECTIONS * ACDf_PARAMS_PER_SECTION)
+#define ACDfB_FIRST_BAND     ACDfB_SHARED_PORTS
+#define ACDfB_INPUT(bands)   (ACDfB_FIRST_BAND + (bands) * ACDf_SECTION_PORTS)
+
+//one descriptor is created for each number of bands:
+#define ACDfB_NUM_DESCRIPTORS 4
+static const unsigned int ACDfB_bands[ACDfB_NUM_DESCRIPTORS] = { 2, 3, 4, 5 };
+static LADSPA_Descriptor *ACDfBankDescriptor[ACDfB_NUM_DESCRIPTORS] = { NULL, NULL, NULL, NULL };
+
+
+//vector types holding one lane per band:
+typedef double v2d __attribute__((vector_size(2 * sizeof(double))));
+typedef double v4d __attribute__((vector_size(4 * sizeof(double))));
+typedef double v8d __attribute__((vector_size(8 * sizeof(double))));
+template <unsigned int L> struct lanes;
+template <> struct lanes<2> { typedef v2d type; };
+template <> struct lanes<4> { typedef v4d type; };
+template <> struct lanes<8> { typedef v8d type; };
+
+
+typedef struct {
+  ACDf_sections shared; //coefficients of the shared sections
+  ACDf_sections band[ACDfB_MAX_BANDS]; //coefficients of the sections of each band
+  unsigned int num_lanes; //vector lanes used for the bands: 2, 4 or 8
+  unsigned int num_band_sections; //largest number of sections of any band
+  double dn;
+  //state of the shared sections:
+  double x1[ACDfB_SHARED_SECTIONS], x2[ACDfB_SHARED_SECTIONS];
+  double y1[ACDfB_SHARED_SECTIONS], y2[ACDfB_SHARED_SECTIONS];
+  //coefficients and state of the band sections, stored as one lane per band:
+  double gain[ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double b0[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double b1[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double b2[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double a1[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double a2[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double bx1[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double bx2[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double by1[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+  double by2[ACDf_MAX_SECTIONS][ACDfB_MAX_LANES] __attribute__((aligned(ACDfB_ALIGNMENT)));
+} filter_bank;
+
+
+typedef struct {
+  LADSPA_Data *shared_params[ACDfB_SHARED_PORTS];
+  LADSPA_Data *band_params[ACDfB_MAX_BANDS][ACDf_SECTION_PORTS];
+  LADSPA_Data rate;
+  unsigned int num_bands;
+  int isa; //instruction set used for the band sections, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  filter_bank * filter;
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the outputs in shared memory, see telemetry.h
+  LADSPA_Data *input;
+  LADSPA_Data *output[ACDfB_MAX_BANDS];
+} ACDfBank;
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  if (index < ACDfB_NUM_DESCRIPTORS) return ACDfBankDescriptor[index];
+  return NULL;
+}
+
+
+LADSPA_Handle instantiateACDfBank(const LADSPA_Descriptor *descriptor,
+                                  unsigned long sample_rate) {
+  ACDfBank *pluginData = (ACDfBank *)calloc(1, sizeof(ACDfBank));
+  void *memory = NULL;
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->num_bands = ACDfB_bands[descriptor->UniqueID - ACDfB_FIRST_ID];
+  pluginData->isa = select_cpu_isa(descriptor->Label);
+  pluginData->run_adding_gain = 1.0;
+  if (posix_memalign(&memory, ACDfB_ALIGNMENT, sizeof(filter_bank)) != 0) {
+    free(pluginData);
+    return NULL;
+  }
+  memset(memory, 0, sizeof(filter_bank));
+  pluginData->filter = (filter_bank *)memory;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortACDfBank(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  ACDfBank *pluginData = (ACDfBank *)instance;
+  const unsigned int N = pluginData->num_bands;
+  if (port < ACDfB_FIRST_BAND) {
+    pluginData->shared_params[port] = data;
+  } else if (port < ACDfB_INPUT(N)) {
+    port -= ACDfB_FIRST_BAND;
+    pluginData->band_params[port / ACDf_SECTION_PORTS][port % ACDf_SECTION_PORTS] = data;
+  } else if (port == ACDfB_INPUT(N)) {
+    pluginData->input = data;
+  } else if (port <= ACDfB_INPUT(N) + N) {
+    pluginData->output[port - ACDfB_INPUT(N) - 1] = data;
+  }
+}
+
+
+static void clear_filter_bank(filter_bank *f) {
+  //initializes the state of the shared sections and of the band sections
+  for (unsigned int n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    for (unsigned int lane = 0; lane < ACDfB_MAX_LANES; lane++) {
+      f->bx1[n][lane] = 0.0;
+      f->bx2[n][lane] = 0.0;
+      f->by1[n][lane] = DENORMALKILLER;
+      f->by2[n][lane] = DENORMALKILLER;
+    }
+  }
+  for (unsigned int n = 0; n < ACDfB_SHARED_SECTIONS; n++) {
+    f->x1[n] = 0.0;
+    f->x2[n] = 0.0;
+    f->y1[n] = DENORMALKILLER;
+    f->y2[n] = DENORMALKILLER;
+  }
+  f->dn = DENORMALKILLER;
+} //end clear_filter_bank
+
+
+void activateACDfBank(LADSPA_Handle instance) {
+  ACDfBank *pluginData = (ACDfBank *)instance;
+  filter_bank *f = pluginData->filter;
+  const unsigned int N = pluginData->num_bands;
+  unsigned int band, n, lane;
+  unsigned long hold;
+
+  calculate_ACDf_section_list(pluginData->shared_params, ACDfB_SHARED_SECTIONS, pluginData->rate, &f->shared);
+  f->num_band_sections = 0;
+  for (band = 0; band < N; band++) {
+    calculate_ACDf_sections(pluginData->band_params[band], pluginData->rate, &f->band[band]);
+    if (f->band[band].num_sections > f->num_band_sections) f->num_band_sections = f->band[band].num_sections;
+  }
+  f->num_lanes = (N <= 2) ? 2 : ((N <= 4) ? 4 : 8);
+
+  //arrange the band coefficients into lanes. Sections beyond the last section
+  //  of a band, and lanes that are not used by any band, pass the signal unchanged.
+  for (lane = 0; lane < ACDfB_MAX_LANES; lane++) {
+    f->gain[lane] = (lane < N) ? f->band[lane].gain : 0.0;
+    for (n = 0; n < ACDf_MAX_SECTIONS; n++) {
+      if (lane < N && n < f->band[lane].num_sections) {
+        f->b0[n][lane] = f->band[lane].b0[n];
+        f->b1[n][lane] = f->band[lane].b1[n];
+        f->b2[n][lane] = f->band[lane].b2[n];
+        f->a1[n][lane] = f->band[lane].a1[n];
+        f->a2[n][lane] = f->band[lane].a2[n];
+      } else {
+        f->b0[n][lane] = 1.0;
+        f->b1[n][lane] = f->b2[n][lane] = f->a1[n][lane] = f->a2[n][lane] = 0.0;
+      }
+    }
+  }
+  clear_filter_bank(f);
+  //the gate closes when the shared sections and the slowest band have decayed
+  hold = 0;
+  for (band = 0; band < N; band++) {
+    if (ACDf_sections_hold(&f->band[band]) > hold) hold = ACDf_sections_hold(&f->band[band]);
+  }
+  set_silence_gate(&pluginData->gate, add_silence_hold(ACDf_sections_hold(&f->shared), hold));
+
+  //report the topology
+  cout << "ACDfBank" << N << ": input -> " << f->shared.num_sections << " shared section(s) -> ";
+  for (band = 0; band < N; band++) {
+    cout << (band ? ", " : "") << "band " << band+1 << ": " << f->band[band].num_sections << " section(s)";
+  }
+  cout << ". The bands are calculated in " << f->num_lanes << " vector lanes, ";
+  cout << f->num_band_sections << " section(s) deep." << endl;
+
+  char label[TELEMETRY_LABEL_SIZE], info[TELEMETRY_INFO_SIZE];
+  int length = snprintf(info, sizeof(info), "sections %u shared", f->shared.num_sections);
+  for (band = 0; band < N && length < (int)sizeof(info); band++) {
+    length += snprintf(info + length, sizeof(info) - length, ", %u", f->band[band].num_sections);
+  }
+  snprintf(label, sizeof(label), "ACDfBank%u", N);
+  telemetry_open(&pluginData->meter, label, info, N, pluginData->rate);
+}
+
+
+static void run_shared_sections(filter_bank *f, double *work, const unsigned long n) {
+  //calculates the shared sections, one sample at a time, exactly as in ACDf.
+  //  This does not benefit from vector instructions and is not dispatched.
+  const ACDf_sections *c = &f->shared;
+  double b0, b1, b2, a1, a2, x1, x2, y1, y2, x, y, dn;
+  for (unsigned int section = 0; section < c->num_sections; section++) {
+    b0 = c->b0[section]; b1 = c->b1[section]; b2 = c->b2[section];
+    a1 = c->a1[section]; a2 = c->a2[section];
+    x1 = f->x1[section]; x2 = f->x2[section];
+    y1 = f->y1[section]; y2 = f->y2[section];
+    dn = f->dn;
+    for (unsigned long i = 0; i < n; i++) {
+      x = work[i];
+      y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + dn;
+      dn = -dn;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      work[i] = y;
+    }
+    f->x1[section] = x1; f->x2[section] = x2;
+    f->y1[section] = y1; f->y2[section] = y2;
+  }
+} //end run_shared_sections
+
+
+template <unsigned int L>
+CPU_KERNEL_INLINE void run_band_lanes(ACDfBank *pluginData, const double *work, const unsigned long pos,
+                                      const unsigned long n, const bool adding) {
+  //calculates the band sections for n samples of the shared section output in
+  //  work. The output of the shared sections is copied into every lane, then
+  //  section k of all bands is calculated with a single set of vector operations.
+  //  When adding is true the result, multiplied by the run_adding gain, is
+  //  added to the output buffers.
+  typedef typename lanes<L>::type vec;
+  filter_bank *f = pluginData->filter;
+  LADSPA_Data * const *output = pluginData->output;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  vec band_work[ACDfB_CHUNK];
+  vec x, y, x1, x2, y1, y2, b0, b1, b2, a1, a2, band_gain;
+  double dn;
+  unsigned long i;
+
+  memcpy(&band_gain, f->gain, sizeof(vec));
+  for (i = 0; i < n; i++) band_work[i] = work[i] * band_gain;
+
+  for (unsigned int section = 0; section < f->num_band_sections; section++) {
+    memcpy(&b0, f->b0[section], sizeof(vec)); memcpy(&b1, f->b1[section], sizeof(vec));
+    memcpy(&b2, f->b2[section], sizeof(vec)); memcpy(&a1, f->a1[section], sizeof(vec));
+    memcpy(&a2, f->a2[section], sizeof(vec));
+    memcpy(&x1, f->bx1[section], sizeof(vec)); memcpy(&x2, f->bx2[section], sizeof(vec));
+    memcpy(&y1, f->by1[section], sizeof(vec)); memcpy(&y2, f->by2[section], sizeof(vec));
+    dn = f->dn;
+    for (i = 0; i < n; i++) {
+      x = band_work[i];
+      y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + dn;
+      dn = -dn;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      band_work[i] = y;
+    }
+    memcpy(f->bx1[section], &x1, sizeof(vec)); memcpy(f->bx2[section], &x2, sizeof(vec));
+    memcpy(f->by1[section], &y1, sizeof(vec)); memcpy(f->by2[section], &y2, sizeof(vec));
+  }
+
+  //scatter the lanes to the band outputs
+  for (unsigned int band = 0; band < pluginData->num_bands; band++) {
+    if (adding) {
+      for (i = 0; i < n; i++) output[band][pos+i] += gain * (LADSPA_Data)band_work[i][band];
+    } else {
+      for (i = 0; i < n; i++) output[band][pos+i] = (LADSPA_Data)band_work[i][band];
+    }
+  }
+} //end run_band_lanes
+
+
+CPU_KERNEL_INLINE void run_bands(ACDfBank *pluginData, const double *work, const unsigned long pos,
+                                 const unsigned long n, const bool adding) {
+  switch (pluginData->filter->num_lanes) {
+  case 2:
+    run_band_lanes<2>(pluginData, work, pos, n, adding);
+    break;
+  case 4:
+    run_band_lanes<4>(pluginData, work, pos, n, adding);
+    break;
+  case 8:
+    run_band_lanes<8>(pluginData, work, pos, n, adding);
+    break;
+  }
+} //end run_bands
+//compile run_bands for each instruction set. See cpu_dispatch.h
+CPU_DISPATCH_KERNELS(run_bands, (ACDfBank *pluginData, const double *work, const unsigned long pos,
+                                 const unsigned long n, const bool adding),
+                     (pluginData, work, pos, n, adding))
+
+
+static inline void processACDfBank(ACDfBank *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffers
+  //  (run) or is multiplied by the run_adding gain and added to them (run_adding).
+  filter_bank *f = pluginData->filter;
+  const LADSPA_Data *input = pluginData->input;
+  double work[ACDfB_CHUNK];
+  unsigned long pos, chunk, i;
+  void (*kernel)(ACDfBank *, const double *, const unsigned long, const unsigned long, const bool)
+    = CPU_DISPATCH_SELECT(run_bands, pluginData->isa);
+
+  if (silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count)) {
+    for (unsigned int band = 0; band < pluginData->num_bands; band++) {
+      write_silence(pluginData->output[band], sample_count, adding);
+    }
+    return;
+  }
+
+  //the buffer is processed in chunks that are small enough to stay in the L1 cache.
+  //  The input is read before any output is written, so the host may use the
+  //  same buffer for the input and an output.
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > ACDfB_CHUNK) chunk = ACDfB_CHUNK;
+    for (i = 0; i < chunk; i++) work[i] = f->shared.gain * (double)input[pos+i];
+    run_shared_sections(f, work, chunk);
+    kernel(pluginData, work, pos, chunk, adding);
+    //the sign of dn only changes when the chunk length is odd
+    if (chunk & 1) f->dn = -f->dn;
+  }
+  if (silence_gate_closing(&pluginData->gate)) clear_filter_bank(f);
+} //end processACDfBank
+
+
+static inline void meterACDfBank(ACDfBank *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, pluginData->output, sample_count, state, start);
+}
+
+
+void runACDfBank(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfBank *)instance)->meter);
+  processACDfBank((ACDfBank *)instance, sample_count, false);
+  meterACDfBank((ACDfBank *)instance, sample_count, start);
+} //end runACDfBank.
+
+
+void runAddingACDfBank(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfBank *)instance)->meter);
+  processACDfBank((ACDfBank *)instance, sample_count, true);
+  meterACDfBank((ACDfBank *)instance, sample_count, start);
+} //end runAddingACDfBank
+
+
+void setRunAddingGainACDfBank(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((ACDfBank *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupACDfBank(LADSPA_Handle instance) {
+  ACDfBank *pluginData = (ACDfBank *)instance;
+  telemetry_close(&pluginData->meter);
+  free(pluginData->filter);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    LADSPA_Descriptor *descriptor;
+    unsigned int N;
+    unsigned long num_ports, port;
+
+    for (unsigned int index = 0; index < ACDfB_NUM_DESCRIPTORS; index++) {
+      ACDfBankDescriptor[index] = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+      descriptor = ACDfBankDescriptor[index];
+      if (!descriptor) continue;
+      std::string text;
+      N = ACDfB_bands[index];
+      num_ports = ACDfB_INPUT(N) + 1 + N;
+      //plugin descriptor info
+      descriptor->UniqueID = ACDfB_FIRST_ID + index;
+      text = "ACDfBank" + to_string(N);
+      descriptor->Label = strdup(text.c_str());
+      descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "ACDfBank v1.0: " + to_string(N) + " band filter bank of Active Crossover Designer LADSPA filters";
+      descriptor->Name = strdup(text.c_str());
+      descriptor->Maker = "Charlie Laub, 2025";
+      descriptor->Copyright = "GPLv3";
+      descriptor->PortCount = num_ports;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
+      descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
+      descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(num_ports, sizeof(char*));
+      descriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the shared section parameters, named stype1, sfp1, ... sqz4
+      describe_ACDf_section_list(port_descriptors, port_names, port_range_hints, 0, ACDfB_SHARED_SECTIONS, "s");
+      //ports for the section parameters of each band, named e.g. b1type1, b2fp1, ... b5qz8
+      for (unsigned int band = 0; band < N; band++) {
+        text = "b" + to_string(band+1);
+        describe_ACDf_section_list(port_descriptors, port_names, port_range_hints,
+                                   ACDfB_FIRST_BAND + band * ACDf_SECTION_PORTS, ACDf_MAX_SECTIONS, text.c_str());
+      }
+
+      //audio ports, named Input and Output1 ... OutputN
+      port = ACDfB_INPUT(N);
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+      port_names[port] = strdup("Input");
+      for (unsigned int band = 0; band < N; band++) {
+        port = ACDfB_INPUT(N) + 1 + band;
+        port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+        text = "Output" + to_string(band+1);
+        port_names[port] = strdup(text.c_str());
+      }
+
+      descriptor->activate = activateACDfBank;
+      descriptor->cleanup = cleanupACDfBank;
+      descriptor->connect_port = connectPortACDfBank;
+      descriptor->deactivate = NULL;
+      descriptor->instantiate = instantiateACDfBank;
+      descriptor->run = runACDfBank;
+      descriptor->run_adding = runAddingACDfBank;
+      descriptor->set_run_adding_gain = setRunAddingGainACDfBank;
+    }
+  }
+  ~Initialiser() {
+    for (unsigned int index = 0; index < ACDfB_NUM_DESCRIPTORS; index++) {
+      if (ACDfBankDescriptor[index]) {
+        free((LADSPA_PortDescriptor *)ACDfBankDescriptor[index]->PortDescriptors);
+        free((char **)ACDfBankDescriptor[index]->PortNames);
+        free((LADSPA_PortRangeHint *)ACDfBankDescriptor[index]->PortRangeHints);
+        free(ACDfBankDescriptor[index]);
+      }
+    }
+  }
+} g_theInitialiser;
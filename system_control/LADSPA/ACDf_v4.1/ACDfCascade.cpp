@@ -0,0 +1,863 @@
+/* ACDfCascade LADSPA plugin, version 1.0
+   Copyright 2019-2025 Charlie Laub, GPLv3
+
+  ACDfCascade is the multi-section sibling of the ACDf plugin. A single
+  instance holds up to ACDf_MAX_SECTIONS ACDf filters that are applied to the
+  signal in series, e.g. all of the sections of an LR8 or 7DFE crossover
+  filter. Each section is described by the same seven parameters that are used
+  by ACDf, with the section number appended to the parameter name (type1, fp1,
+  qp1, ... type2, fp2, ...). Sections that are not used keep their default
+  values (type 0, 0 dB) and are skipped entirely. See the ACDf usage notes
+  for information on the filter types and parameters.
+
+  Compared to a chain of ACDf instances the cascade avoids a separate host
+  element, buffer handoff and allocation per section. The coefficients and the
+  filter state of all sections are stored in contiguous arrays and the whole
+  cascade is calculated in one pass over the buffer.
+
+  Optionally the cascade can be calculated in parallel form: the transfer 
+  function of the sections is expanded into partial fractions when the plugin
+  is activated, i.e. into a sum of first and second order terms plus a short
+  direct (FIR) term. The terms are independent of each other, so they are 
+  calculated side by side in the lanes of the vector unit instead of one after 
+  the other.
+
+  The cascade can also be calculated as a wavefront: each section is given its
+  own vector lane and works on the sample that the section before it finished
+  in the previous step, so all sections advance at the same time. This delays 
+  the output by one sample per lane, which is reported by the latency port.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include <complex>
+#include "ACDf_coefficients.h"
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define ACDfC_CHUNK        64  //number of samples processed per pass through the sections
+#define ACDfC_BLOCK         4  //number of output samples calculated per step by the block kernel
+
+//the calculation mode is selected with the mode port at activation:
+#define ACDfC_MODE_DIRECT   0  //direct form, one sample at a time (the same as ACDf)
+#define ACDfC_MODE_BLOCK    1  //block kernel, ACDfC_BLOCK samples at a time
+#define ACDfC_MODE_PARALLEL 2  //parallel form, sum of first and second order terms
+#define ACDfC_MODE_WAVEFRONT 3 //one section per vector lane, adds latency
+//the block kernel is only used when its output is within ACDfC_BLOCK_ERROR_BOUND
+//  of the direct form, relative to the peak output, for a noise probe of 
+//  ACDfC_PROBE_LENGTH samples. The bound, 2^-26 or about -156dB, is well below
+//  the resolution of the 32 bit float output.
+#define ACDfC_BLOCK_ERROR_BOUND  1.4901161193847656e-08
+#define ACDfC_PROBE_LENGTH       4096
+//the parallel form is checked against the direct form with the same probe. The
+//  bound is 2^-24 or about -144dB, the resolution of the 32 bit float output.
+//  Sections whose poles lie within ACDfC_POLE_DISTANCE of a pole of another 
+//  section (e.g. the two identical Butterworth halves of a Linkwitz-Riley 
+//  filter) have no partial fraction expansion of this form and are calculated
+//  in series before the parallel terms.
+#define ACDfC_PARALLEL_ERROR_BOUND  5.9604644775390625e-08
+#define ACDfC_POLE_DISTANCE         1.e-6
+#define ACDfC_MAX_LANES             8  //vector lanes for the parallel terms
+#define ACDfC_MAX_FIR  (2 * ACDf_MAX_SECTIONS + 1)  //longest possible direct term
+
+//the section parameters occupy the first ACDf_SECTION_PORTS ports (see
+//  ACDf_coefficients.h). The mode and audio ports follow the section parameters:
+#define ACDfC_MODE         ACDf_SECTION_PORTS
+#define ACDfC_INPUT        (ACDfC_MODE + 1)
+#define ACDfC_OUTPUT       (ACDfC_INPUT + 1)
+#define ACDfC_LATENCY      (ACDfC_OUTPUT + 1)  //output: delay added by the mode, in samples
+#define ACDfC_NUM_PORTS    (ACDfC_LATENCY + 1)
+
+
+static LADSPA_Descriptor *ACDfCascadeDescriptor = NULL;
+
+typedef double block_vector __attribute__((vector_size(ACDfC_BLOCK * sizeof(double))));
+
+//The block kernel calculates ACDfC_BLOCK samples of a section in one step.
+//  Each output sample of the block is a fixed linear combination of the section 
+//  state before the block and of the input samples within the block:
+//    y[k] = cx1[k]*x1 + cx2[k]*x2 + cy1[k]*y1 + cy2[k]*y2 + sum over m of d[m][k]*x[m] + dn*e[k]
+//  where x1, x2, y1, y2 is the state before the block. The vectors are found by 
+//  running the difference equation on unit states and unit impulses. Only the
+//  state at the block boundary depends on the previous block, so the ACDfC_BLOCK
+//  output samples are calculated in parallel.
+typedef struct {
+  double cx1[ACDfC_BLOCK], cx2[ACDfC_BLOCK], cy1[ACDfC_BLOCK], cy2[ACDfC_BLOCK];
+  double d[ACDfC_BLOCK][ACDfC_BLOCK]; //d[m] is the response to input sample m of the block
+  double e[ACDfC_BLOCK]; //response to the denormal killer, per unit of dn
+} block_coefficients;
+
+//vector type holding two parallel terms or wavefront sections, one per lane,
+//  and the lane selector used to move samples between lanes:
+typedef double pair_vector __attribute__((vector_size(2 * sizeof(double))));
+typedef long long pair_mask __attribute__((vector_size(2 * sizeof(long long))));
+
+//The parallel form of the cascade. Each term is the partial fraction of one
+//  section's poles and has the same denominator as that section:
+//    y = c0*x + c1*x1 - a1*y1 - a2*y2
+//  Its output is added to that of the direct term, an FIR filter with fir_length
+//  taps. Sections with repeated poles are calculated in series before the terms.
+typedef struct {
+  unsigned int num_serial; //number of sections calculated in series
+  unsigned int serial[ACDf_MAX_SECTIONS]; //index of each of those sections
+  unsigned int num_terms; //number of parallel terms
+  unsigned int num_lanes; //vector lanes used for the terms: 2, 4, 6 or 8
+  unsigned int fir_length; //number of taps of the direct term
+  double fir[ACDfC_MAX_FIR];
+  double c0[ACDfC_MAX_LANES], c1[ACDfC_MAX_LANES], a1[ACDfC_MAX_LANES], a2[ACDfC_MAX_LANES];
+  //state: the previous inputs and the previous outputs of each term
+  double history[ACDfC_MAX_FIR - 1];
+  double y1[ACDfC_MAX_LANES], y2[ACDfC_MAX_LANES];
+} parallel_form;
+
+//The wavefront form of the cascade. Section k is calculated in lane k and its
+//  input is the output of lane k-1 from the previous step, so the output of the
+//  last lane is delayed by num_lanes - 1 samples. Unused lanes pass their input
+//  through unchanged.
+typedef struct {
+  unsigned int num_lanes; //one lane per section, rounded up to an even number
+  double b0[ACDf_MAX_SECTIONS], b1[ACDf_MAX_SECTIONS], b2[ACDf_MAX_SECTIONS];
+  double a1[ACDf_MAX_SECTIONS], a2[ACDf_MAX_SECTIONS];
+  double x1[ACDf_MAX_SECTIONS], x2[ACDf_MAX_SECTIONS];
+  double y1[ACDf_MAX_SECTIONS], y2[ACDf_MAX_SECTIONS];
+} wavefront_form;
+
+typedef struct {
+  ACDf_sections coef; //coefficients of each section, stored contiguously
+  int mode;
+  unsigned int latency; //delay added by the mode, in samples
+  int isa; //instruction set used by run, see cpu_dispatch.h
+  double dn;
+  //state of each section, stored contiguously:
+  double x1[ACDf_MAX_SECTIONS], x2[ACDf_MAX_SECTIONS];
+  double y1[ACDf_MAX_SECTIONS], y2[ACDf_MAX_SECTIONS];
+  block_coefficients block[ACDf_MAX_SECTIONS];
+  parallel_form parallel;
+  wavefront_form wavefront;
+} cascade;
+
+
+typedef struct {
+  LADSPA_Data *params[ACDf_SECTION_PORTS];
+  LADSPA_Data *mode;
+  LADSPA_Data rate;
+  int isa; //best instruction set for the block kernel, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  cascade * filter;
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
+  LADSPA_Data *input;
+  LADSPA_Data *output;
+  LADSPA_Data *latency;
+} ACDfCascade;
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  switch (index) {
+  case 0:
+    return ACDfCascadeDescriptor;
+  default:
+    return NULL;
+  }
+}
+
+
+LADSPA_Handle instantiateACDfCascade(const LADSPA_Descriptor *descriptor,
+                                     unsigned long sample_rate) {
+  ACDfCascade *pluginData = (ACDfCascade *)calloc(1, sizeof(ACDfCascade));
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->filter = (cascade *)calloc(1, sizeof(cascade));
+  pluginData->isa = select_cpu_isa("ACDfCascade");
+  pluginData->run_adding_gain = 1.0;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortACDfCascade(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  ACDfCascade *pluginData = (ACDfCascade *)instance;
+  if (port < ACDfC_MODE) {
+    pluginData->params[port] = data;
+    return;
+  }
+  switch (port) {
+  case ACDfC_MODE:
+    pluginData->mode = data;
+    break;
+  case ACDfC_INPUT:
+    pluginData->input = data;
+    break;
+  case ACDfC_OUTPUT:
+    pluginData->output = data;
+    break;
+  case ACDfC_LATENCY:
+    pluginData->latency = data;
+    break;
+  }
+}
+
+
+static void simulate_section(const ACDf_sections *c, const unsigned int section, double x1, double x2,
+                             double y1, double y2, const double *input, const double *added, double *output) {
+  //runs the difference equation of a section for one block, starting from the
+  //  given state. Used to find the block kernel coefficients.
+  double x, y;
+  for (unsigned int k = 0; k < ACDfC_BLOCK; k++) {
+    x = input[k];
+    y = c->b0[section] * x + c->b1[section] * x1 + c->b2[section] * x2 
+      - c->a1[section] * y1 - c->a2[section] * y2 + added[k];
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    output[k] = y;
+  }
+}
+
+
+static void calculate_block_coefficients(const ACDf_sections *c, const unsigned int section,
+                                         block_coefficients *b) {
+  double zero[ACDfC_BLOCK], unit[ACDfC_BLOCK], alternating[ACDfC_BLOCK];
+  unsigned int m;
+  for (m = 0; m < ACDfC_BLOCK; m++) {
+    zero[m] = 0.0;
+    alternating[m] = (m & 1) ? -1.0 : 1.0;
+  }
+  simulate_section(c, section, 1.0, 0.0, 0.0, 0.0, zero, zero, b->cx1);
+  simulate_section(c, section, 0.0, 1.0, 0.0, 0.0, zero, zero, b->cx2);
+  simulate_section(c, section, 0.0, 0.0, 1.0, 0.0, zero, zero, b->cy1);
+  simulate_section(c, section, 0.0, 0.0, 0.0, 1.0, zero, zero, b->cy2);
+  for (m = 0; m < ACDfC_BLOCK; m++) {
+    for (unsigned int k = 0; k < ACDfC_BLOCK; k++) unit[k] = (k == m) ? 1.0 : 0.0;
+    simulate_section(c, section, 0.0, 0.0, 0.0, 0.0, unit, zero, b->d[m]);
+  }
+  simulate_section(c, section, 0.0, 0.0, 0.0, 0.0, zero, alternating, b->e);
+}
+
+
+CPU_KERNEL_INLINE void calculate_section(cascade *f, const unsigned int section, double *work,
+                                       const unsigned long count) {
+  //runs one section over the work buffer. In block mode all complete blocks are
+  //  calculated by the block kernel and any remaining samples by the direct form.
+  const ACDf_sections *c = &f->coef;
+  double x, y, x1, x2, y1, y2, b0, b1, b2, a1, a2, dn;
+  unsigned long i = 0;
+
+  x1 = f->x1[section]; x2 = f->x2[section];
+  y1 = f->y1[section]; y2 = f->y2[section];
+  dn = f->dn;
+  if (f->mode == ACDfC_MODE_BLOCK) {
+    const block_coefficients *b = &f->block[section];
+    block_vector cx1, cx2, cy1, cy2, d0, d1, d2, d3, e, yb;
+    memcpy(&cx1, b->cx1, sizeof(block_vector)); memcpy(&cx2, b->cx2, sizeof(block_vector));
+    memcpy(&cy1, b->cy1, sizeof(block_vector)); memcpy(&cy2, b->cy2, sizeof(block_vector));
+    memcpy(&d0, b->d[0], sizeof(block_vector)); memcpy(&d1, b->d[1], sizeof(block_vector));
+    memcpy(&d2, b->d[2], sizeof(block_vector)); memcpy(&d3, b->d[3], sizeof(block_vector));
+    memcpy(&e, b->e, sizeof(block_vector));
+    e = dn * e; //the block length is even, so dn has the same sign at the start of each block
+    for (; i + ACDfC_BLOCK <= count; i += ACDfC_BLOCK) {
+      yb = cx1 * x1 + cx2 * x2 + cy1 * y1 + cy2 * y2
+         + d0 * work[i] + d1 * work[i+1] + d2 * work[i+2] + d3 * work[i+3] + e;
+      x2 = work[i+2];
+      x1 = work[i+3];
+      y2 = yb[2];
+      y1 = yb[3];
+      memcpy(&work[i], &yb, sizeof(block_vector));
+    }
+  }
+  b0 = c->b0[section]; b1 = c->b1[section]; b2 = c->b2[section];
+  a1 = c->a1[section]; a2 = c->a2[section];
+  for (; i < count; i++) {
+    x = work[i];
+    y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + dn;
+    dn = -dn;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    work[i] = y;
+  }
+  f->x1[section] = x1; f->x2[section] = x2;
+  f->y1[section] = y1; f->y2[section] = y2;
+}
+
+
+template <unsigned int L>
+CPU_KERNEL_INLINE void calculate_parallel_terms(cascade *f, double *work, const unsigned long count) {
+  //calculates the parallel form over the work buffer. The L terms are held in 
+  //  pairs, one term per vector lane, and the recursions of all pairs are 
+  //  independent, so they advance side by side instead of one after the other.
+  //  The lanes are then summed and added to the direct term. Vectors of two 
+  //  lanes are used with every instruction set: wider vectors do not shorten
+  //  the recursion and are not held in registers efficiently by the compiler.
+  const unsigned int V = L / 2; //number of vectors
+  parallel_form *p = &f->parallel;
+  const unsigned int taps = p->fir_length;
+  //the previous inputs followed by the work buffer:
+  double in[ACDfC_MAX_FIR - 1 + ACDfC_CHUNK];
+  const double *x;
+  pair_vector c0[V], c1[V], a1[V], a2[V], y1[V], y2[V], y, total;
+  const pair_vector zero = { 0.0, 0.0 };
+  double sum, dn;
+  unsigned long i;
+  unsigned int k, v;
+
+  memcpy(c0, p->c0, sizeof(c0)); memcpy(c1, p->c1, sizeof(c1));
+  memcpy(a1, p->a1, sizeof(a1)); memcpy(a2, p->a2, sizeof(a2));
+  memcpy(y1, p->y1, sizeof(y1)); memcpy(y2, p->y2, sizeof(y2));
+  dn = f->dn;
+  memcpy(in, p->history, sizeof(p->history));
+  memcpy(&in[ACDfC_MAX_FIR - 1], work, count * sizeof(double));
+  for (i = 0; i < count; i++) {
+    x = &in[ACDfC_MAX_FIR - 1 + i]; //x[0] is the current input, x[-1] the previous one, etc.
+    total = zero;
+    for (v = 0; v < V; v++) {
+      y = c0[v] * x[0] + c1[v] * x[-1] - a1[v] * y1[v] - a2[v] * y2[v] + dn;
+      y2[v] = y1[v];
+      y1[v] = y;
+      total += y;
+    }
+    dn = -dn;
+    sum = total[0] + total[1];
+    for (k = 0; k < taps; k++) sum += p->fir[k] * x[-(long)k];
+    work[i] = sum;
+  }
+  memcpy(p->history, &in[count], sizeof(p->history));
+  memcpy(p->y1, y1, sizeof(y1)); memcpy(p->y2, y2, sizeof(y2));
+}
+
+
+template <unsigned int L>
+CPU_KERNEL_INLINE void calculate_wavefront(cascade *f, double *work, const unsigned long count) {
+  //calculates the wavefront form over the work buffer. In every step the input 
+  //  of each lane is the previous output of the lane before it, and lane 0 takes
+  //  the next input sample. All lanes then advance one sample with one set of 
+  //  vector operations, and the output of the last lane is the output of the 
+  //  cascade. The lanes are held in pairs, as for the parallel form.
+  const unsigned int V = L / 2; //number of vectors
+  wavefront_form *w = &f->wavefront;
+  pair_vector b0[V], b1[V], b2[V], a1[V], a2[V], x[V], x1[V], x2[V], y1[V], y2[V], y;
+  double dn;
+  unsigned long i;
+  unsigned int v;
+
+  memcpy(b0, w->b0, sizeof(b0)); memcpy(b1, w->b1, sizeof(b1)); memcpy(b2, w->b2, sizeof(b2));
+  memcpy(a1, w->a1, sizeof(a1)); memcpy(a2, w->a2, sizeof(a2));
+  memcpy(x1, w->x1, sizeof(x1)); memcpy(x2, w->x2, sizeof(x2));
+  memcpy(y1, w->y1, sizeof(y1)); memcpy(y2, w->y2, sizeof(y2));
+  dn = f->dn;
+  for (i = 0; i < count; i++) {
+    //shift the previous outputs up by one lane. The shuffles keep the samples
+    //  in registers while moving them from lane to lane.
+    x[0] = __builtin_shuffle(y1[0], (pair_vector){ work[i], work[i] }, (pair_mask){ 2, 0 });
+    for (v = 1; v < V; v++) x[v] = __builtin_shuffle(y1[v-1], y1[v], (pair_mask){ 1, 2 });
+    for (v = 0; v < V; v++) {
+      y = b0[v] * x[v] + b1[v] * x1[v] + b2[v] * x2[v] - a1[v] * y1[v] - a2[v] * y2[v] + dn;
+      x2[v] = x1[v];
+      x1[v] = x[v];
+      y2[v] = y1[v];
+      y1[v] = y;
+    }
+    dn = -dn;
+    work[i] = y1[V-1][1];
+  }
+  memcpy(w->x1, x1, sizeof(x1)); memcpy(w->x2, x2, sizeof(x2));
+  memcpy(w->y1, y1, sizeof(y1)); memcpy(w->y2, y2, sizeof(y2));
+}
+
+
+CPU_KERNEL_INLINE void calculate_chunk(cascade *f, double *work, const unsigned long chunk) {
+  //applies the gain and all sections to one chunk of at most ACDfC_CHUNK samples.
+  //  Each section runs over the whole chunk with its coefficients and state held
+  //  in registers before the chunk is passed to the next section.
+  const ACDf_sections *c = &f->coef;
+  const parallel_form *p = &f->parallel;
+  unsigned long i;
+  double dn;
+
+  for (i = 0; i < chunk; i++) work[i] *= c->gain;
+  if (f->mode == ACDfC_MODE_PARALLEL) {
+    for (unsigned int n = 0; n < p->num_serial; n++) {
+      calculate_section(f, p->serial[n], work, chunk);
+    }
+    switch (p->num_lanes) {
+    case 2:
+      calculate_parallel_terms<2>(f, work, chunk);
+      break;
+    case 4:
+      calculate_parallel_terms<4>(f, work, chunk);
+      break;
+    case 6:
+      calculate_parallel_terms<6>(f, work, chunk);
+      break;
+    default:
+      calculate_parallel_terms<8>(f, work, chunk);
+    }
+  } else if (f->mode == ACDfC_MODE_WAVEFRONT) {
+    switch (f->wavefront.num_lanes) {
+    case 2:
+      calculate_wavefront<2>(f, work, chunk);
+      break;
+    case 4:
+      calculate_wavefront<4>(f, work, chunk);
+      break;
+    case 6:
+      calculate_wavefront<6>(f, work, chunk);
+      break;
+    default:
+      calculate_wavefront<8>(f, work, chunk);
+    }
+  } else {
+    for (unsigned int section = 0; section < c->num_sections; section++) {
+      calculate_section(f, section, work, chunk);
+    }
+  }
+  if (c->num_sections == 0) {
+    //gain stage only. Add the denormal killer as ACDf would.
+    dn = f->dn;
+    for (i = 0; i < chunk; i++) {
+      work[i] += dn;
+      dn = -dn;
+    }
+  }
+  //every section and term flips the sign of dn once per sample, so its sign
+  //  only changes when the chunk length is odd
+  if (chunk & 1) f->dn = -f->dn;
+}
+//compile calculate_chunk for each instruction set. See cpu_dispatch.h
+CPU_DISPATCH_KERNELS(calculate_chunk, (cascade *f, double *work, const unsigned long chunk), (f, work, chunk))
+
+
+static void reset_cascade(cascade *f) {
+  f->dn = DENORMALKILLER;
+  for (unsigned int n = 0; n < f->coef.num_sections; n++) {
+    f->x1[n] = 0.0;
+    f->x2[n] = 0.0;
+    f->y1[n] = DENORMALKILLER;
+    f->y2[n] = DENORMALKILLER;
+  }
+  for (unsigned int n = 0; n < ACDfC_MAX_FIR - 1; n++) f->parallel.history[n] = 0.0;
+  for (unsigned int n = 0; n < ACDfC_MAX_LANES; n++) {
+    f->parallel.y1[n] = DENORMALKILLER;
+    f->parallel.y2[n] = DENORMALKILLER;
+  }
+  for (unsigned int n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    f->wavefront.x1[n] = 0.0;
+    f->wavefront.x2[n] = 0.0;
+    f->wavefront.y1[n] = DENORMALKILLER;
+    f->wavefront.y2[n] = DENORMALKILLER;
+  }
+}
+
+
+static void calculate_wavefront_form(cascade *f) {
+  //places each section in its own lane. The remaining lanes pass the signal through.
+  const ACDf_sections *c = &f->coef;
+  wavefront_form *w = &f->wavefront;
+  w->num_lanes = (c->num_sections + 1) & ~1u; //an even number of lanes
+  for (unsigned int n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    if (n < c->num_sections) {
+      w->b0[n] = c->b0[n];
+      w->b1[n] = c->b1[n];
+      w->b2[n] = c->b2[n];
+      w->a1[n] = c->a1[n];
+      w->a2[n] = c->a2[n];
+    } else {
+      w->b0[n] = 1.0;
+      w->b1[n] = w->b2[n] = w->a1[n] = w->a2[n] = 0.0;
+    }
+  }
+}
+
+
+static unsigned int section_poles(const ACDf_sections *c, const unsigned int n, complex<double> *poles) {
+  //finds the poles of section n, the roots of z^2 + a1*z + a2, and returns their number
+  const double a1 = c->a1[n], a2 = c->a2[n];
+  double d, q;
+  if (a2 != 0.0) {
+    d = a1 * a1 - 4.0 * a2;
+    if (d < 0.0) {
+      poles[0] = complex<double>(-0.5 * a1, 0.5 * sqrt(-d));
+      poles[1] = conj(poles[0]);
+    } else {
+      //two real poles, calculated without cancellation
+      q = -0.5 * (a1 + copysign(sqrt(d), a1));
+      poles[0] = q;
+      poles[1] = a2 / q;
+    }
+    return 2;
+  }
+  if (a1 != 0.0) {
+    poles[0] = -a1;
+    return 1;
+  }
+  return 0;
+}
+
+
+static void calculate_parallel_form(cascade *f) {
+  //expands the transfer function of the sections into partial fractions:
+  //  H(w) = FIR(w) + sum over sections of (c0 + c1*w)/(1 + a1*w + a2*w^2), w = 1/z
+  //  The residue of each pole p is found from the factored form of H, as the 
+  //  value of (1 - p*w)*H(w) at w = 1/p, and the residues of the two poles of 
+  //  a section are combined into one real term. The direct term covers the
+  //  first samples of the impulse response that the terms do not.
+  const ACDf_sections *c = &f->coef;
+  parallel_form *p = &f->parallel;
+  complex<double> poles[ACDf_MAX_SECTIONS][2], r[2], w, num, den;
+  unsigned int num_poles[ACDf_MAX_SECTIONS];
+  bool in_parallel[ACDf_MAX_SECTIONS];
+  unsigned int n, m, j, k, t, order_b = 0, order_a = 0;
+  double x, y, x1, x2, y1, y2;
+
+  //sections with a double pole, or with a pole close to a pole of an earlier
+  //  parallel section, are calculated in series
+  p->num_serial = 0;
+  for (n = 0; n < c->num_sections; n++) {
+    num_poles[n] = section_poles(c, n, poles[n]);
+    in_parallel[n] = !(num_poles[n] == 2 && abs(poles[n][0] - poles[n][1]) < ACDfC_POLE_DISTANCE);
+    for (m = 0; m < n; m++) {
+      if (!in_parallel[m]) continue;
+      for (j = 0; j < num_poles[n]; j++) {
+        for (k = 0; k < num_poles[m]; k++) {
+          if (abs(poles[n][j] - poles[m][k]) < ACDfC_POLE_DISTANCE) in_parallel[n] = false;
+        }
+      }
+    }
+    if (!in_parallel[n]) {
+      p->serial[p->num_serial++] = n;
+      continue;
+    }
+    order_b += (c->b2[n] != 0.0) ? 2 : ((c->b1[n] != 0.0) ? 1 : 0);
+    order_a += num_poles[n];
+  }
+
+  //one term for each parallel section that has poles
+  p->num_terms = 0;
+  for (n = 0; n < c->num_sections; n++) {
+    if (!in_parallel[n] || num_poles[n] == 0) continue;
+    for (j = 0; j < num_poles[n]; j++) {
+      w = 1.0 / poles[n][j];
+      num = 1.0;
+      den = 1.0;
+      for (m = 0; m < c->num_sections; m++) {
+        if (!in_parallel[m]) continue;
+        num *= c->b0[m] + w * (c->b1[m] + w * c->b2[m]);
+        for (k = 0; k < num_poles[m]; k++) {
+          if (m != n || k != j) den *= 1.0 - poles[m][k] * w;
+        }
+      }
+      r[j] = num / den;
+    }
+    t = p->num_terms++;
+    p->a1[t] = c->a1[n];
+    p->a2[t] = c->a2[n];
+    if (num_poles[n] == 2) {
+      p->c0[t] = real(r[0] + r[1]);
+      p->c1[t] = -real(r[0] * poles[n][1] + r[1] * poles[n][0]);
+    } else {
+      p->c0[t] = real(r[0]);
+      p->c1[t] = 0.0;
+    }
+  }
+  p->num_lanes = (p->num_terms + 1) & ~1u; //an even number of lanes
+  for (t = p->num_terms; t < ACDfC_MAX_LANES; t++) {
+    p->c0[t] = p->c1[t] = p->a1[t] = p->a2[t] = 0.0;
+  }
+
+  //the direct term is the impulse response of the parallel sections minus
+  //  that of the terms. It is only needed when the numerator order is not 
+  //  lower than the denominator order.
+  p->fir_length = (order_b >= order_a) ? order_b - order_a + 1 : 0;
+  for (k = 0; k < p->fir_length; k++) p->fir[k] = (k == 0) ? 1.0 : 0.0;
+  for (n = 0; n < c->num_sections; n++) {
+    if (!in_parallel[n]) continue;
+    x1 = x2 = y1 = y2 = 0.0;
+    for (k = 0; k < p->fir_length; k++) {
+      x = p->fir[k];
+      y = c->b0[n] * x + c->b1[n] * x1 + c->b2[n] * x2 - c->a1[n] * y1 - c->a2[n] * y2;
+      x2 = x1; x1 = x;
+      y2 = y1; y1 = y;
+      p->fir[k] = y;
+    }
+  }
+  for (t = 0; t < p->num_terms; t++) {
+    y1 = y2 = 0.0;
+    for (k = 0; k < p->fir_length; k++) {
+      y = ((k == 0) ? p->c0[t] : 0.0) + ((k == 1) ? p->c1[t] : 0.0) - p->a1[t] * y1 - p->a2[t] * y2;
+      y2 = y1; y1 = y;
+      p->fir[k] -= y;
+    }
+  }
+}
+
+
+static double measure_mode_error(const cascade *f, const int mode, const int isa) {
+  //runs the same noise probe through copies of the cascade in direct form and 
+  //  in the given mode and returns the largest difference relative to the peak output
+  cascade *direct = (cascade *)malloc(sizeof(cascade));
+  cascade *tested = (cascade *)malloc(sizeof(cascade));
+  double work_direct[ACDfC_CHUNK], work_tested[ACDfC_CHUNK];
+  double peak = 0.0, error = 0.0;
+  unsigned int seed = 1;
+  unsigned long i;
+  void (*kernel)(cascade *, double *, const unsigned long) = CPU_DISPATCH_SELECT(calculate_chunk, isa);
+
+  memcpy(direct, f, sizeof(cascade));
+  memcpy(tested, f, sizeof(cascade));
+  direct->mode = ACDfC_MODE_DIRECT;
+  tested->mode = mode;
+  for (unsigned long pos = 0; pos < ACDfC_PROBE_LENGTH; pos += ACDfC_CHUNK) {
+    for (i = 0; i < ACDfC_CHUNK; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      work_direct[i] = work_tested[i] = (double)(int)seed / 2147483648.0;
+    }
+    kernel(direct, work_direct, ACDfC_CHUNK);
+    kernel(tested, work_tested, ACDfC_CHUNK);
+    for (i = 0; i < ACDfC_CHUNK; i++) {
+      if (fabs(work_direct[i]) > peak) peak = fabs(work_direct[i]);
+      if (fabs(work_direct[i] - work_tested[i]) > error) error = fabs(work_direct[i] - work_tested[i]);
+    }
+  }
+  free(direct);
+  free(tested);
+  if (peak == 0.0) return 0.0;
+  return error / peak;
+}
+
+
+void activateACDfCascade(LADSPA_Handle instance) {
+  ACDfCascade *pluginData = (ACDfCascade *)instance;
+  cascade *f = pluginData->filter;
+  const int mode = (int)(*(pluginData->mode) + 0.5);
+  const parallel_form *p = &f->parallel;
+  double error;
+  unsigned long hold;
+
+  calculate_ACDf_sections(pluginData->params, pluginData->rate, &f->coef);
+  f->mode = ACDfC_MODE_DIRECT;
+  f->latency = 0;
+  //the direct form is limited by the latency of each sample's calculation and does 
+  //  not benefit from wider vector instructions. It always uses the baseline kernel.
+  f->isa = CPU_ISA_BASELINE;
+  reset_cascade(f);
+  if (mode == ACDfC_MODE_BLOCK && f->coef.num_sections > 0) {
+    for (unsigned int n = 0; n < f->coef.num_sections; n++) {
+      calculate_block_coefficients(&f->coef, n, &f->block[n]);
+    }
+    //check the block kernel against the direct form before using it
+    error = measure_mode_error(f, ACDfC_MODE_BLOCK, pluginData->isa);
+    if (error <= ACDfC_BLOCK_ERROR_BOUND) {
+      f->mode = ACDfC_MODE_BLOCK;
+      f->isa = pluginData->isa;
+    } else {
+      cout << "ACDfCascade: the block kernel error of " << error << " exceeds " << ACDfC_BLOCK_ERROR_BOUND;
+      cout << ". The direct form will be used instead." << endl;
+    }
+  } else if (mode == ACDfC_MODE_PARALLEL && f->coef.num_sections > 0) {
+    calculate_parallel_form(f);
+    //check the parallel form against the direct form before using it
+    error = (p->num_terms < 2) ? 0.0 : measure_mode_error(f, ACDfC_MODE_PARALLEL, pluginData->isa);
+    if (p->num_terms < 2) {
+      cout << "ACDfCascade: the sections have fewer than two separate sets of poles, so there is nothing";
+      cout << " to calculate in parallel. The direct form will be used instead." << endl;
+    } else if (error <= ACDfC_PARALLEL_ERROR_BOUND) {
+      f->mode = ACDfC_MODE_PARALLEL;
+      f->isa = pluginData->isa;
+      cout << "ACDfCascade: parallel form with " << p->num_terms << " terms in " << p->num_lanes;
+      cout << " vector lanes and a direct term of " << p->fir_length << " taps";
+      if (p->num_serial > 0) cout << ", after " << p->num_serial << " section(s) with repeated poles in series";
+      cout << "." << endl;
+    } else {
+      cout << "ACDfCascade: the parallel form error of " << error << " exceeds " << ACDfC_PARALLEL_ERROR_BOUND;
+      cout << ". The direct form will be used instead." << endl;
+    }
+  } else if (mode == ACDfC_MODE_WAVEFRONT) {
+    //the wavefront form performs the same calculation as the direct form, only
+    //  in a different order, so it does not need to be checked
+    if (f->coef.num_sections < 2) {
+      cout << "ACDfCascade: the wavefront form needs at least two sections. The direct form will be used instead." << endl;
+    } else {
+      calculate_wavefront_form(f);
+      f->mode = ACDfC_MODE_WAVEFRONT;
+      f->isa = pluginData->isa;
+      f->latency = f->wavefront.num_lanes - 1;
+      cout << "ACDfCascade: wavefront form with " << f->coef.num_sections << " sections in ";
+      cout << f->wavefront.num_lanes << " vector lanes and a latency of " << f->latency << " samples." << endl;
+    }
+  }
+  //the sections decay in the same time in every mode. The delay of the wavefront
+  //  form and the direct term of the parallel form add to it.
+  hold = add_silence_hold(ACDf_sections_hold(&f->coef), f->latency);
+  if (f->mode == ACDfC_MODE_PARALLEL) hold = add_silence_hold(hold, p->fir_length);
+  set_silence_gate(&pluginData->gate, hold);
+  //the latency is also reported by run, in case the port is connected later
+  if (pluginData->latency) *(pluginData->latency) = (LADSPA_Data)f->latency;
+
+  static const char *mode_names[] = { "direct", "block", "parallel", "wavefront" };
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "%u sections, %s form", f->coef.num_sections, mode_names[f->mode]);
+  telemetry_open(&pluginData->meter, "ACDfCascade", info, 1, pluginData->rate);
+}
+
+
+static inline void processACDfCascade(ACDfCascade *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
+  const LADSPA_Data *input = pluginData->input;
+  LADSPA_Data *output = pluginData->output;
+  cascade *f = pluginData->filter;
+  double work[ACDfC_CHUNK];
+  unsigned long pos, chunk, i;
+  void (*kernel)(cascade *, double *, const unsigned long) = CPU_DISPATCH_SELECT(calculate_chunk, f->isa);
+
+  if (pluginData->latency) *(pluginData->latency) = (LADSPA_Data)f->latency;
+  if (silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count)) {
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  //the buffer is processed in chunks that are small enough to stay in the L1 cache
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > ACDfC_CHUNK) chunk = ACDfC_CHUNK;
+    for (i = 0; i < chunk; i++) work[i] = (double)input[pos+i];
+    kernel(f, work, chunk);
+    if (adding) {
+      for (i = 0; i < chunk; i++) output[pos+i] += pluginData->run_adding_gain * (LADSPA_Data)work[i];
+    } else {
+      for (i = 0; i < chunk; i++) output[pos+i] = (LADSPA_Data)work[i];
+    }
+  }
+  if (silence_gate_closing(&pluginData->gate)) reset_cascade(f);
+} //end processACDfCascade
+
+
+static inline void meterACDfCascade(ACDfCascade *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, &pluginData->output, sample_count, state, start);
+}
+
+
+void runACDfCascade(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfCascade *)instance)->meter);
+  processACDfCascade((ACDfCascade *)instance, sample_count, false);
+  meterACDfCascade((ACDfCascade *)instance, sample_count, start);
+} //end runACDfCascade.
+
+
+void runAddingACDfCascade(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfCascade *)instance)->meter);
+  processACDfCascade((ACDfCascade *)instance, sample_count, true);
+  meterACDfCascade((ACDfCascade *)instance, sample_count, start);
+} //end runAddingACDfCascade
+
+
+void setRunAddingGainACDfCascade(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((ACDfCascade *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupACDfCascade(LADSPA_Handle instance) {
+  ACDfCascade *pluginData = (ACDfCascade *)instance;
+  telemetry_close(&pluginData->meter);
+  free(pluginData->filter);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    ACDfCascadeDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+
+    if (ACDfCascadeDescriptor) {
+      std::string text;
+      //plugin descriptor info
+      ACDfCascadeDescriptor->UniqueID = 5227;
+      ACDfCascadeDescriptor->Label = "ACDfCascade";
+      ACDfCascadeDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "ACDfCascade v1.0: cascade of Active Crossover Designer LADSPA filters";
+      ACDfCascadeDescriptor->Name = strdup(text.c_str());
+      ACDfCascadeDescriptor->Maker = "Charlie Laub, 2025";
+      ACDfCascadeDescriptor->Copyright = "GPLv3";
+      ACDfCascadeDescriptor->PortCount = ACDfC_NUM_PORTS;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(ACDfC_NUM_PORTS,sizeof(LADSPA_PortDescriptor));
+      ACDfCascadeDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(ACDfC_NUM_PORTS,sizeof(LADSPA_PortRangeHint));
+      ACDfCascadeDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(ACDfC_NUM_PORTS, sizeof(char*));
+      ACDfCascadeDescriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the section parameters, named e.g. type1, fp1, ... qz8
+      describe_ACDf_section_ports(port_descriptors, port_names, port_range_hints);
+
+      //port = ACDfC_MODE
+      port_descriptors[ACDfC_MODE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "mode";
+      port_names[ACDfC_MODE] = strdup(text.c_str());
+      port_range_hints[ACDfC_MODE].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[ACDfC_MODE].LowerBound = ACDfC_MODE_DIRECT;
+      port_range_hints[ACDfC_MODE].UpperBound = ACDfC_MODE_WAVEFRONT;
+
+      //port = ACDfC_INPUT
+      port_descriptors[ACDfC_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+      text = "Input";
+      port_names[ACDfC_INPUT] = strdup(text.c_str());
+
+      //port = ACDfC_OUTPUT
+      port_descriptors[ACDfC_OUTPUT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+      text = "Output";
+      port_names[ACDfC_OUTPUT] = strdup(text.c_str());
+
+      //port = ACDfC_LATENCY
+      port_descriptors[ACDfC_LATENCY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      text = "latency";
+      port_names[ACDfC_LATENCY] = strdup(text.c_str());
+      port_range_hints[ACDfC_LATENCY].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[ACDfC_LATENCY].LowerBound = 0;
+
+      ACDfCascadeDescriptor->activate = activateACDfCascade;
+      ACDfCascadeDescriptor->cleanup = cleanupACDfCascade;
+      ACDfCascadeDescriptor->connect_port = connectPortACDfCascade;
+      ACDfCascadeDescriptor->deactivate = NULL;
+      ACDfCascadeDescriptor->instantiate = instantiateACDfCascade;
+      ACDfCascadeDescriptor->run = runACDfCascade;
+      ACDfCascadeDescriptor->run_adding = runAddingACDfCascade;
+      ACDfCascadeDescriptor->set_run_adding_gain = setRunAddingGainACDfCascade;
+    }
+  }
+  ~Initialiser() {
+    if (ACDfCascadeDescriptor) {
+      free((LADSPA_PortDescriptor *)ACDfCascadeDescriptor->PortDescriptors);
+      free((char **)ACDfCascadeDescriptor->PortNames);
+      free((LADSPA_PortRangeHint *)ACDfCascadeDescriptor->PortRangeHints);
+      free(ACDfCascadeDescriptor);
+    }
+  }
+} g_theInitialiser;
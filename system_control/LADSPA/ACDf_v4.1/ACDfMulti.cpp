@@ -0,0 +1,664 @@
+/* ACDfMulti LADSPA plugin, version 1.0
+   Copyright 2019-2025 Charlie Laub, GPLv3
+
+  ACDfMulti is the multichannel member of the ACDf family. It applies the same
+  cascade of up to ACDf_MAX_SECTIONS ACDf filters to 2, 4 or 8 channels at
+  once, e.g. the left and right channel of a stereo crossover way. The section
+  parameters are the same as those of ACDfCascade (type1, fp1, ... qz8) and are
+  shared by all channels. Each channel count has its own plugin label:
+    ACDfMulti2, ACDfMulti4, ACDfMulti8
+
+  Because every channel uses identical coefficients the channels can be
+  calculated side by side. The filter state is stored as a structure of arrays
+  with one "lane" per channel, and each section is calculated for all channels
+  with a single set of vector operations. The vectors use the GCC vector
+  extensions so that the compiler emits SSE/AVX or NEON instructions. The 
+  instruction set is chosen at run time, see cpu_dispatch.h.
+
+  The sections are normally calculated in double precision, as in ACDf. When
+  the precision parameter is set to 1, sections are calculated in single 
+  precision (float) where the output of the whole cascade stays within 
+  ACDfM_FLOAT_ERROR_BOUND of the double precision cascade. This halves the size
+  of the vectors, so twice as many channels fit in each vector register. The 
+  structure of each section is chosen when the plugin is activated by running 
+  two noise probes, white noise and low frequency noise, through the whole 
+  cascade and comparing its output with that of the double precision cascade.
+  Each section is given a share of the bound (see choose_section_structures)
+  and gets the first structure that keeps the error within it:
+    1. float direct form. This is the fastest.
+    2. float state variable filter. This structure is much less sensitive to
+       rounding for filters far below the sample rate. See ACDf_coefficients.h
+    3. double precision direct form.
+  The bound is only checked for the probes. Other signals, e.g. a pure low 
+  frequency tone, can have a somewhat larger error.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include "ACDf_coefficients.h"
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define ACDfM_MAX_CHANNELS  8  //maximum number of channels per instance
+#define ACDfM_CHUNK        64  //number of samples processed per pass through the sections
+#define ACDfM_ALIGNMENT    64  //alignment of the filter state, in bytes
+#define ACDfM_FIRST_ID   5228  //UniqueID of the first descriptor
+
+//the section parameters occupy the first ACDf_SECTION_PORTS ports (see
+//  ACDf_coefficients.h). They are followed by the precision port, the input 
+//  port of each channel and then the output port of each channel.
+#define ACDfM_PRECISION    ACDf_SECTION_PORTS
+#define ACDfM_FIRST_INPUT  (ACDf_SECTION_PORTS + 1)
+
+//values of the precision port:
+#define ACDfM_PRECISION_DOUBLE  0  //all sections in double precision
+#define ACDfM_PRECISION_AUTO    1  //float where the error of the cascade is within ACDfM_FLOAT_ERROR_BOUND
+//structure used to calculate each section:
+#define ACDfM_SECTION_DOUBLE     0  //double precision direct form
+#define ACDfM_SECTION_FLOAT_DF1  1  //single precision direct form
+#define ACDfM_SECTION_FLOAT_SVF  2  //single precision state variable filter
+static const char *ACDfM_section_names[3] = { "double", "float DF1", "float SVF" };
+#define ACDfM_FLOAT_ERROR_BOUND  (1.0 / 1048576.0)  //2^-20 or about -120dB relative to the peak output of the cascade
+#define ACDfM_PROBE_LENGTH       16384  //number of samples of each probe, a multiple of ACDfM_CHUNK
+#define ACDfM_NUM_PROBES             2  //white noise and low frequency noise, see make_probes
+#define ACDfM_PROBE_CORNER        10.0  //corner frequency of the low frequency probe, in Hz
+
+//one descriptor is created for each channel count:
+#define ACDfM_NUM_DESCRIPTORS 3
+static const unsigned int ACDfM_channels[ACDfM_NUM_DESCRIPTORS] = { 2, 4, 8 };
+static LADSPA_Descriptor *ACDfMultiDescriptor[ACDfM_NUM_DESCRIPTORS] = { NULL, NULL, NULL };
+
+
+//vector types holding one lane per channel, in double and single precision:
+typedef double v2d __attribute__((vector_size(2 * sizeof(double))));
+typedef double v4d __attribute__((vector_size(4 * sizeof(double))));
+typedef double v8d __attribute__((vector_size(8 * sizeof(double))));
+typedef float v2f __attribute__((vector_size(2 * sizeof(float))));
+typedef float v4f __attribute__((vector_size(4 * sizeof(float))));
+typedef float v8f __attribute__((vector_size(8 * sizeof(float))));
+template <unsigned int N> struct lanes;
+template <> struct lanes<2> { typedef v2d type; typedef v2f single; };
+template <> struct lanes<4> { typedef v4d type; typedef v4f single; };
+template <> struct lanes<8> { typedef v8d type; typedef v8f single; };
+
+
+typedef struct {
+  ACDf_sections coef; //coefficients of each section, shared by all channels
+  double dn;
+  //state of each section, stored as one lane per channel:
+  double x1[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  double x2[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  double y1[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  double y2[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  //structure and single precision coefficients of each section. The float 
+  //  direct form uses b0, b1, b2, a1, a2 and the state variable filter uses 
+  //  the coefficients calculated by calculate_svf.
+  int structure[ACDf_MAX_SECTIONS];
+  float fcoef[ACDf_MAX_SECTIONS][6];
+  //state of the single precision sections. The direct form uses all four, the 
+  //  state variable filter uses s1 and s2.
+  float s1[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  float s2[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  float s3[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+  float s4[ACDf_MAX_SECTIONS][ACDfM_MAX_CHANNELS] __attribute__((aligned(ACDfM_ALIGNMENT)));
+} multi_cascade;
+
+
+typedef struct {
+  LADSPA_Data *params[ACDf_SECTION_PORTS];
+  LADSPA_Data *precision;
+  LADSPA_Data rate;
+  unsigned int num_channels;
+  int isa; //instruction set used by run, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  multi_cascade * filter;
+  silence_gate gate; //skips the calculation while all inputs are silent
+  telemetry_meter meter; //level of the outputs in shared memory, see telemetry.h
+  LADSPA_Data *input[ACDfM_MAX_CHANNELS];
+  LADSPA_Data *output[ACDfM_MAX_CHANNELS];
+} ACDfMulti;
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  if (index < ACDfM_NUM_DESCRIPTORS) return ACDfMultiDescriptor[index];
+  return NULL;
+}
+
+
+LADSPA_Handle instantiateACDfMulti(const LADSPA_Descriptor *descriptor,
+                                   unsigned long sample_rate) {
+  ACDfMulti *pluginData = (ACDfMulti *)calloc(1, sizeof(ACDfMulti));
+  void *memory = NULL;
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->num_channels = ACDfM_channels[descriptor->UniqueID - ACDfM_FIRST_ID];
+  pluginData->isa = select_cpu_isa(descriptor->Label);
+  pluginData->run_adding_gain = 1.0;
+  if (posix_memalign(&memory, ACDfM_ALIGNMENT, sizeof(multi_cascade)) != 0) {
+    free(pluginData);
+    return NULL;
+  }
+  memset(memory, 0, sizeof(multi_cascade));
+  pluginData->filter = (multi_cascade *)memory;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortACDfMulti(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  ACDfMulti *pluginData = (ACDfMulti *)instance;
+  const unsigned int N = pluginData->num_channels;
+  if (port < ACDfM_PRECISION) {
+    pluginData->params[port] = data;
+  } else if (port == ACDfM_PRECISION) {
+    pluginData->precision = data;
+  } else if (port < ACDfM_FIRST_INPUT + N) {
+    pluginData->input[port - ACDfM_FIRST_INPUT] = data;
+  } else if (port < ACDfM_FIRST_INPUT + 2 * N) {
+    pluginData->output[port - ACDfM_FIRST_INPUT - N] = data;
+  }
+}
+
+
+template <typename T, typename S>
+CPU_KERNEL_INLINE void direct_form_section(T *work, const unsigned long n, const S *coef,
+                                           S *x1p, S *x2p, S *y1p, S *y2p, S dn) {
+  //calculates one section using the direct form, exactly as in ACDf. T is a
+  //  vector holding one lane per channel, or a scalar, and S is its element type.
+  //  coef holds b0, b1, b2, a1 and a2.
+  const S b0 = coef[0], b1 = coef[1], b2 = coef[2], a1 = coef[3], a2 = coef[4];
+  T x, y, x1, x2, y1, y2;
+  memcpy(&x1, x1p, sizeof(T)); memcpy(&x2, x2p, sizeof(T));
+  memcpy(&y1, y1p, sizeof(T)); memcpy(&y2, y2p, sizeof(T));
+  for (unsigned long i = 0; i < n; i++) {
+    x = work[i];
+    y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + dn;
+    dn = -dn;
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    work[i] = y;
+  }
+  memcpy(x1p, &x1, sizeof(T)); memcpy(x2p, &x2, sizeof(T));
+  memcpy(y1p, &y1, sizeof(T)); memcpy(y2p, &y2, sizeof(T));
+} //end direct_form_section
+
+
+template <typename T, typename S>
+CPU_KERNEL_INLINE void svf_section(T *work, const unsigned long n, const S *coef,
+                                   S *ic1p, S *ic2p, S dn) {
+  //calculates one section using the trapezoidal state variable filter. 
+  //  coef holds the coefficients calculated by calculate_svf. The denormal 
+  //  killer is added to both states once per call, which is enough to keep them
+  //  from decaying to denormal values and keeps it out of the sample loop.
+  const S c1 = coef[0], c2 = coef[1], c3 = coef[2], m0 = coef[3], m1 = coef[4], m2 = coef[5];
+  T v0, v1, v2, v3, ic1, ic2;
+  memcpy(&ic1, ic1p, sizeof(T)); memcpy(&ic2, ic2p, sizeof(T));
+  for (unsigned long i = 0; i < n; i++) {
+    v0 = work[i];
+    v3 = v0 - ic2;
+    v1 = c1 * ic1 + c2 * v3; //bandpass
+    v2 = ic2 + c2 * ic1 + c3 * v3; //lowpass
+    ic1 = v1 + v1 - ic1;
+    ic2 = v2 + v2 - ic2;
+    work[i] = m0 * v0 + m1 * v1 + m2 * v2;
+  }
+  ic1 += dn;
+  ic2 += dn;
+  memcpy(ic1p, &ic1, sizeof(T)); memcpy(ic2p, &ic2, sizeof(T));
+} //end svf_section
+
+
+static int calculate_svf(const ACDf_sections *c, const unsigned int n, float *fcoef) {
+  //calculates the single precision coefficients of the state variable filter
+  //  for section n. Returns 0 if the section has no state variable form.
+  ACDf_svf_coefficients svf;
+  if (!calculate_ACDf_svf_coefficients(c->b0[n], c->b1[n], c->b2[n], c->a1[n], c->a2[n], &svf)) return 0;
+  const double c1 = 1.0 / (1.0 + svf.g * (svf.g + svf.k));
+  fcoef[0] = (float)c1;
+  fcoef[1] = (float)(svf.g * c1);
+  fcoef[2] = (float)(svf.g * svf.g * c1);
+  fcoef[3] = (float)svf.m0;
+  fcoef[4] = (float)svf.m1;
+  fcoef[5] = (float)svf.m2;
+  return 1;
+} //end calculate_svf
+
+
+static void make_probes(float *white, float *low, const LADSPA_Data rate) {
+  //the probes used to choose the structure of the sections: full scale white
+  //  noise, and white noise through a leaky integrator with its corner at
+  //  ACDfM_PROBE_CORNER, scaled to full scale. The second probe holds most of
+  //  its power at low frequencies, where the float structures are least accurate.
+  const double pole = exp(-2.0 * M_PI * ACDfM_PROBE_CORNER / rate);
+  unsigned int seed = 1;
+  double sum = 0.0, peak = 0.0;
+  unsigned long i;
+  for (i = 0; i < ACDfM_PROBE_LENGTH; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    white[i] = (float)((double)(int)seed / 2147483648.0);
+    sum = pole * sum + white[i];
+    low[i] = (float)sum;
+    if (fabs(sum) > peak) peak = fabs(sum);
+  }
+  for (i = 0; i < ACDfM_PROBE_LENGTH; i++) low[i] = (float)(low[i] / peak);
+} //end make_probes
+
+
+static void run_probe(const multi_cascade *f, const float *probe, double *output) {
+  //runs a probe through the cascade for one channel with the structure and
+  //  coefficients of each section in f, exactly as run_channels does, but 
+  //  without the denormal killer
+  const ACDf_sections *c = &f->coef;
+  double x1[ACDf_MAX_SECTIONS], x2[ACDf_MAX_SECTIONS], y1[ACDf_MAX_SECTIONS], y2[ACDf_MAX_SECTIONS];
+  float s1[ACDf_MAX_SECTIONS], s2[ACDf_MAX_SECTIONS], s3[ACDf_MAX_SECTIONS], s4[ACDf_MAX_SECTIONS];
+  double work[ACDfM_CHUNK], coef[5];
+  float work_single[ACDfM_CHUNK];
+  unsigned long pos, i;
+  unsigned int section;
+  bool single, section_single;
+
+  for (section = 0; section < ACDf_MAX_SECTIONS; section++) {
+    x1[section] = x2[section] = y1[section] = y2[section] = 0.0;
+    s1[section] = s2[section] = s3[section] = s4[section] = 0.0f;
+  }
+  for (pos = 0; pos < ACDfM_PROBE_LENGTH; pos += ACDfM_CHUNK) {
+    single = c->num_sections > 0 && f->structure[0] != ACDfM_SECTION_DOUBLE;
+    for (i = 0; i < ACDfM_CHUNK; i++) {
+      if (single) work_single[i] = (float)(c->gain * (double)probe[pos+i]);
+      else work[i] = c->gain * (double)probe[pos+i];
+    }
+    for (section = 0; section < c->num_sections; section++) {
+      section_single = f->structure[section] != ACDfM_SECTION_DOUBLE;
+      if (section_single && !single) {
+        for (i = 0; i < ACDfM_CHUNK; i++) work_single[i] = (float)work[i];
+      } else if (!section_single && single) {
+        for (i = 0; i < ACDfM_CHUNK; i++) work[i] = work_single[i];
+      }
+      single = section_single;
+      switch (f->structure[section]) {
+      case ACDfM_SECTION_DOUBLE:
+        coef[0] = c->b0[section]; coef[1] = c->b1[section]; coef[2] = c->b2[section];
+        coef[3] = c->a1[section]; coef[4] = c->a2[section];
+        direct_form_section<double, double>(work, ACDfM_CHUNK, coef, &x1[section], &x2[section],
+                                            &y1[section], &y2[section], 0.0);
+        break;
+      case ACDfM_SECTION_FLOAT_DF1:
+        direct_form_section<float, float>(work_single, ACDfM_CHUNK, f->fcoef[section], &s1[section],
+                                          &s2[section], &s3[section], &s4[section], 0.0f);
+        break;
+      case ACDfM_SECTION_FLOAT_SVF:
+        svf_section<float, float>(work_single, ACDfM_CHUNK, f->fcoef[section], &s1[section], &s2[section], 0.0f);
+        break;
+      }
+    }
+    for (i = 0; i < ACDfM_CHUNK; i++) output[pos+i] = single ? (double)work_single[i] : work[i];
+  }
+} //end run_probe
+
+
+static double measure_cascade_error(const multi_cascade *f, float * const *probe, double * const *reference,
+                                    double *output) {
+  //returns the largest difference between the output of the cascade and the
+  //  double precision reference, relative to the peak of the reference, of
+  //  all probes
+  double error = 0.0, peak, difference;
+  for (unsigned int p = 0; p < ACDfM_NUM_PROBES; p++) {
+    run_probe(f, probe[p], output);
+    peak = 0.0;
+    difference = 0.0;
+    for (unsigned long i = 0; i < ACDfM_PROBE_LENGTH; i++) {
+      if (fabs(reference[p][i]) > peak) peak = fabs(reference[p][i]);
+      if (fabs(output[i] - reference[p][i]) > difference) difference = fabs(output[i] - reference[p][i]);
+    }
+    if (peak > 0.0 && difference / peak > error) error = difference / peak;
+  }
+  return error;
+} //end measure_cascade_error
+
+
+static void choose_section_structures(multi_cascade *f, const LADSPA_Data rate) {
+  //chooses the fastest structure of each section for which the output of the
+  //  whole cascade stays within ACDfM_FLOAT_ERROR_BOUND of the double precision
+  //  cascade for all probes. The probes pass through the sections before each
+  //  section, so each one is tested with the band limited signal that it 
+  //  actually receives. The sections are decided in order, and once section n
+  //  has been decided the error may be at most (n+1)/num_sections of the bound,
+  //  so that the first sections cannot use up the bound of the later ones. The
+  //  sections stay in double precision if the memory for the probes is not 
+  //  available.
+  const ACDf_sections *c = &f->coef;
+  float *probe[ACDfM_NUM_PROBES];
+  double *reference[ACDfM_NUM_PROBES], *output;
+  double bound;
+  unsigned int n, p;
+  float *memory = (float *)malloc(ACDfM_NUM_PROBES * ACDfM_PROBE_LENGTH * (sizeof(float) + sizeof(double))
+                                  + ACDfM_PROBE_LENGTH * sizeof(double));
+  for (n = 0; n < ACDf_MAX_SECTIONS; n++) f->structure[n] = ACDfM_SECTION_DOUBLE;
+  if (!memory) return;
+  output = (double *)memory;
+  for (p = 0; p < ACDfM_NUM_PROBES; p++) {
+    reference[p] = output + (p + 1) * ACDfM_PROBE_LENGTH;
+    probe[p] = (float *)(output + (ACDfM_NUM_PROBES + 1) * ACDfM_PROBE_LENGTH) + p * ACDfM_PROBE_LENGTH;
+  }
+  make_probes(probe[0], probe[1], rate);
+  for (p = 0; p < ACDfM_NUM_PROBES; p++) run_probe(f, probe[p], reference[p]);
+
+  for (n = 0; n < c->num_sections; n++) {
+    bound = ACDfM_FLOAT_ERROR_BOUND * (n + 1) / c->num_sections;
+    f->fcoef[n][0] = (float)c->b0[n];
+    f->fcoef[n][1] = (float)c->b1[n];
+    f->fcoef[n][2] = (float)c->b2[n];
+    f->fcoef[n][3] = (float)c->a1[n];
+    f->fcoef[n][4] = (float)c->a2[n];
+    f->structure[n] = ACDfM_SECTION_FLOAT_DF1;
+    if (measure_cascade_error(f, probe, reference, output) <= bound) continue;
+    if (calculate_svf(c, n, f->fcoef[n])) {
+      f->structure[n] = ACDfM_SECTION_FLOAT_SVF;
+      if (measure_cascade_error(f, probe, reference, output) <= bound) continue;
+    }
+    f->structure[n] = ACDfM_SECTION_DOUBLE;
+  }
+  free(memory);
+} //end choose_section_structures
+
+
+static void clear_multi_cascade(multi_cascade *f) {
+  //initializes the state of each section for all channels. The float direct
+  //  form and the state variable filter start from zero.
+  f->dn = DENORMALKILLER;
+  for (unsigned int n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    for (unsigned int ch = 0; ch < ACDfM_MAX_CHANNELS; ch++) {
+      f->x1[n][ch] = 0.0;
+      f->x2[n][ch] = 0.0;
+      f->y1[n][ch] = DENORMALKILLER;
+      f->y2[n][ch] = DENORMALKILLER;
+      f->s1[n][ch] = 0.0;
+      f->s2[n][ch] = 0.0;
+      f->s3[n][ch] = (f->structure[n] == ACDfM_SECTION_FLOAT_SVF) ? 0.0 : DENORMALKILLER;
+      f->s4[n][ch] = (f->structure[n] == ACDfM_SECTION_FLOAT_SVF) ? 0.0 : DENORMALKILLER;
+    }
+  }
+} //end clear_multi_cascade
+
+
+void activateACDfMulti(LADSPA_Handle instance) {
+  ACDfMulti *pluginData = (ACDfMulti *)instance;
+  multi_cascade *f = pluginData->filter;
+  unsigned int n;
+
+  calculate_ACDf_sections(pluginData->params, pluginData->rate, &f->coef);
+  for (n = 0; n < ACDf_MAX_SECTIONS; n++) f->structure[n] = ACDfM_SECTION_DOUBLE;
+  if ((int)(*(pluginData->precision) + 0.5) == ACDfM_PRECISION_AUTO && f->coef.num_sections > 0) {
+    choose_section_structures(f, pluginData->rate);
+    cout << "ACDfMulti" << pluginData->num_channels << ": section precision:";
+    for (n = 0; n < f->coef.num_sections; n++) {
+      cout << " " << n+1 << "=" << ACDfM_section_names[f->structure[n]];
+    }
+    cout << endl;
+  }
+  clear_multi_cascade(f);
+  set_silence_gate(&pluginData->gate, ACDf_sections_hold(&f->coef));
+
+  char label[TELEMETRY_LABEL_SIZE], info[TELEMETRY_INFO_SIZE];
+  snprintf(label, sizeof(label), "ACDfMulti%u", pluginData->num_channels);
+  snprintf(info, sizeof(info), "%u sections", f->coef.num_sections);
+  telemetry_open(&pluginData->meter, label, info, pluginData->num_channels, pluginData->rate);
+}
+
+
+template <unsigned int N>
+CPU_KERNEL_INLINE void run_channels(ACDfMulti *pluginData, unsigned long sample_count, const bool adding) {
+  //calculates the cascade for N channels. The samples of all channels at the
+  //  same time index are gathered into one vector, so that each operation of
+  //  the difference equation is carried out for every channel at once. Sections
+  //  calculated in single precision use the work_single buffer, and the samples
+  //  are converted when the precision changes from one section to the next.
+  //  When adding is true the result, multiplied by the run_adding gain, is 
+  //  added to the output buffers.
+  typedef typename lanes<N>::type vec;
+  typedef typename lanes<N>::single vec_single;
+  multi_cascade *f = pluginData->filter;
+  const ACDf_sections *c = &f->coef;
+  LADSPA_Data * const *input = pluginData->input;
+  LADSPA_Data * const *output = pluginData->output;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  vec work[ACDfM_CHUNK];
+  vec_single work_single[ACDfM_CHUNK];
+  double coef[5], dn;
+  unsigned long pos, chunk, i;
+  unsigned int section, ch;
+  bool single, section_single;
+
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > ACDfM_CHUNK) chunk = ACDfM_CHUNK;
+    //gather the channels into the work buffer of the first section's precision
+    single = c->num_sections > 0 && f->structure[0] != ACDfM_SECTION_DOUBLE;
+    for (ch = 0; ch < N; ch++) {
+      if (single) {
+        for (i = 0; i < chunk; i++) work_single[i][ch] = (float)(c->gain * (double)input[ch][pos+i]);
+      } else {
+        for (i = 0; i < chunk; i++) work[i][ch] = c->gain * (double)input[ch][pos+i];
+      }
+    }
+
+    for (section = 0; section < c->num_sections; section++) {
+      section_single = f->structure[section] != ACDfM_SECTION_DOUBLE;
+      if (section_single && !single) {
+        for (i = 0; i < chunk; i++) work_single[i] = __builtin_convertvector(work[i], vec_single);
+      } else if (!section_single && single) {
+        for (i = 0; i < chunk; i++) work[i] = __builtin_convertvector(work_single[i], vec);
+      }
+      single = section_single;
+      switch (f->structure[section]) {
+      case ACDfM_SECTION_DOUBLE:
+        coef[0] = c->b0[section]; coef[1] = c->b1[section]; coef[2] = c->b2[section];
+        coef[3] = c->a1[section]; coef[4] = c->a2[section];
+        direct_form_section<vec, double>(work, chunk, coef, f->x1[section], f->x2[section],
+                                         f->y1[section], f->y2[section], f->dn);
+        break;
+      case ACDfM_SECTION_FLOAT_DF1:
+        direct_form_section<vec_single, float>(work_single, chunk, f->fcoef[section], f->s1[section],
+                                               f->s2[section], f->s3[section], f->s4[section], (float)f->dn);
+        break;
+      case ACDfM_SECTION_FLOAT_SVF:
+        svf_section<vec_single, float>(work_single, chunk, f->fcoef[section], f->s1[section],
+                                       f->s2[section], (float)f->dn);
+        break;
+      }
+    }
+
+    if (c->num_sections == 0) {
+      //gain stage only. Add the denormal killer as ACDf would.
+      dn = f->dn;
+      for (i = 0; i < chunk; i++) {
+        work[i] += dn;
+        dn = -dn;
+      }
+    }
+    //the sign of dn only changes when the chunk length is odd
+    if (chunk & 1) f->dn = -f->dn;
+
+    //scatter the work buffer back to the channels
+    if (single) {
+      for (i = 0; i < chunk; i++) work[i] = __builtin_convertvector(work_single[i], vec);
+    }
+    for (ch = 0; ch < N; ch++) {
+      if (adding) {
+        for (i = 0; i < chunk; i++) output[ch][pos+i] += gain * (LADSPA_Data)work[i][ch];
+      } else {
+        for (i = 0; i < chunk; i++) output[ch][pos+i] = (LADSPA_Data)work[i][ch];
+      }
+    }
+  }
+} //end run_channels
+
+
+CPU_KERNEL_INLINE void run_multi(ACDfMulti *pluginData, unsigned long sample_count, const bool adding) {
+  switch (pluginData->num_channels) {
+  case 2:
+    run_channels<2>(pluginData, sample_count, adding);
+    break;
+  case 4:
+    run_channels<4>(pluginData, sample_count, adding);
+    break;
+  case 8:
+    run_channels<8>(pluginData, sample_count, adding);
+    break;
+  }
+} //end run_multi
+//compile run_multi for each instruction set. See cpu_dispatch.h
+CPU_DISPATCH_KERNELS(run_multi, (ACDfMulti *pluginData, unsigned long sample_count, const bool adding), 
+                     (pluginData, sample_count, adding))
+
+
+static inline void processACDfMulti(ACDfMulti *pluginData, unsigned long sample_count, const bool adding) {
+  //the channels are calculated together, so they share one silence gate that
+  //  only closes when all inputs are silent
+  const unsigned int N = pluginData->num_channels;
+  bool silent = true;
+  unsigned int ch;
+  for (ch = 0; ch < N && silent; ch++) silent = is_silent(pluginData->input[ch], sample_count);
+  if (silence_gate_skip(&pluginData->gate, silent, sample_count)) {
+    for (ch = 0; ch < N; ch++) write_silence(pluginData->output[ch], sample_count, adding);
+    return;
+  }
+  CPU_DISPATCH_SELECT(run_multi, pluginData->isa)(pluginData, sample_count, adding);
+  if (silence_gate_closing(&pluginData->gate)) clear_multi_cascade(pluginData->filter);
+} //end processACDfMulti
+
+
+static inline void meterACDfMulti(ACDfMulti *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, pluginData->output, sample_count, state, start);
+}
+
+
+void runACDfMulti(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfMulti *)instance)->meter);
+  processACDfMulti((ACDfMulti *)instance, sample_count, false);
+  meterACDfMulti((ACDfMulti *)instance, sample_count, start);
+} //end runACDfMulti.
+
+
+void runAddingACDfMulti(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfMulti *)instance)->meter);
+  processACDfMulti((ACDfMulti *)instance, sample_count, true);
+  meterACDfMulti((ACDfMulti *)instance, sample_count, start);
+} //end runAddingACDfMulti
+
+
+void setRunAddingGainACDfMulti(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((ACDfMulti *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupACDfMulti(LADSPA_Handle instance) {
+  ACDfMulti *pluginData = (ACDfMulti *)instance;
+  telemetry_close(&pluginData->meter);
+  free(pluginData->filter);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    LADSPA_Descriptor *descriptor;
+    unsigned int N;
+    unsigned long num_ports, port;
+
+    for (unsigned int index = 0; index < ACDfM_NUM_DESCRIPTORS; index++) {
+      ACDfMultiDescriptor[index] = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+      descriptor = ACDfMultiDescriptor[index];
+      if (!descriptor) continue;
+      std::string text;
+      N = ACDfM_channels[index];
+      num_ports = ACDfM_FIRST_INPUT + 2 * N;
+      //plugin descriptor info
+      descriptor->UniqueID = ACDfM_FIRST_ID + index;
+      text = "ACDfMulti" + to_string(N);
+      descriptor->Label = strdup(text.c_str());
+      descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "ACDfMulti v1.0: " + to_string(N) + " channel cascade of Active Crossover Designer LADSPA filters";
+      descriptor->Name = strdup(text.c_str());
+      descriptor->Maker = "Charlie Laub, 2025";
+      descriptor->Copyright = "GPLv3";
+      descriptor->PortCount = num_ports;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
+      descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
+      descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(num_ports, sizeof(char*));
+      descriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the section parameters, named e.g. type1, fp1, ... qz8
+      describe_ACDf_section_ports(port_descriptors, port_names, port_range_hints);
+
+      //port = ACDfM_PRECISION
+      port_descriptors[ACDfM_PRECISION] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      port_names[ACDfM_PRECISION] = strdup("precision");
+      port_range_hints[ACDfM_PRECISION].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[ACDfM_PRECISION].LowerBound = ACDfM_PRECISION_DOUBLE;
+      port_range_hints[ACDfM_PRECISION].UpperBound = ACDfM_PRECISION_AUTO;
+
+      //audio ports, named Input1 ... InputN and Output1 ... OutputN
+      for (unsigned int ch = 0; ch < N; ch++) {
+        port = ACDfM_FIRST_INPUT + ch;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+        text = "Input" + to_string(ch+1);
+        port_names[port] = strdup(text.c_str());
+        port = ACDfM_FIRST_INPUT + N + ch;
+        port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+        text = "Output" + to_string(ch+1);
+        port_names[port] = strdup(text.c_str());
+      }
+
+      descriptor->activate = activateACDfMulti;
+      descriptor->cleanup = cleanupACDfMulti;
+      descriptor->connect_port = connectPortACDfMulti;
+      descriptor->deactivate = NULL;
+      descriptor->instantiate = instantiateACDfMulti;
+      descriptor->run = runACDfMulti;
+      descriptor->run_adding = runAddingACDfMulti;
+      descriptor->set_run_adding_gain = setRunAddingGainACDfMulti;
+    }
+  }
+  ~Initialiser() {
+    for (unsigned int index = 0; index < ACDfM_NUM_DESCRIPTORS; index++) {
+      if (ACDfMultiDescriptor[index]) {
+        free((LADSPA_PortDescriptor *)ACDfMultiDescriptor[index]->PortDescriptors);
+        free((char **)ACDfMultiDescriptor[index]->PortNames);
+        free((LADSPA_PortRangeHint *)ACDfMultiDescriptor[index]->PortRangeHints);
+        free(ACDfMultiDescriptor[index]);
+      }
+    }
+  }
+} g_theInitialiser;
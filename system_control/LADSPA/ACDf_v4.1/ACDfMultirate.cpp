@@ -0,0 +1,540 @@
+/* ACDfMultirate LADSPA plugin, version 1.0
+   Copyright 2019-2025 Charlie Laub, GPLv3
+
+  ACDfMultirate applies a cascade of up to ACDf_MAX_SECTIONS ACDf filters at a
+  reduced sample rate. It is intended for subwoofer and woofer routes, which
+  only need a small part of the bandwidth of the system sample rate. The input
+  is decimated by a factor of 2 per stage through a cascade of halfband
+  lowpass filters, the sections are calculated at the reduced rate, and the
+  result is interpolated back to the original rate through the same halfband
+  filters. At 96kHz with 3 stages the sections run at 12kHz, i.e. at one
+  eighth of the cost, and filters at low frequencies are much less sensitive
+  to coefficient rounding than they are at the full rate.
+
+  The section parameters are the same as those of ACDfCascade (type1, fp1, ...
+  qz8). The frequencies are given in Hz as usual and the coefficients are
+  calculated for the reduced rate. The output is limited to the passband of
+  the halfband filters, ACDfR_PASSBAND times the reduced rate.
+
+  The halfband filters are linear phase FIR filters designed with a Kaiser
+  window when the plugin is activated. Their stopband rejection is set by the
+  rejection parameter. Every second coefficient of a halfband filter is zero,
+  and the decimator only calculates every second output while the interpolator
+  only calculates every second output with more than one tap (polyphase form).
+  The filters delay the signal by a fixed number of samples, which is reported
+  by the latency port.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include "ACDf_coefficients.h"
+#include "silence_gate.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define ACDfR_CHUNK        256  //number of input samples processed per pass
+#define ACDfR_MAX_STAGES     5  //largest number of halfband stages (factor 32)
+#define ACDfR_MAX_TAPS      64  //largest number of non-zero taps per halfband polyphase branch
+#define ACDfR_PASSBAND     0.3  //upper edge of the passband, relative to the reduced rate
+//the halfband filter of each stage has 4*K-1 coefficients. The center
+//  coefficient is 0.5, every second coefficient is zero, and the 2*K remaining
+//  coefficients (at most ACDfR_MAX_TAPS) are stored in taps[].
+
+//the section parameters occupy the first ACDf_SECTION_PORTS ports (see
+//  ACDf_coefficients.h). The other ports follow the section parameters:
+#define ACDfR_STAGES       ACDf_SECTION_PORTS
+#define ACDfR_REJECTION    (ACDfR_STAGES + 1)
+#define ACDfR_INPUT        (ACDfR_REJECTION + 1)
+#define ACDfR_OUTPUT       (ACDfR_INPUT + 1)
+#define ACDfR_LATENCY      (ACDfR_OUTPUT + 1)  //output: delay of the halfband filters, in samples
+#define ACDfR_NUM_PORTS    (ACDfR_LATENCY + 1)
+
+
+static LADSPA_Descriptor *ACDfMultirateDescriptor = NULL;
+
+typedef struct {
+  unsigned int num_taps; //2*K, the number of non-zero taps other than the center
+  double taps[ACDfR_MAX_TAPS]; //coefficients 0, 2, 4 ... 4K-2 of the filter. They are
+                               //  symmetric and only the first K are used.
+  unsigned int phase; //decimator: 1 if held contains an input that has no partner yet
+  double held;
+  //previous inputs of the decimator, split into the two polyphase branches, and
+  //  of the interpolator (at the lower rate), most recent last:
+  double decimator_history[ACDfR_MAX_TAPS - 1];
+  double decimator_center[ACDfR_MAX_TAPS / 2 - 1];
+  double interpolator_history[ACDfR_MAX_TAPS - 1];
+} halfband;
+
+typedef struct {
+  ACDf_sections coef; //coefficients of each section at the reduced rate
+  unsigned int num_stages;
+  halfband stage[ACDfR_MAX_STAGES];
+  unsigned int latency; //total delay of the halfband filters, in samples
+  double dn;
+  double x1[ACDf_MAX_SECTIONS], x2[ACDf_MAX_SECTIONS];
+  double y1[ACDf_MAX_SECTIONS], y2[ACDf_MAX_SECTIONS];
+  //interpolated samples that have not been output yet:
+  double pending[ACDfR_CHUNK + (1 << ACDfR_MAX_STAGES)];
+  unsigned long num_pending;
+} multirate;
+
+
+typedef struct {
+  LADSPA_Data *params[ACDf_SECTION_PORTS];
+  LADSPA_Data *stages;
+  LADSPA_Data *rejection;
+  LADSPA_Data rate;
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  multirate * filter;
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
+  LADSPA_Data *input;
+  LADSPA_Data *output;
+  LADSPA_Data *latency;
+} ACDfMultirate;
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  switch (index) {
+  case 0:
+    return ACDfMultirateDescriptor;
+  default:
+    return NULL;
+  }
+}
+
+
+LADSPA_Handle instantiateACDfMultirate(const LADSPA_Descriptor *descriptor,
+                                       unsigned long sample_rate) {
+  ACDfMultirate *pluginData = (ACDfMultirate *)calloc(1, sizeof(ACDfMultirate));
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->filter = (multirate *)calloc(1, sizeof(multirate));
+  pluginData->run_adding_gain = 1.0;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortACDfMultirate(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  ACDfMultirate *pluginData = (ACDfMultirate *)instance;
+  if (port < ACDfR_STAGES) {
+    pluginData->params[port] = data;
+    return;
+  }
+  switch (port) {
+  case ACDfR_STAGES:
+    pluginData->stages = data;
+    break;
+  case ACDfR_REJECTION:
+    pluginData->rejection = data;
+    break;
+  case ACDfR_INPUT:
+    pluginData->input = data;
+    break;
+  case ACDfR_OUTPUT:
+    pluginData->output = data;
+    break;
+  case ACDfR_LATENCY:
+    pluginData->latency = data;
+    break;
+  }
+}
+
+
+static double bessel_i0(const double x) {
+  //modified Bessel function of the first kind, order 0, used by the Kaiser window
+  double sum = 1.0, term = 1.0;
+  for (unsigned int k = 1; k < 100 && term > 1.e-16 * sum; k++) {
+    term *= (0.5 * x / k) * (0.5 * x / k);
+    sum += term;
+  }
+  return sum;
+}
+
+
+static void design_halfband(halfband *s, const double transition, const double rejection) {
+  //designs a halfband lowpass filter with the given transition width (relative
+  //  to the sample rate of the filter) and stopband rejection in dB, using a
+  //  Kaiser window. The length and window shape follow Kaiser's formulas.
+  double beta, length, center, n, sum = 0.0;
+  unsigned int K, t;
+
+  if (rejection > 50.0) beta = 0.1102 * (rejection - 8.7);
+  else if (rejection > 21.0) beta = 0.5842 * pow(rejection - 21.0, 0.4) + 0.07886 * (rejection - 21.0);
+  else beta = 0.0;
+  length = (rejection - 7.95) / (14.36 * transition) + 1.0;
+  //round up to a length of 4*K-1, so that the outer coefficients are not zero
+  K = (unsigned int)ceil((length + 1.0) / 4.0);
+  if (K < 1) K = 1;
+  if (2 * K > ACDfR_MAX_TAPS) K = ACDfR_MAX_TAPS / 2;
+  s->num_taps = 2 * K;
+  center = 2.0 * K - 1.0;
+  for (t = 0; t < s->num_taps; t++) {
+    //tap t is coefficient 2t, at an odd distance n from the center
+    n = 2.0 * t - center;
+    s->taps[t] = sin(0.5 * M_PI * n) / (M_PI * n) * bessel_i0(beta * sqrt(1.0 - (n / center) * (n / center)))
+               / bessel_i0(beta);
+    sum += s->taps[t];
+  }
+  //the taps of each polyphase branch must sum to 0.5 for a gain of exactly 1 at DC
+  for (t = 0; t < s->num_taps; t++) s->taps[t] *= 0.5 / sum;
+} //end design_halfband
+
+
+static inline double halfband_branch(const double *taps, const unsigned int K, const double *x) {
+  //returns the output of the polyphase branch with the non-zero taps, for the
+  //  inputs x[0] (oldest) ... x[2K-1] (newest). Since the taps are symmetric,
+  //  the inputs are added in pairs before they are multiplied.
+  double y = 0.0;
+  for (unsigned int t = 0; t < K; t++) y += taps[t] * (x[2*K-1-t] + x[t]);
+  return y;
+}
+
+
+static unsigned long decimate(halfband *s, double *data, const unsigned long count) {
+  //filters count samples and keeps every second one. The result replaces the
+  //  beginning of data and the number of output samples is returned. The inputs
+  //  are split into the samples that meet the non-zero taps (branch) and those
+  //  that meet the center coefficient (center).
+  const unsigned int K = s->num_taps / 2;
+  double branch[ACDfR_MAX_TAPS - 1 + ACDfR_CHUNK / 2 + 1];
+  double center[ACDfR_MAX_TAPS / 2 - 1 + ACDfR_CHUNK / 2 + 1];
+  unsigned long i = 0, j, out = 0;
+
+  memcpy(branch, s->decimator_history, (2 * K - 1) * sizeof(double));
+  memcpy(center, s->decimator_center, (K - 1) * sizeof(double));
+  if (s->phase && count > 0) {
+    center[K - 1] = s->held;
+    branch[2 * K - 1] = data[0];
+    out = 1;
+    i = 1;
+  }
+  for ( ; i + 1 < count; i += 2, out++) {
+    center[K - 1 + out] = data[i];
+    branch[2 * K - 1 + out] = data[i+1];
+  }
+  if (i < count) {
+    s->held = data[i];
+    s->phase = 1;
+  } else if (count > 0) {
+    s->phase = 0;
+  }
+  for (j = 0; j < out; j++) data[j] = halfband_branch(s->taps, K, &branch[j]) + 0.5 * center[j];
+  memcpy(s->decimator_history, &branch[out], (2 * K - 1) * sizeof(double));
+  memcpy(s->decimator_center, &center[out], (K - 1) * sizeof(double));
+  return out;
+} //end decimate
+
+
+static unsigned long interpolate(halfband *s, const double *data, const unsigned long count, double *output) {
+  //inserts a sample between each of the count samples of data and filters the
+  //  result. Of each pair of outputs, the second one only depends on the center
+  //  coefficient. The number of output samples, 2*count, is returned.
+  const unsigned int K = s->num_taps / 2;
+  double buffer[ACDfR_MAX_TAPS - 1 + ACDfR_CHUNK];
+  unsigned long i;
+
+  memcpy(buffer, s->interpolator_history, (2 * K - 1) * sizeof(double));
+  memcpy(&buffer[2 * K - 1], data, count * sizeof(double));
+  for (i = 0; i < count; i++) {
+    output[2*i] = 2.0 * halfband_branch(s->taps, K, &buffer[i]);
+    output[2*i+1] = buffer[i + K];
+  }
+  memcpy(s->interpolator_history, &buffer[count], (2 * K - 1) * sizeof(double));
+  return 2 * count;
+} //end interpolate
+
+
+static void run_sections(multirate *f, double *work, const unsigned long n) {
+  //applies the gain and the sections at the reduced rate, one sample at a time,
+  //  exactly as in ACDf
+  const ACDf_sections *c = &f->coef;
+  double b0, b1, b2, a1, a2, x1, x2, y1, y2, x, y, dn;
+  unsigned long i;
+
+  for (i = 0; i < n; i++) work[i] *= c->gain;
+  for (unsigned int section = 0; section < c->num_sections; section++) {
+    b0 = c->b0[section]; b1 = c->b1[section]; b2 = c->b2[section];
+    a1 = c->a1[section]; a2 = c->a2[section];
+    x1 = f->x1[section]; x2 = f->x2[section];
+    y1 = f->y1[section]; y2 = f->y2[section];
+    dn = f->dn;
+    for (i = 0; i < n; i++) {
+      x = work[i];
+      y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + dn;
+      dn = -dn;
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      work[i] = y;
+    }
+    f->x1[section] = x1; f->x2[section] = x2;
+    f->y1[section] = y1; f->y2[section] = y2;
+  }
+  if (n & 1) f->dn = -f->dn;
+} //end run_sections
+
+
+static void clear_multirate(multirate *f) {
+  //initializes the state of the halfband filters and of the sections
+  unsigned int k, n;
+  for (k = 0; k < f->num_stages; k++) {
+    f->stage[k].phase = 0;
+    memset(f->stage[k].decimator_history, 0, sizeof(f->stage[k].decimator_history));
+    memset(f->stage[k].decimator_center, 0, sizeof(f->stage[k].decimator_center));
+    memset(f->stage[k].interpolator_history, 0, sizeof(f->stage[k].interpolator_history));
+  }
+  for (n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    f->x1[n] = 0.0;
+    f->x2[n] = 0.0;
+    f->y1[n] = DENORMALKILLER;
+    f->y2[n] = DENORMALKILLER;
+  }
+  f->dn = DENORMALKILLER;
+  //start with enough pending samples to output a full buffer before the first
+  //  interpolated samples are available
+  f->num_pending = (1 << f->num_stages) - 1;
+  for (n = 0; n < f->num_pending; n++) f->pending[n] = 0.0;
+} //end clear_multirate
+
+
+void activateACDfMultirate(LADSPA_Handle instance) {
+  ACDfMultirate *pluginData = (ACDfMultirate *)instance;
+  multirate *f = pluginData->filter;
+  LADSPA_Data * const *p;
+  double reduced_rate, passband, stage_rate, rejection;
+  unsigned int n, k, inner_latency;
+  unsigned long hold;
+
+  f->num_stages = (unsigned int)(*(pluginData->stages) + 0.5);
+  if (f->num_stages < 1) f->num_stages = 1;
+  if (f->num_stages > ACDfR_MAX_STAGES) f->num_stages = ACDfR_MAX_STAGES;
+  rejection = *(pluginData->rejection);
+  reduced_rate = pluginData->rate / (double)(1 << f->num_stages);
+  passband = ACDfR_PASSBAND * reduced_rate;
+
+  //each stage must pass the final passband and reject everything that would
+  //  be folded into it by the decimation, i.e. from rate/2 - passband upwards
+  stage_rate = pluginData->rate;
+  for (k = 0; k < f->num_stages; k++) {
+    design_halfband(&f->stage[k], 0.5 - 2.0 * passband / stage_rate, rejection);
+    stage_rate *= 0.5;
+  }
+
+  //the delay of the stages, working outwards from the reduced rate. A stage with
+  //  filter length 4K-1 delays by 2K-1 samples at its input rate, both when
+  //  decimating and when interpolating. The pending samples add 2^stages - 1 samples.
+  inner_latency = 0;
+  for (k = f->num_stages; k-- > 0; ) {
+    inner_latency = 2 * (f->stage[k].num_taps - 1) + 2 * inner_latency - 1;
+  }
+  f->latency = inner_latency + (1 << f->num_stages) - 1;
+
+  calculate_ACDf_sections(pluginData->params, (LADSPA_Data)reduced_rate, &f->coef);
+
+  clear_multirate(f);
+  //the halfband filters are linear phase, so their impulse responses last twice
+  //  as long as their delay. The sections decay at the reduced rate.
+  hold = ACDf_sections_hold(&f->coef);
+  hold = (hold > (ULONG_MAX >> f->num_stages)) ? ULONG_MAX : (hold << f->num_stages);
+  set_silence_gate(&pluginData->gate, add_silence_hold(hold, 2 * (unsigned long)f->latency));
+
+  cout << "ACDfMultirate: " << f->num_stages << " halfband stage(s) with";
+  for (k = 0; k < f->num_stages; k++) cout << " " << 2 * f->stage[k].num_taps - 1;
+  cout << " taps. The sections run at " << reduced_rate << "Hz with a passband up to " << passband;
+  cout << "Hz and the latency is " << f->latency << " samples." << endl;
+  //sections above the passband are removed by the halfband filters
+  for (n = 0; n < ACDf_MAX_SECTIONS; n++) {
+    p = &pluginData->params[n * ACDf_PARAMS_PER_SECTION];
+    if ((int)(*p[ACDf_SECTION_TYPE]) == 0) continue;
+    if (*p[ACDf_SECTION_FP] > passband || ((int)(*p[ACDf_SECTION_TYPE]) >= 27 && *p[ACDf_SECTION_FZ] > passband)) {
+      cout << "ACDfMultirate: WARNING: the frequency of section " << n+1 << " is above the passband of ";
+      cout << passband << "Hz. Use fewer stages." << endl;
+    }
+  }
+  if (pluginData->latency) *(pluginData->latency) = (LADSPA_Data)f->latency;
+
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "%u sections, %u stages", f->coef.num_sections, f->num_stages);
+  telemetry_open(&pluginData->meter, "ACDfMultirate", info, 1, pluginData->rate);
+}
+
+
+static inline void processACDfMultirate(ACDfMultirate *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
+  const LADSPA_Data *input = pluginData->input;
+  LADSPA_Data *output = pluginData->output;
+  multirate *f = pluginData->filter;
+  double work[ACDfR_CHUNK], expanded[ACDfR_CHUNK];
+  unsigned long pos, chunk, count, i;
+  unsigned int k;
+
+  if (pluginData->latency) *(pluginData->latency) = (LADSPA_Data)f->latency;
+  if (silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count)) {
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > ACDfR_CHUNK) chunk = ACDfR_CHUNK;
+    for (i = 0; i < chunk; i++) work[i] = (double)input[pos+i];
+    count = chunk;
+    for (k = 0; k < f->num_stages; k++) count = decimate(&f->stage[k], work, count);
+    run_sections(f, work, count);
+    for (k = f->num_stages; k-- > 0; ) {
+      count = interpolate(&f->stage[k], work, count, expanded);
+      memcpy(work, expanded, count * sizeof(double));
+    }
+    //the interpolated samples come in groups of 2^stages. They are added to the
+    //  pending samples, from which exactly chunk samples are output.
+    memcpy(&f->pending[f->num_pending], work, count * sizeof(double));
+    f->num_pending += count;
+    if (adding) {
+      for (i = 0; i < chunk; i++) output[pos+i] += pluginData->run_adding_gain * (LADSPA_Data)f->pending[i];
+    } else {
+      for (i = 0; i < chunk; i++) output[pos+i] = (LADSPA_Data)f->pending[i];
+    }
+    f->num_pending -= chunk;
+    memmove(f->pending, &f->pending[chunk], f->num_pending * sizeof(double));
+  }
+  if (silence_gate_closing(&pluginData->gate)) clear_multirate(f);
+} //end processACDfMultirate
+
+
+static inline void meterACDfMultirate(ACDfMultirate *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, &pluginData->output, sample_count, state, start);
+}
+
+
+void runACDfMultirate(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfMultirate *)instance)->meter);
+  processACDfMultirate((ACDfMultirate *)instance, sample_count, false);
+  meterACDfMultirate((ACDfMultirate *)instance, sample_count, start);
+} //end runACDfMultirate
+
+
+void runAddingACDfMultirate(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((ACDfMultirate *)instance)->meter);
+  processACDfMultirate((ACDfMultirate *)instance, sample_count, true);
+  meterACDfMultirate((ACDfMultirate *)instance, sample_count, start);
+} //end runAddingACDfMultirate
+
+
+void setRunAddingGainACDfMultirate(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((ACDfMultirate *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupACDfMultirate(LADSPA_Handle instance) {
+  ACDfMultirate *pluginData = (ACDfMultirate *)instance;
+  telemetry_close(&pluginData->meter);
+  free(pluginData->filter);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    ACDfMultirateDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+
+    if (ACDfMultirateDescriptor) {
+      std::string text;
+      //plugin descriptor info
+      ACDfMultirateDescriptor->UniqueID = 5235;
+      ACDfMultirateDescriptor->Label = "ACDfMultirate";
+      ACDfMultirateDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "ACDfMultirate v1.0: Active Crossover Designer LADSPA filters at a reduced sample rate";
+      ACDfMultirateDescriptor->Name = strdup(text.c_str());
+      ACDfMultirateDescriptor->Maker = "Charlie Laub, 2025";
+      ACDfMultirateDescriptor->Copyright = "GPLv3";
+      ACDfMultirateDescriptor->PortCount = ACDfR_NUM_PORTS;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(ACDfR_NUM_PORTS,sizeof(LADSPA_PortDescriptor));
+      ACDfMultirateDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(ACDfR_NUM_PORTS,sizeof(LADSPA_PortRangeHint));
+      ACDfMultirateDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(ACDfR_NUM_PORTS, sizeof(char*));
+      ACDfMultirateDescriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the section parameters, named e.g. type1, fp1, ... qz8
+      describe_ACDf_section_ports(port_descriptors, port_names, port_range_hints);
+
+      //port = ACDfR_STAGES
+      port_descriptors[ACDfR_STAGES] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "stages";
+      port_names[ACDfR_STAGES] = strdup(text.c_str());
+      port_range_hints[ACDfR_STAGES].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_MIDDLE;
+      port_range_hints[ACDfR_STAGES].LowerBound = 1;
+      port_range_hints[ACDfR_STAGES].UpperBound = ACDfR_MAX_STAGES;
+
+      //port = ACDfR_REJECTION
+      port_descriptors[ACDfR_REJECTION] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "rejection";
+      port_names[ACDfR_REJECTION] = strdup(text.c_str());
+      port_range_hints[ACDfR_REJECTION].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_MIDDLE;
+      port_range_hints[ACDfR_REJECTION].LowerBound = 60;
+      port_range_hints[ACDfR_REJECTION].UpperBound = 140;
+
+      //port = ACDfR_INPUT
+      port_descriptors[ACDfR_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+      text = "Input";
+      port_names[ACDfR_INPUT] = strdup(text.c_str());
+
+      //port = ACDfR_OUTPUT
+      port_descriptors[ACDfR_OUTPUT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+      text = "Output";
+      port_names[ACDfR_OUTPUT] = strdup(text.c_str());
+
+      //port = ACDfR_LATENCY
+      port_descriptors[ACDfR_LATENCY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      text = "latency";
+      port_names[ACDfR_LATENCY] = strdup(text.c_str());
+      port_range_hints[ACDfR_LATENCY].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[ACDfR_LATENCY].LowerBound = 0;
+
+      ACDfMultirateDescriptor->activate = activateACDfMultirate;
+      ACDfMultirateDescriptor->cleanup = cleanupACDfMultirate;
+      ACDfMultirateDescriptor->connect_port = connectPortACDfMultirate;
+      ACDfMultirateDescriptor->deactivate = NULL;
+      ACDfMultirateDescriptor->instantiate = instantiateACDfMultirate;
+      ACDfMultirateDescriptor->run = runACDfMultirate;
+      ACDfMultirateDescriptor->run_adding = runAddingACDfMultirate;
+      ACDfMultirateDescriptor->set_run_adding_gain = setRunAddingGainACDfMultirate;
+    }
+  }
+  ~Initialiser() {
+    if (ACDfMultirateDescriptor) {
+      free((LADSPA_PortDescriptor *)ACDfMultirateDescriptor->PortDescriptors);
+      free((char **)ACDfMultirateDescriptor->PortNames);
+      free((LADSPA_PortRangeHint *)ACDfMultirateDescriptor->PortRangeHints);
+      free(ACDfMultirateDescriptor);
+    }
+  }
+} g_theInitialiser;
@@ -0,0 +1,444 @@
+/* ACDf filter coefficient calculation, version 4.1
+   Copyright 2019-2024 Charlie Laub, GPLv3 
+
+  This file holds the calculation of the discrete time transfer function
+  coefficients for all ACDf filter types. It is shared by the ACDf plugin and
+  by the other members of the ACDf family (e.g. ACDfCascade) so that every
+  plugin produces exactly the same filter for the same set of parameters.
+  The second part of the file describes the "sections" used by the plugins 
+  that hold several ACDf filters within one instance.
+  See ACDf.cpp for license information.
+*/
+
+#ifndef ACDF_COEFFICIENTS_H
+#define ACDF_COEFFICIENTS_H
+
+#include <stdio.h>
+#include <string.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include "silence_gate.h"
+
+#define DENORMALKILLER 1.e-15 //1.e-15 corresponds to -300dB
+  //DENORMALKILLER is added to the filter output to avoid denormal values that
+  //may slow the calculation on some hardware when very small values are
+  //produced. The added signal is a square wave at the Nyquist frequency.
+
+
+typedef struct {
+  double b0, b1, b2, a1, a2;
+} ACDf_coefficients;
+
+
+static int calculate_ACDf_coefficients(const LADSPA_Data ftype, const LADSPA_Data fpolarity,
+                                       const LADSPA_Data dBgain, double Fp, double Qp,
+                                       double Fz, double Qz, const LADSPA_Data SR,
+                                       ACDf_coefficients *c) {
+  //calculates the normalized discrete time TF coefficients for the filter
+  //  described by the ACDf parameters and stores them in c. The filter type
+  //  that was used is returned. A type of -1 indicates invalid parameters, in 
+  //  which case the coefficients return silence.
+  double Aa0, Aa1, Aa2, Ab0, Ab1, Ab2; //analog TF coefficients
+  double Da0, Da1, Da2, Db0, Db1, Db2; //IIR digital TF coefficients
+  double voltage_gain; //voltage gain
+  double p_voltage_gain; //voltage gain including polarity
+  double Wp, Wz, Wp2, Wz2; //for analog radian frequency
+  bool reversed_polarity = false;
+  const double K = 2.0*SR;
+  const double K2 = K*K;
+  int type; //type is used internally to select filter
+  type = roundf((float)ftype); //round to nearest integer 
+  voltage_gain = pow(10.0,(0.05*dBgain)); //calculate voltage gain
+  p_voltage_gain = voltage_gain;
+  //if reverse polarity is indicated, multiply p_voltage_gain by -1
+  if (( fpolarity < -0.99 ) && (fpolarity > -1.01 )) {
+    p_voltage_gain *= -1.0;
+    reversed_polarity = true;
+  }
+  //error checking :
+  //  if  parameters are invalid, return silence.
+  if ( (Fp > 0.5*SR) || (Fp < 0) ) type = -1;
+  if ( (Fz > 0.5*SR) || (Fz < 0) ) type = -1;
+
+  //calculate analog domain radian frequencies  
+  Wp = 2.0*M_PI*Fp;
+  Wz = 2.0*M_PI*Fz;
+  //apply pre-warping 
+  Wp = K*tan( Wp/K );
+  Wz = K*tan( Wz/K );
+  //calculate square of pre-warped radian frequencies
+  Wp2 = Wp*Wp;
+  Wz2 = Wz*Wz;
+  //initialize these analog coefficient values to zero
+  Aa1 = Aa2 = Ab0 = Ab1 = Ab2 = 0.0;
+  //and initialize the value of analog coefficient a0 to 1.0
+  Aa0 = 1.0;
+
+  switch (type) {
+  case 0: //gain with polarity
+    Ab0 = p_voltage_gain;
+  break;
+  case 1: //1st order lowpass filter with gain and polarity
+    Ab0 = Wp * p_voltage_gain;
+    Aa1 = 1.0;
+    Aa0 = Wp;
+  break;
+  case 2: //1st order highpass filter with gain and polarity
+    Ab1 = p_voltage_gain;
+    Aa1 = 1.0;
+    Aa0 = Wp;
+  break;
+  case 3: //first order all-pass filter with polarity 
+    Ab1 = 1.0;
+    Ab0 = -1.0 * Wp;
+    if (reversed_polarity) {
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    } 
+    Aa1 = 1.0;
+    Aa0 = Wp;
+  break;
+  case 4: //1st order low shelf specified by gain, polarity, and Fp (used as center of shelf)
+    Wz = Wp * pow(10.0,(dBgain/40.0));
+    Wp = Wp2 / Wz;
+    Ab1 = 1.0;
+    Ab0 = Wz;
+    if (reversed_polarity) {
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    }
+    Aa1 = 1.0;
+    Aa0 = Wp;
+  break;
+  case 5: //1st order high shelf specified by gain, polarity, and Fp (used as center of shelf) 
+    Wz = Wp * pow(10.0,(-dBgain/40.0));
+    Wp = Wp2 / Wz;
+    Ab1 = 1.0 * voltage_gain;
+    Ab0 = Wz * voltage_gain;
+    if (reversed_polarity) {
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    }
+    Aa1 = 1.0;
+    Aa0 = Wp;
+  break;
+  case 21: //2nd order lowpass filter specified by gain, polarity, Fp, Qp
+    Ab0 = p_voltage_gain * Wp2;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 22: //2nd order highpass filter specified by gain, polarity, Fp, Qp
+    Ab2 = p_voltage_gain;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 23: //2nd order all-pass filter specified by gain, polarity, Fp, Qp
+    Ab2 = 1.0;
+    Ab1 = -1.0 * Wp/Qp;
+    Ab0 = Wp2;
+    if (reversed_polarity) {
+      Ab2 *= -1.0;
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    }
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 24: //2nd order low shelf specified by Fp (used as center of shelf), gain, Q, and polarity
+    Qz = Qp;
+    Wz = Wp * pow(10.0,(dBgain/80.0));
+    Wp = Wp2 / Wz;
+    Wz2 = Wz*Wz;
+    Wp2 = Wp*Wp;
+    Ab2 = 1.0;
+    Ab1 = Wz/Qz;
+    Ab0 = Wz2;
+    if (reversed_polarity) {
+      Ab2 *= -1.0;
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    }
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 25: //2nd order high shelf specified by Fp (used as center of shelf), gain, Q, and polarity
+    Qz = Qp;
+    Wz = Wp * pow(10.0,(-dBgain/80.0));
+    Wp = Wp2 / Wz;
+    Wz2 = Wz*Wz;
+    Wp2 = Wp*Wp;
+    Ab2 = voltage_gain;
+    Ab1 = voltage_gain * Wz/Qz;
+    Ab0 = voltage_gain * Wz2;
+    if (reversed_polarity) {
+      Ab2 *= -1.0;
+      Ab1 *= -1.0;
+      Ab0 *= -1.0;
+    }
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 26: //parametric EQ specified by gain, Fp, Qp 
+    Ab2 = 1.0;
+    Ab1 = Wp/Qp;
+    if (voltage_gain > 1.0) Ab1 *= voltage_gain;
+    Ab0 = Wp2;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    if (voltage_gain < 1.0) Aa1 /= voltage_gain;
+    Aa0 = Wp2;
+  break;
+  case 27: //2nd order notch specified by gain, polarity, Fp, Qp, Fz
+    Ab2 = p_voltage_gain;
+    Ab0 = p_voltage_gain * Wz2;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 28: //general biquadratic filter specified by gain, polarity, Fp,Qp,Fz,Qz 
+    Ab2 = p_voltage_gain;
+    Ab1 = p_voltage_gain * Wz/Qz;
+    Ab0 = p_voltage_gain * Wz2;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  case 77: //2nd order notch specified by polarity, Fp, Qp, Fz and with automatic gain calculation
+    // NOTE: the gain is automatically calculated for the LowPass notch and
+    //    any gain supplied by the user is ignored. Gain is calcualted as follows:
+    //     when Fp < Fz gain in dB = 40 log10( tan(p Fp/SR) / tan(p Fz/SR) )
+    //     otherwise gain in dB = 0
+    p_voltage_gain = voltage_gain = 1.0;
+    if (Fp < Fz ) {
+      //This is a Lowpass Notch filter. Calculate voltage gain and p_voltage_gain such that the
+      //  passband level is set to 0dB
+      voltage_gain = tan( M_PI*Fp/SR) / tan( M_PI*Fz/SR );
+      voltage_gain = pow( voltage_gain, 2.0 ); //calculate voltage gain
+      p_voltage_gain = voltage_gain;
+    }
+    //if reverse polarity is indicated, multiply p_voltage_gain by -1
+    if (( fpolarity < -0.99 ) && (fpolarity > -1.01 )) {
+      p_voltage_gain *= -1.0;
+      reversed_polarity = true;
+    }
+    //calculate analog TF coefficients
+    Ab2 = p_voltage_gain;
+    Ab0 = p_voltage_gain * Wz2;
+    Aa2 = 1.0;
+    Aa1 = Wp/Qp;
+    Aa0 = Wp2;
+  break;
+  default:
+    //if user supplies a non-supported filter type silence is returned
+    type = -1;
+  } //end switch-case, done computing analog transfer function coefficients 
+
+  //convert continuous time TF coefficients to discrete time TF coefficients
+  //  and put into normalized form: 
+  if (type < 1) { 
+    Da0 = 1.0;
+    Db0 = p_voltage_gain; //type = 0: gain stage
+    if (type == -1 ) {
+      //type is set to -1 if undefined types are supplied by user
+      Db0 = 0.0; //returns silence
+    }
+    Db1 = Db2 = Da1 = Da2 = 0.0; //not used for type = 0 or type = -1
+    //above is already in normalized form because Da0 = 1.0
+  } else if (type < 20 ) {
+    //convert the 1st order analog TF coefficients to z^-1 domain TF coefficients
+    Db0 = Ab1*K + Ab0;
+    Db1 = Ab0 - Ab1*K;
+    Da0 = Aa1*K + Aa0;
+    Da1 = Aa0 - Aa1*K;
+    //convert to normalized form by dividing thru by Da0:
+    Db0 /= Da0;
+    Db1 /= Da0;
+    Da1 /= Da0;
+    Da2 = 0.0; //not used, set to zero
+    Db2 = 0.0; //not used, set to zero
+  } else {
+    //convert the 2nd order analog TF coefficients to z^-1 domain TF coefficients
+    Db0 = Ab2*K2 + Ab1*K + Ab0;
+    Db1 = 2.0*Ab0 - 2.0*Ab2*K2;
+    Db2 = Ab2*K2 - Ab1*K + Ab0;
+    Da0 = Aa2*K2 + Aa1*K + Aa0;
+    Da1 = 2.0*Aa0 - 2.0*Aa2*K2;
+    Da2 = Aa2*K2 - Aa1*K + Aa0;
+    //convert to normalized form by dividing thru by Da0:
+    Db0 /= Da0;
+    Db1 /= Da0;
+    Db2 /= Da0;
+    Da1 /= Da0;
+    Da2 /= Da0;
+  }
+  //for all types, copy results into the coefficient structure
+  c->b0 = Db0;
+  c->b1 = Db1;
+  c->b2 = Db2;
+  c->a1 = Da1;
+  c->a2 = Da2;
+  return type;
+} //end calculate_ACDf_coefficients
+
+
+/* ====== STATE VARIABLE FILTER FORM ============================================== */
+//The transfer function of an ACDf filter can also be realized as a trapezoidal
+//  (topology preserving transform) state variable filter. This structure is much
+//  less sensitive to rounding than the direct form when the poles are close to 
+//  z=1, i.e. for filters far below the sample rate, and is used for calculating 
+//  such filters in single precision. The coefficients are found by mapping the 
+//  discrete time TF back to the "analog" domain of the bilinear transform,
+//  p = (1-1/z)/(1+1/z), where the filter has the form:
+//    H(p) = (m0*p^2 + (m1+k*m0)*g*p + (m2+m0)*g^2) / (p^2 + k*g*p + g^2)
+//  g is the prewarped frequency of the poles and k is 1/Q. The state variable
+//  filter then produces the highpass, bandpass and lowpass responses, which are 
+//  mixed using m0, m1 and m2. A first order filter is represented by a second 
+//  order one with one pole at z=0 that is cancelled by a zero.
+
+typedef struct {
+  double g, k; //pole frequency (prewarped) and damping
+  double m0, m1, m2; //mixing coefficients for input, bandpass and lowpass
+} ACDf_svf_coefficients;
+
+
+static inline int calculate_ACDf_svf_coefficients(const double b0, const double b1, const double b2,
+                                                  const double a1, const double a2,
+                                                  ACDf_svf_coefficients *s) {
+  //calculates the state variable form of the discrete time TF. Returns 0 if
+  //  the TF has no stable state variable form (unstable poles).
+  const double A2 = 1.0 - a1 + a2;
+  const double A1 = 2.0 * (1.0 - a2);
+  const double A0 = 1.0 + a1 + a2;
+  const double B2 = b0 - b1 + b2;
+  const double B1 = 2.0 * (b0 - b2);
+  const double B0 = b0 + b1 + b2;
+  if ( !(A2 > 0.0)  ||  !(A1 > 0.0)  ||  !(A0 > 0.0) ) return 0;
+  s->g = sqrt(A0 / A2);
+  s->k = A1 / (A2 * s->g);
+  s->m0 = B2 / A2;
+  s->m1 = B1 / (A2 * s->g) - s->k * s->m0;
+  s->m2 = B0 / A0 - s->m0;
+  return 1;
+} //end calculate_ACDf_svf_coefficients
+
+
+
+/* ====== MULTI-SECTION PLUGINS ================================================== */
+//Plugins such as ACDfCascade hold up to ACDf_MAX_SECTIONS ACDf filters. The
+//  parameters of each section use the ACDf names with the section number
+//  appended (type1, polarity1, ... qz8) and occupy the first ports of the plugin.
+//  The port number is given by section_index * ACDf_PARAMS_PER_SECTION + parameter
+
+#define ACDf_MAX_SECTIONS         8
+#define ACDf_PARAMS_PER_SECTION   7
+#define ACDf_SECTION_PORTS        (ACDf_MAX_SECTIONS * ACDf_PARAMS_PER_SECTION)
+//order of parameters within each section:
+#define ACDf_SECTION_TYPE         0
+#define ACDf_SECTION_POLARITY     1
+#define ACDf_SECTION_GAIN         2
+#define ACDf_SECTION_FP           3
+#define ACDf_SECTION_QP           4
+#define ACDf_SECTION_FZ           5
+#define ACDf_SECTION_QZ           6
+
+
+typedef struct {
+  unsigned int num_sections; //number of sections that must be calculated
+  double gain; //combined gain of all gain-only (type 0) sections
+  double b0[ACDf_MAX_SECTIONS], b1[ACDf_MAX_SECTIONS], b2[ACDf_MAX_SECTIONS];
+  double a1[ACDf_MAX_SECTIONS], a2[ACDf_MAX_SECTIONS];
+} ACDf_sections;
+
+
+static inline void calculate_ACDf_section_list(LADSPA_Data * const *params, const unsigned int count,
+                                               const LADSPA_Data SR, ACDf_sections *s) {
+  //calculates the coefficients of count (at most ACDf_MAX_SECTIONS) sections from
+  //  the section parameter ports. Gain stages, including sections left at their
+  //  default values, do not need a section of their own and are folded into the 
+  //  overall gain. Invalid sections have a gain of zero and therefore silence the
+  //  output, as ACDf does.
+  LADSPA_Data * const *p;
+  ACDf_coefficients c;
+  unsigned int n;
+  s->num_sections = 0;
+  s->gain = 1.0;
+  for (unsigned int section = 0; section < count; section++) {
+    p = &params[section * ACDf_PARAMS_PER_SECTION];
+    if (calculate_ACDf_coefficients(*p[ACDf_SECTION_TYPE], *p[ACDf_SECTION_POLARITY],
+                                    *p[ACDf_SECTION_GAIN], *p[ACDf_SECTION_FP], *p[ACDf_SECTION_QP],
+                                    *p[ACDf_SECTION_FZ], *p[ACDf_SECTION_QZ], SR, &c) < 1) {
+      s->gain *= c.b0;
+      continue;
+    }
+    n = s->num_sections;
+    s->b0[n] = c.b0;
+    s->b1[n] = c.b1;
+    s->b2[n] = c.b2;
+    s->a1[n] = c.a1;
+    s->a2[n] = c.a2;
+    s->num_sections++;
+  }
+} //end calculate_ACDf_section_list
+
+
+static inline void calculate_ACDf_sections(LADSPA_Data * const *params, const LADSPA_Data SR,
+                                           ACDf_sections *s) {
+  //calculates the coefficients of all ACDf_MAX_SECTIONS sections
+  calculate_ACDf_section_list(params, ACDf_MAX_SECTIONS, SR, s);
+} //end calculate_ACDf_sections
+
+
+static inline unsigned long ACDf_sections_hold(const ACDf_sections *s) {
+  //returns the hold time of the silence gate for the sections in series: the
+  //  number of silent input samples after which all of them have decayed
+  unsigned long hold = 0;
+  for (unsigned int n = 0; n < s->num_sections; n++) {
+    hold = add_silence_hold(hold, silence_decay_samples(s->a1[n], s->a2[n]));
+  }
+  return hold;
+} //end ACDf_sections_hold
+
+
+static inline void describe_ACDf_section_list(LADSPA_PortDescriptor *port_descriptors, char **port_names,
+                                             LADSPA_PortRangeHint *port_range_hints, const unsigned long first_port,
+                                             const unsigned int count, const char *prefix) {
+  //sets the descriptor, range hints and name of the ports for count sections,
+  //  beginning at first_port. The names are the ACDf names preceded by prefix 
+  //  and followed by the section number. The range hints are the same as those
+  //  used by ACDf.
+  const char *param_names[ACDf_PARAMS_PER_SECTION] = { "type", "polarity", "db", "fp", "qp", "fz", "qz" };
+  const LADSPA_PortRangeHintDescriptor param_hints[ACDf_PARAMS_PER_SECTION] = {
+    LADSPA_HINT_DEFAULT_0, LADSPA_HINT_DEFAULT_1, LADSPA_HINT_DEFAULT_0, LADSPA_HINT_DEFAULT_440,
+    LADSPA_HINT_DEFAULT_1, LADSPA_HINT_DEFAULT_440, LADSPA_HINT_DEFAULT_1 };
+  const LADSPA_Data param_lower[ACDf_PARAMS_PER_SECTION] = { 0, -1, -99, 1, 0.01, 1, 0.01 };
+  const LADSPA_Data param_upper[ACDf_PARAMS_PER_SECTION] = { 77, 1, 99, 100000, 100, 100000, 100 };
+  char text[32];
+  unsigned long port;
+  for (unsigned int section = 0; section < count; section++) {
+    for (unsigned int param = 0; param < ACDf_PARAMS_PER_SECTION; param++) {
+      port = first_port + section * ACDf_PARAMS_PER_SECTION + param;
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      snprintf(text, sizeof(text), "%s%s%u", prefix, param_names[param], section+1);
+      port_names[port] = strdup(text);
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | param_hints[param];
+      port_range_hints[port].LowerBound = param_lower[param];
+      port_range_hints[port].UpperBound = param_upper[param];
+    }
+  }
+} //end describe_ACDf_section_list
+
+
+static inline void describe_ACDf_section_ports(LADSPA_PortDescriptor *port_descriptors, char **port_names,
+                                               LADSPA_PortRangeHint *port_range_hints) {
+  //sets the descriptor, range hints and name of the ports for all sections,
+  //  named type1, polarity1, ... qz8
+  describe_ACDf_section_list(port_descriptors, port_names, port_range_hints, 0, ACDf_MAX_SECTIONS, "");
+} //end describe_ACDf_section_ports
+
+#endif
@@ -0,0 +1,1224 @@
+/* Convolver LADSPA plugin, version 1.0
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Convolver is an FIR filter for GSASysCon. It convolves the input with an
+  impulse response (IR) that is read from a WAV or text file, e.g. a room
+  correction filter or a linear phase crossover filter designed with another
+  program. The plugin has one audio input and 1 to 4 audio outputs, each with
+  its own IR. Each output count has its own plugin label:
+    Convolver1, Convolver2, Convolver3, Convolver4
+  The outputs share the transform of the input, so the bands of a linear
+  phase crossover cost less in one Convolver than in separate ones.
+
+  The convolution is uniformly partitioned and uses the overlap-save method.
+  The IR is divided into partitions of B samples, and the spectrum of each
+  partition (an FFT of size 2B) is calculated when the plugin is activated.
+  The input is collected into blocks of B samples. The spectrum of each block
+  is stored in a frequency domain delay line (FDL) that holds the spectra of
+  as many past blocks as the longest IR has partitions. The output block is
+  the inverse FFT of the sum of the products of the partition spectra with
+  the block spectra in the FDL. This delays the signal by B samples, which is
+  reported by the latency port.
+
+  The cost per sample is one FFT of size 2B for the input plus one for each
+  output, i.e. proportional to log2(B), plus one complex multiplication per
+  partition. When the partition size is chosen automatically (the default),
+  B grows with the length of the IR so that the number of partitions stays
+  the same, and the cost only grows with the logarithm of the number of
+  taps. A smaller partition size can be chosen when a lower latency is more
+  important than the CPU load.
+
+  The zero latency mode (mode = 1) uses partitions of growing size instead
+  (non-uniform partitioning). The first CONV_ZL_HEAD taps are calculated in
+  direct form, sample by sample. The following taps, up to a little more than
+  the host buffer size, are calculated in run with partitions of
+  CONV_ZL_RUN_PARTITION samples, which need no latency because they start at
+  one partition into the IR. The rest of the IR is divided into levels with
+  partitions of 256, 1024, 4096 and 16384 samples. A level with partition
+  size B starts at least 2B and B plus the host buffer size into the IR, so
+  its output block is needed well after the input block is complete, at the
+  earliest in the next call of run. The levels are calculated by background
+  threads (see Convolver_workers.h) in the time between the calls of run, and
+  run picks up the results without waiting. The worst-case margin between the
+  completion of a block and the moment its output is needed, relative to the
+  time available, is reported by the output port margin, and the number of
+  blocks that missed their deadline by the port misses.
+
+  The IR files are found by their number: the IR with number n is the file in
+  one of the directories listed in the environment variable GSASYSCON_IR_PATH
+  whose name is n followed by '_' or '.', with the extension .wav or .txt,
+  e.g. 12_tweeter_linear_phase.wav. See Convolver_usage_notes.txt.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <ctype.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include "Convolver_fft.h"
+#include "Convolver_workers.h"
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "numbered_file.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define CONV_MAX_OUTPUTS           4  //maximum number of outputs
+#define CONV_FIRST_ID           5236  //UniqueID of the first descriptor
+#define CONV_MIN_PARTITION        64  //smallest partition size, in samples
+#define CONV_MAX_PARTITION     32768  //largest partition size, in samples
+#define CONV_AUTO_MIN_PARTITION 1024  //smallest partition size that is chosen automatically
+#define CONV_AUTO_MAX_PARTITION 8192  //largest partition size that is chosen automatically
+#define CONV_AUTO_PARTITIONS       8  //number of partitions of the longest IR, if possible
+#define CONV_MAX_LENGTH      1048576  //longest impulse response, in samples
+#define CONV_MAX_CHANNELS         64  //largest number of channels in an IR file
+#define CONV_MAX_IR_NUMBER      9999  //largest IR file number
+
+//the mode is selected with the mode port at activation:
+#define CONV_MODE_UNIFORM          0  //uniform partitions, latency of one partition
+#define CONV_MODE_ZERO_LATENCY     1  //growing partitions, the long ones calculated in the background
+
+//the partitioning of the zero latency mode:
+#define CONV_ZL_HEAD              64  //taps calculated in direct form
+#define CONV_ZL_RUN_PARTITION     64  //partition size of the taps that follow the head, calculated in run
+#define CONV_ZL_FIRST_PARTITION  256  //partition size of the first background level
+#define CONV_ZL_MAX_PARTITION  16384  //partition size of the last background level
+#define CONV_ZL_GROWTH             4  //ratio of the partition sizes of successive levels
+#define CONV_ZL_BUFFER          1024  //largest host buffer for which the deadlines can be met (GSASysCon uses 1024)
+#define CONV_ZL_SPARE_BLOCKS       4  //blocks in the rings of a level beyond those in flight
+#define CONV_ZL_MAX_LEVELS         4  //number of background levels for the sizes above
+
+//each output has CONV_OUTPUT_PORTS parameters. They occupy the first ports
+//  and are followed by the partition size, the mode, the input, the outputs,
+//  and the latency, margin and misses.
+#define CONV_IR                    0  //number of the IR file, 0 = no IR (a delay of B samples)
+#define CONV_CHANNEL               1  //channel of the IR file
+#define CONV_DB                    2  //gain in dB
+#define CONV_POLARITY              3  //polarity, 1 or -1
+#define CONV_OUTPUT_PORTS          4
+#define CONV_PARTITION(outputs)    ((outputs) * CONV_OUTPUT_PORTS)
+#define CONV_MODE(outputs)         (CONV_PARTITION(outputs) + 1)
+#define CONV_INPUT(outputs)        (CONV_MODE(outputs) + 1)
+#define CONV_OUTPUT(outputs)       (CONV_INPUT(outputs) + 1)
+#define CONV_LATENCY(outputs)      (CONV_OUTPUT(outputs) + (outputs))
+#define CONV_MARGIN(outputs)       (CONV_LATENCY(outputs) + 1)  //output: worst-case compute margin, in percent
+#define CONV_MISSES(outputs)       (CONV_MARGIN(outputs) + 1)   //output: number of missed deadlines
+#define CONV_NUM_PORTS(outputs)    (CONV_MISSES(outputs) + 1)
+
+//one descriptor is created for each number of outputs:
+#define CONV_NUM_DESCRIPTORS 4
+static const unsigned int CONV_outputs[CONV_NUM_DESCRIPTORS] = { 1, 2, 3, 4 };
+static LADSPA_Descriptor *ConvolverDescriptor[CONV_NUM_DESCRIPTORS] = { NULL, NULL, NULL, NULL };
+
+
+typedef struct {
+  unsigned long length; //number of taps of the IR
+  unsigned int num_partitions; //number of partitions of the IR
+  float *hr, *hi; //spectra of the partitions, B values each
+  float *yr, *yi; //sum of the products with the input spectra
+  float *output; //the B output samples of the last block
+} convolver_output;
+
+
+typedef struct {
+  unsigned int partition; //B, the partition size
+  fft_setup fft; //FFT of size 2B
+  unsigned int num_slots; //number of input spectra in the FDL
+  unsigned int head; //slot of the most recent input spectrum
+  unsigned int fill; //number of samples of the current block received so far
+  float *xr, *xi; //the FDL, num_slots input spectra of B values each
+  float *input; //the previous block followed by the current block, 2B samples
+  float *result; //output of the inverse FFT, 2B samples
+  unsigned int num_outputs;
+  convolver_output out[CONV_MAX_OUTPUTS];
+} convolver;
+
+
+typedef struct {
+  worker_task task; //the blocks of this level, see Convolver_workers.h
+  convolver *conv; //uniformly partitioned convolution with this level's part of the IRs
+  void (*kernel)(convolver *); //convolve_block for the instruction set of the plugin
+  unsigned int partition; //B
+  unsigned int ahead; //offset of the level in the IR / B: job j is output as block j + ahead
+  unsigned int ring_size; //number of blocks in the rings
+  unsigned int fill; //number of samples of the current input block received so far
+  long block; //number of the current input block
+  float *input; //ring of input blocks, written by run
+  float *output[CONV_MAX_OUTPUTS]; //ring of output blocks, written by the job
+  std::atomic<long> *job_of; //the job that wrote each output block
+  int64_t *done_time; //when each output block was completed
+  const float *current[CONV_MAX_OUTPUTS]; //the output block that is played, NULL if missing
+} background_level;
+
+
+typedef struct {
+  float *head[CONV_MAX_OUTPUTS]; //the first CONV_ZL_HEAD taps of each IR
+  float *history; //CONV_ZL_HEAD - 1 past input samples followed by the current chunk
+  float *work[CONV_MAX_OUTPUTS]; //output of the current chunk
+  convolver *conv; //the partitions calculated in run, NULL if the IRs are short
+  unsigned int fill; //position in the run partition
+  unsigned int num_levels;
+  background_level *level[CONV_ZL_MAX_LEVELS];
+  double margin; //smallest fraction of the budget left when a block was needed
+  unsigned long jobs, misses, jobs_in_run; //statistics of the background levels
+} zero_latency;
+
+
+typedef struct {
+  LADSPA_Data *output_params[CONV_MAX_OUTPUTS][CONV_OUTPUT_PORTS];
+  LADSPA_Data *partition;
+  LADSPA_Data *mode;
+  LADSPA_Data rate;
+  unsigned int num_outputs;
+  int isa; //instruction set used for the FFT and the FDL, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  convolver *conv; //NULL until the plugin has been activated, or in zero latency mode
+  zero_latency *zl; //the zero latency mode, NULL in the uniform mode
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the outputs in shared memory, see telemetry.h
+  LADSPA_Data *input;
+  LADSPA_Data *output[CONV_MAX_OUTPUTS];
+  LADSPA_Data *latency; //output: the partition size in the uniform mode, in samples
+  LADSPA_Data *margin; //output: worst-case compute margin of the background levels, in percent
+  LADSPA_Data *misses; //output: number of blocks that missed their deadline
+} Convolver;
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  if (index < CONV_NUM_DESCRIPTORS) return ConvolverDescriptor[index];
+  return NULL;
+}
+
+
+LADSPA_Handle instantiateConvolver(const LADSPA_Descriptor *descriptor,
+                                   unsigned long sample_rate) {
+  Convolver *pluginData = (Convolver *)calloc(1, sizeof(Convolver));
+  if (!pluginData) return NULL;
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->num_outputs = CONV_outputs[descriptor->UniqueID - CONV_FIRST_ID];
+  pluginData->isa = select_cpu_isa(descriptor->Label);
+  pluginData->run_adding_gain = 1.0;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortConvolver(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  Convolver *pluginData = (Convolver *)instance;
+  const unsigned int N = pluginData->num_outputs;
+  if (port < CONV_PARTITION(N)) {
+    pluginData->output_params[port / CONV_OUTPUT_PORTS][port % CONV_OUTPUT_PORTS] = data;
+  } else if (port == CONV_PARTITION(N)) {
+    pluginData->partition = data;
+  } else if (port == CONV_MODE(N)) {
+    pluginData->mode = data;
+  } else if (port == CONV_INPUT(N)) {
+    pluginData->input = data;
+  } else if (port < CONV_LATENCY(N)) {
+    pluginData->output[port - CONV_OUTPUT(N)] = data;
+  } else if (port == CONV_LATENCY(N)) {
+    pluginData->latency = data;
+  } else if (port == CONV_MARGIN(N)) {
+    pluginData->margin = data;
+  } else if (port == CONV_MISSES(N)) {
+    pluginData->misses = data;
+  }
+}
+
+
+/************************ reading the IR files ************************/
+
+static unsigned long read_le(const unsigned char *bytes, const unsigned int count) {
+  //returns the unsigned little endian integer with count bytes
+  unsigned long value = 0;
+  for (unsigned int i = count; i-- > 0; ) value = (value << 8) | bytes[i];
+  return value;
+}
+
+
+static float *read_wav_file(const char *path, const unsigned int channel, unsigned long *length,
+                            unsigned long *file_rate, string *error) {
+  //reads one channel (starting at 1) of a WAV file with 16, 24 or 32 bit
+  //  integer or 32 or 64 bit floating point samples. Returns the samples, which
+  //  the caller must free, or NULL.
+  FILE *file = fopen(path, "rb");
+  unsigned char header[12], chunk[8], format[40], *frames = NULL;
+  unsigned long chunk_size, data_size = 0, frame_size, num_frames, i;
+  unsigned int format_tag = 0, channels = 0, bits = 0, bytes;
+  float *samples = NULL;
+  bool have_format = false, have_data = false;
+
+  if (!file) {
+    *error = "the file cannot be opened";
+    return NULL;
+  }
+  if (fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+    *error = "the file is not a WAV file";
+    fclose(file);
+    return NULL;
+  }
+  //walk through the chunks until the format and the data have been found
+  while (!have_data && fread(chunk, 1, 8, file) == 8) {
+    chunk_size = read_le(chunk + 4, 4);
+    if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+      memset(format, 0, sizeof(format));
+      if (fread(format, 1, (chunk_size < sizeof(format)) ? chunk_size : sizeof(format), file) < 16) break;
+      if (chunk_size > sizeof(format)) fseek(file, chunk_size - sizeof(format), SEEK_CUR);
+      if (chunk_size & 1) fseek(file, 1, SEEK_CUR);
+      format_tag = read_le(format, 2);
+      channels = read_le(format + 2, 2);
+      *file_rate = read_le(format + 4, 4);
+      bits = read_le(format + 14, 2);
+      //WAVE_FORMAT_EXTENSIBLE: the format is the first part of the sub format
+      if (format_tag == 0xFFFE && chunk_size >= 26) format_tag = read_le(format + 24, 2);
+      have_format = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      data_size = chunk_size;
+      have_data = true;
+    } else {
+      fseek(file, chunk_size + (chunk_size & 1), SEEK_CUR); //chunks are padded to an even size
+    }
+  }
+  bytes = bits / 8;
+  if (!have_format || !have_data) {
+    *error = "the WAV file has no format or no data";
+  } else if (!((format_tag == 1 && (bits == 16 || bits == 24 || bits == 32)) ||
+               (format_tag == 3 && (bits == 32 || bits == 64)))) {
+    *error = "the sample format of the WAV file is not supported. Use 16, 24 or 32 bit integer or 32 or 64 bit floating point samples";
+  } else if (channel < 1 || channel > channels) {
+    *error = "the WAV file has only " + to_string(channels) + " channel(s)";
+  } else {
+    frame_size = (unsigned long)channels * bytes;
+    num_frames = data_size / frame_size;
+    if (num_frames > CONV_MAX_LENGTH) num_frames = CONV_MAX_LENGTH;
+    frames = (unsigned char *)malloc(num_frames * frame_size + 1);
+    samples = (float *)malloc((num_frames ? num_frames : 1) * sizeof(float));
+    if (!frames || !samples) {
+      *error = "out of memory";
+    } else {
+      //a truncated file is read as far as it goes
+      num_frames = fread(frames, frame_size, num_frames, file);
+      for (i = 0; i < num_frames; i++) {
+        const unsigned char *p = frames + i * frame_size + (channel - 1) * bytes;
+        if (format_tag == 3 && bits == 32) {
+          uint32_t u = read_le(p, 4);
+          float f;
+          memcpy(&f, &u, 4);
+          samples[i] = f;
+        } else if (format_tag == 3) {
+          uint64_t u = (uint64_t)read_le(p, 4) | ((uint64_t)read_le(p + 4, 4) << 32);
+          double d;
+          memcpy(&d, &u, 8);
+          samples[i] = (float)d;
+        } else {
+          //sign extend the integer and scale it to +/-1.0
+          int32_t s = (int32_t)(read_le(p, bytes) << (32 - bits));
+          samples[i] = (float)((double)s / 2147483648.0);
+        }
+      }
+      *length = num_frames;
+      free(frames);
+      fclose(file);
+      return samples;
+    }
+  }
+  free(frames);
+  free(samples);
+  fclose(file);
+  return NULL;
+} //end read_wav_file
+
+
+static float *read_text_file(const char *path, const unsigned int channel, unsigned long *length, string *error) {
+  //reads one column (starting at 1) of a text file with one sample per line
+  //  and one column per channel. The columns are separated by spaces, tabs,
+  //  commas or semicolons. Lines that do not start with a number, e.g. the
+  //  header written by REW, are skipped. Returns the samples, which the caller
+  //  must free, or NULL.
+  FILE *file = fopen(path, "r");
+  char line[1024], *p, *next;
+  unsigned long count = 0, capacity = 0;
+  unsigned int column;
+  float *samples = NULL, *larger;
+  double value;
+
+  if (!file) {
+    *error = "the file cannot be opened";
+    return NULL;
+  }
+  while (fgets(line, sizeof(line), file) && count < CONV_MAX_LENGTH) {
+    p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (!isdigit((unsigned char)*p) && *p != '-' && *p != '+' && *p != '.') continue;
+    //find the column
+    value = 0.0;
+    for (column = 1; column <= channel; column++) {
+      while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';') p++;
+      value = strtod(p, &next);
+      if (next == p) break;
+      p = next;
+    }
+    if (column <= channel) {
+      *error = "line " + to_string(count + 1) + " of the data has fewer than " + to_string(channel) + " column(s)";
+      free(samples);
+      fclose(file);
+      return NULL;
+    }
+    if (count == capacity) {
+      capacity = capacity ? 2 * capacity : 4096;
+      larger = (float *)realloc(samples, capacity * sizeof(float));
+      if (!larger) {
+        *error = "out of memory";
+        free(samples);
+        fclose(file);
+        return NULL;
+      }
+      samples = larger;
+    }
+    samples[count++] = (float)value;
+  }
+  fclose(file);
+  if (count == 0) {
+    *error = "the file contains no samples";
+    free(samples);
+    return NULL;
+  }
+  *length = count;
+  return samples;
+} //end read_text_file
+
+
+static float *load_IR(const unsigned int number, const unsigned int channel, const LADSPA_Data rate,
+                      unsigned long *length, string *description) {
+  //reads the IR with the given number. Returns NULL and describes the problem
+  //  if it cannot be read.
+  string path = find_numbered_file(number, ".wav", ".txt"), error;
+  unsigned long file_rate = 0;
+  float *samples;
+
+  if (path.empty()) {
+    *description = "ERROR: no file for IR " + to_string(number) + " was found in " + numbered_file_path();
+    return NULL;
+  }
+  if (has_extension(path.c_str(), ".wav")) {
+    samples = read_wav_file(path.c_str(), channel, length, &file_rate, &error);
+  } else {
+    samples = read_text_file(path.c_str(), channel, length, &error);
+  }
+  if (!samples) {
+    *description = "ERROR: " + path + " cannot be used: " + error;
+    return NULL;
+  }
+  *description = path + " channel " + to_string(channel) + ", " + to_string(*length) + " taps";
+  if (file_rate && file_rate != (unsigned long)rate) {
+    *description += " (WARNING: the file is for " + to_string(file_rate) + "Hz, not " + to_string((unsigned long)rate) + "Hz)";
+  }
+  return samples;
+} //end load_IR
+
+
+/************************ the convolution ************************/
+
+static unsigned int choose_partition(const LADSPA_Data requested, const unsigned int num_outputs,
+                                     const unsigned long *lengths) {
+  //returns the partition size. A requested size is rounded up to a power of 2.
+  //  Otherwise the smallest size that divides the longest IR into at most
+  //  CONV_AUTO_PARTITIONS partitions is chosen, within the limits for the
+  //  automatic choice. Convolver_bench shows that the FFT is most efficient
+  //  from 1024 to 2048 samples and that the multiplications of the FDL become
+  //  more expensive than the FFTs beyond about 8 partitions.
+  unsigned long longest = 0;
+  unsigned int B;
+  if (requested >= 1.0) {
+    for (B = CONV_MIN_PARTITION; B < requested && B < CONV_MAX_PARTITION; B *= 2);
+    return B;
+  }
+  for (unsigned int n = 0; n < num_outputs; n++) {
+    if (lengths[n] > longest) longest = lengths[n];
+  }
+  for (B = CONV_AUTO_MIN_PARTITION; B < CONV_AUTO_MAX_PARTITION; B *= 2) {
+    if ((longest + B - 1) / B <= CONV_AUTO_PARTITIONS) break;
+  }
+  return B;
+} //end choose_partition
+
+
+static void free_convolver(convolver *c) {
+  if (!c) return;
+  for (unsigned int n = 0; n < CONV_MAX_OUTPUTS; n++) {
+    free(c->out[n].hr); free(c->out[n].hi);
+    free(c->out[n].yr); free(c->out[n].yi);
+    free(c->out[n].output);
+  }
+  free(c->xr); free(c->xi);
+  free(c->input); free(c->result);
+  free_fft(&c->fft);
+  free(c);
+}
+
+
+static void clear_convolver(convolver *c) {
+  //clears the FDL and the input and output blocks
+  const unsigned int B = c->partition;
+  memset(c->xr, 0, (unsigned long)c->num_slots * B * sizeof(float));
+  memset(c->xi, 0, (unsigned long)c->num_slots * B * sizeof(float));
+  memset(c->input, 0, 2 * B * sizeof(float));
+  for (unsigned int n = 0; n < c->num_outputs; n++) memset(c->out[n].output, 0, B * sizeof(float));
+  c->head = 0;
+  c->fill = 0;
+}
+
+
+static convolver *create_convolver(const unsigned int B, const unsigned int num_outputs,
+                                   float * const *ir, const unsigned long *lengths) {
+  //allocates the convolver and calculates the spectra of the partitions of
+  //  each IR. The IR must include the gain and polarity. Returns NULL if out
+  //  of memory.
+  convolver *c = (convolver *)calloc(1, sizeof(convolver));
+  unsigned int n, p, slots = 1;
+  if (!c) return NULL;
+  c->partition = B;
+  c->num_outputs = num_outputs;
+  for (n = 0; n < num_outputs; n++) {
+    c->out[n].length = lengths[n];
+    c->out[n].num_partitions = (lengths[n] + B - 1) / B;
+    if (c->out[n].num_partitions > slots) slots = c->out[n].num_partitions;
+  }
+  c->num_slots = slots;
+  if (!init_fft(&c->fft, 2 * B)) {
+    free(c);
+    return NULL;
+  }
+  c->xr = fft_alloc((unsigned long)slots * B);
+  c->xi = fft_alloc((unsigned long)slots * B);
+  c->input = fft_alloc(2 * B);
+  c->result = fft_alloc(2 * B);
+  bool ok = c->xr && c->xi && c->input && c->result;
+  for (n = 0; n < num_outputs && ok; n++) {
+    convolver_output *o = &c->out[n];
+    o->hr = fft_alloc((unsigned long)o->num_partitions * B);
+    o->hi = fft_alloc((unsigned long)o->num_partitions * B);
+    o->yr = fft_alloc(B);
+    o->yi = fft_alloc(B);
+    o->output = fft_alloc(B);
+    ok = o->hr && o->hi && o->yr && o->yi && o->output;
+    //the spectrum of each partition of the IR, zero padded to 2B samples. The
+    //  scaling of the FFT (see Convolver_fft.h) is included.
+    for (p = 0; p < o->num_partitions && ok; p++) {
+      unsigned long start = (unsigned long)p * B, count = lengths[n] - start;
+      if (count > B) count = B;
+      memset(c->result, 0, 2 * B * sizeof(float));
+      for (unsigned long i = 0; i < count; i++) c->result[i] = ir[n][start + i] / (8.0f * B);
+      real_fft(&c->fft, c->result, o->hr + (unsigned long)p * B, o->hi + (unsigned long)p * B);
+    }
+  }
+  if (!ok) {
+    free_convolver(c);
+    return NULL;
+  }
+  clear_convolver(c);
+  return c;
+} //end create_convolver
+
+
+CPU_KERNEL_INLINE void multiply_accumulate(float *yr, float *yi, const float *xr, const float *xi,
+                                           const float *hr, const float *hi, const unsigned int B) {
+  //adds the product of the spectra x and h to y. Bin 0 holds the two real
+  //  bins DC and Nyquist (see Convolver_fft.h) and is corrected afterwards.
+  const float y0r = yr[0] + xr[0] * hr[0], y0i = yi[0] + xi[0] * hi[0];
+  vNf vxr, vxi, vhr, vhi, vyr, vyi;
+  for (unsigned int k = 0; k < B; k += FFT_LANES) {
+    memcpy(&vxr, xr + k, sizeof(vNf)); memcpy(&vxi, xi + k, sizeof(vNf));
+    memcpy(&vhr, hr + k, sizeof(vNf)); memcpy(&vhi, hi + k, sizeof(vNf));
+    memcpy(&vyr, yr + k, sizeof(vNf)); memcpy(&vyi, yi + k, sizeof(vNf));
+    vyr += vxr * vhr - vxi * vhi;
+    vyi += vxr * vhi + vxi * vhr;
+    memcpy(yr + k, &vyr, sizeof(vNf)); memcpy(yi + k, &vyi, sizeof(vNf));
+  }
+  yr[0] = y0r;
+  yi[0] = y0i;
+} //end multiply_accumulate
+
+
+CPU_KERNEL_INLINE void convolve_block(convolver *c) {
+  //calculates the next output block of each output from the input block that
+  //  has just been completed
+  const unsigned int B = c->partition;
+  const unsigned long stride = B;
+  unsigned int n, p, slot;
+
+  real_fft(&c->fft, c->input, c->xr + c->head * stride, c->xi + c->head * stride);
+  memcpy(c->input, c->input + B, B * sizeof(float));
+  for (n = 0; n < c->num_outputs; n++) {
+    convolver_output *o = &c->out[n];
+    memset(o->yr, 0, B * sizeof(float));
+    memset(o->yi, 0, B * sizeof(float));
+    //partition p is multiplied with the spectrum of the input block p blocks ago
+    slot = c->head;
+    for (p = 0; p < o->num_partitions; p++) {
+      multiply_accumulate(o->yr, o->yi, c->xr + slot * stride, c->xi + slot * stride,
+                          o->hr + p * stride, o->hi + p * stride, B);
+      slot = (slot ? slot : c->num_slots) - 1;
+    }
+    //overlap-save: only the second half of the result is valid
+    real_ifft(&c->fft, o->yr, o->yi, c->result);
+    memcpy(o->output, c->result + B, B * sizeof(float));
+  }
+  c->head = (c->head + 1 < c->num_slots) ? c->head + 1 : 0;
+} //end convolve_block
+//compile convolve_block for each instruction set. See cpu_dispatch.h
+CPU_DISPATCH_KERNELS(convolve_block, (convolver *c), (c))
+
+
+/************************ the zero latency mode ************************/
+
+static unsigned int zero_latency_layout(const unsigned long longest, unsigned long *offset, unsigned int *size) {
+  //divides the IR into the background levels. Level l has partitions of
+  //  size[l] samples and starts at tap offset[l], which is at least two
+  //  partitions and one partition plus the host buffer into the IR: the jobs
+  //  then have at least one partition of time and end after the call of run
+  //  that submits them. A level ends where the next one starts, the last one
+  //  at the end of the IR. The partitions calculated in run end at offset[0].
+  //  Returns the number of levels.
+  unsigned int B = CONV_ZL_FIRST_PARTITION, num_levels = 0;
+  unsigned long earliest;
+  for (;;) {
+    earliest = (B > CONV_ZL_BUFFER) ? 2 * B : B + CONV_ZL_BUFFER;
+    //the previous level has at least one partition
+    if (num_levels && earliest < offset[num_levels - 1] + size[num_levels - 1]) {
+      earliest = offset[num_levels - 1] + size[num_levels - 1];
+    }
+    offset[num_levels] = ((earliest + B - 1) / B) * B;
+    size[num_levels] = B;
+    if (offset[num_levels] >= longest) break;
+    num_levels++;
+    if (B == CONV_ZL_MAX_PARTITION || num_levels == CONV_ZL_MAX_LEVELS) break;
+    B *= CONV_ZL_GROWTH;
+  }
+  return num_levels;
+} //end zero_latency_layout
+
+
+static long process_background_job(worker_task *task, const long job) {
+  //calculates the output block of a level from the input block with the
+  //  number job. Called by a worker, or by run when no worker has started
+  //  the job in time. Returns the next job.
+  background_level *level = (background_level *)task;
+  const unsigned int B = level->partition;
+  const unsigned long slot = job % level->ring_size;
+  convolver *c = level->conv;
+
+  memcpy(c->input + B, level->input + slot * B, B * sizeof(float));
+  //run overwrites this input block after it has submitted job + ring_size - 1
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (task->submitted.load(std::memory_order_relaxed) >= job + level->ring_size) {
+    //far too late, the input is lost: start again with the next block
+    clear_convolver(c);
+    return task->submitted.load(std::memory_order_acquire);
+  }
+  level->kernel(c);
+  for (unsigned int n = 0; n < c->num_outputs; n++) {
+    memcpy(level->output[n] + slot * B, c->out[n].output, B * sizeof(float));
+  }
+  level->done_time[slot] = worker_clock();
+  level->job_of[slot].store(job, std::memory_order_release);
+  return job + 1;
+} //end process_background_job
+
+
+static void start_output_block(zero_latency *z, background_level *level) {
+  //called by run at the start of each output block of a level. Finds the
+  //  output of the job for this block and updates the statistics.
+  const long job = level->block - level->ahead;
+  const unsigned long slot = (job >= 0) ? job % level->ring_size : 0;
+  double margin = 0.0;
+  unsigned int n;
+
+  for (n = 0; n < CONV_MAX_OUTPUTS; n++) level->current[n] = NULL;
+  if (job < 0) return; //before the first block
+  z->jobs++;
+  if (level->job_of[slot].load(std::memory_order_acquire) != job) {
+    //no worker has started the job in time: calculate it now. This does not
+    //  wait; if a worker is busy with the job, it is missed.
+    if (!claim_job(&level->task, job)) {
+      z->misses++;
+      z->margin = 0.0;
+      return;
+    }
+    finish_job(&level->task, job, process_background_job(&level->task, job));
+    z->jobs_in_run++;
+  } else {
+    const int64_t now = worker_clock();
+    const int64_t submitted = level->task.submit_time[slot].load(std::memory_order_relaxed);
+    if (now > submitted) margin = (double)(now - level->done_time[slot]) / (double)(now - submitted);
+  }
+  if (margin < z->margin) z->margin = margin;
+  for (n = 0; n < level->conv->num_outputs; n++) level->current[n] = level->output[n] + slot * level->partition;
+} //end start_output_block
+
+
+static void free_background_level(background_level *level) {
+  if (!level) return;
+  unregister_task(&level->task);
+  free_convolver(level->conv);
+  free(level->input);
+  for (unsigned int n = 0; n < CONV_MAX_OUTPUTS; n++) free(level->output[n]);
+  free(level->job_of);
+  free(level->done_time);
+  free(level->task.submit_time);
+  free(level);
+}
+
+
+static background_level *create_background_level(const unsigned int B, const unsigned long offset,
+                                                 const unsigned int num_outputs, float * const *ir,
+                                                 const unsigned long *lengths, const unsigned long end,
+                                                 const LADSPA_Data rate, const int isa) {
+  //creates the level for the taps from offset to end of the IRs. Returns NULL if out of memory.
+  background_level *level = (background_level *)calloc(1, sizeof(background_level));
+  float *segment[CONV_MAX_OUTPUTS];
+  unsigned long segment_length[CONV_MAX_OUTPUTS];
+  unsigned int n, i;
+  if (!level) return NULL;
+  for (n = 0; n < num_outputs; n++) {
+    segment[n] = ir[n] ? ir[n] + offset : NULL;
+    segment_length[n] = (lengths[n] > offset) ? ((lengths[n] < end) ? lengths[n] : end) - offset : 0;
+  }
+  level->partition = B;
+  level->ahead = offset / B;
+  level->ring_size = level->ahead + CONV_ZL_SPARE_BLOCKS;
+  level->kernel = CPU_DISPATCH_SELECT(convolve_block, isa);
+  level->conv = create_convolver(B, num_outputs, segment, segment_length);
+  level->input = fft_alloc((unsigned long)level->ring_size * B);
+  level->job_of = (std::atomic<long> *)calloc(level->ring_size, sizeof(std::atomic<long>));
+  level->done_time = (int64_t *)calloc(level->ring_size, sizeof(int64_t));
+  level->task.submit_time = (std::atomic<int64_t> *)calloc(level->ring_size, sizeof(std::atomic<int64_t>));
+  bool ok = level->conv && level->input && level->job_of && level->done_time && level->task.submit_time;
+  for (n = 0; n < num_outputs && ok; n++) {
+    level->output[n] = fft_alloc((unsigned long)level->ring_size * B);
+    ok = (level->output[n] != NULL);
+  }
+  if (!ok) {
+    free_background_level(level);
+    return NULL;
+  }
+  for (i = 0; i < level->ring_size; i++) level->job_of[i].store(-1);
+  level->task.submitted.store(0);
+  level->task.claimed.store(0);
+  level->task.completed.store(0);
+  level->task.ring_size = level->ring_size;
+  //the output of job j is needed at the start of block j + ahead
+  level->task.budget = (int64_t)(1.e9 * (level->ahead - 1) * B / rate);
+  level->task.process = process_background_job;
+  return level;
+} //end create_background_level
+
+
+static void free_zero_latency(zero_latency *z) {
+  if (!z) return;
+  for (unsigned int l = 0; l < z->num_levels; l++) free_background_level(z->level[l]);
+  for (unsigned int n = 0; n < CONV_MAX_OUTPUTS; n++) {
+    free(z->head[n]);
+    free(z->work[n]);
+  }
+  free(z->history);
+  free_convolver(z->conv);
+  free(z);
+}
+
+
+static zero_latency *create_zero_latency(const unsigned int num_outputs, float * const *ir,
+                                         const unsigned long *lengths, const LADSPA_Data rate,
+                                         const int isa, unsigned int *num_threads) {
+  //divides the IRs into the head, the partitions calculated in run and the
+  //  background levels. Returns NULL if out of memory.
+  zero_latency *z = (zero_latency *)calloc(1, sizeof(zero_latency));
+  unsigned long offset[CONV_ZL_MAX_LEVELS + 1], longest = 0, run_end, i;
+  unsigned int size[CONV_ZL_MAX_LEVELS + 1], n, l;
+  float *segment[CONV_MAX_OUTPUTS];
+  unsigned long segment_length[CONV_MAX_OUTPUTS];
+  bool ok, registered = true;
+
+  *num_threads = 0;
+  if (!z) return NULL;
+  for (n = 0; n < num_outputs; n++) {
+    if (lengths[n] > longest) longest = lengths[n];
+  }
+  z->num_levels = zero_latency_layout(longest, offset, size);
+  z->margin = 1.0;
+  //the head, zero padded to CONV_ZL_HEAD taps
+  z->history = fft_alloc(CONV_ZL_HEAD + CONV_ZL_RUN_PARTITION + FFT_LANES);
+  ok = (z->history != NULL);
+  for (n = 0; n < num_outputs && ok; n++) {
+    z->head[n] = fft_alloc(CONV_ZL_HEAD);
+    z->work[n] = fft_alloc(CONV_ZL_RUN_PARTITION + FFT_LANES);
+    ok = z->head[n] && z->work[n];
+    for (i = 0; ok && i < CONV_ZL_HEAD && i < lengths[n]; i++) z->head[n][i] = ir[n][i];
+  }
+  //the partitions calculated in run start one partition into the IR, so they
+  //  need no latency
+  run_end = z->num_levels ? offset[0] : longest;
+  if (ok && run_end > CONV_ZL_HEAD) {
+    for (n = 0; n < num_outputs; n++) {
+      segment[n] = ir[n] ? ir[n] + CONV_ZL_HEAD : NULL;
+      segment_length[n] = (lengths[n] > CONV_ZL_HEAD) ? ((lengths[n] < run_end) ? lengths[n] : run_end) - CONV_ZL_HEAD : 0;
+    }
+    z->conv = create_convolver(CONV_ZL_RUN_PARTITION, num_outputs, segment, segment_length);
+    ok = (z->conv != NULL);
+  }
+  for (l = 0; l < z->num_levels && ok; l++) {
+    z->level[l] = create_background_level(size[l], offset[l], num_outputs, ir, lengths,
+                                          (l + 1 < z->num_levels) ? offset[l + 1] : longest, rate, isa);
+    ok = (z->level[l] != NULL);
+  }
+  if (!ok) {
+    free_zero_latency(z);
+    return NULL;
+  }
+  //without threads or table entries, run calculates the jobs when they are due
+  if (z->num_levels) *num_threads = start_workers();
+  for (l = 0; l < z->num_levels && *num_threads; l++) registered = register_task(&z->level[l]->task) && registered;
+  if (!registered) *num_threads = 0;
+  return z;
+} //end create_zero_latency
+
+
+CPU_KERNEL_INLINE void direct_form_head(zero_latency *z, const unsigned int num_outputs, const unsigned int count) {
+  //calculates the output of the first CONV_ZL_HEAD taps for the count samples
+  //  of the current chunk, FFT_LANES output samples at a time
+  const float *x = z->history + CONV_ZL_HEAD - 1;
+  const vNf zero = {};
+  vNf sum, input;
+  for (unsigned int n = 0; n < num_outputs; n++) {
+    const float *h = z->head[n];
+    for (unsigned int i = 0; i < count; i += FFT_LANES) {
+      sum = zero;
+      for (unsigned int k = 0; k < CONV_ZL_HEAD; k++) {
+        memcpy(&input, x + i - k, sizeof(vNf));
+        sum += h[k] * input;
+      }
+      memcpy(z->work[n] + i, &sum, sizeof(vNf));
+    }
+  }
+} //end direct_form_head
+//compile direct_form_head for each instruction set. See cpu_dispatch.h
+CPU_DISPATCH_KERNELS(direct_form_head, (zero_latency *z, const unsigned int num_outputs, const unsigned int count),
+                     (z, num_outputs, count))
+
+
+void activateConvolver(LADSPA_Handle instance) {
+  Convolver *pluginData = (Convolver *)instance;
+  const unsigned int N = pluginData->num_outputs;
+  float *ir[CONV_MAX_OUTPUTS];
+  unsigned long lengths[CONV_MAX_OUTPUTS], hold = 0;
+  string description[CONV_MAX_OUTPUTS];
+  unsigned int n, number, channel, B, l, num_threads = 0;
+  const int mode = (int)(*(pluginData->mode) + 0.5);
+  double gain;
+
+  free_convolver(pluginData->conv);
+  pluginData->conv = NULL;
+  free_zero_latency(pluginData->zl);
+  pluginData->zl = NULL;
+  for (n = 0; n < N; n++) {
+    LADSPA_Data **params = pluginData->output_params[n];
+    number = (unsigned int)*(params[CONV_IR]);
+    channel = (unsigned int)*(params[CONV_CHANNEL]);
+    gain = pow(10.0, 0.05 * *(params[CONV_DB]));
+    if (*(params[CONV_POLARITY]) < 0.0) gain = -gain;
+    if (number == 0) {
+      //no IR: the output is the input, delayed by the partition size in the
+      //  uniform mode
+      ir[n] = (float *)malloc(sizeof(float));
+      if (ir[n]) ir[n][0] = 1.0f;
+      lengths[n] = 1;
+      description[n] = "no IR, delay only";
+    } else {
+      ir[n] = load_IR(number, channel, pluginData->rate, &lengths[n], &description[n]);
+    }
+    if (!ir[n]) {
+      //an output without a usable IR is silent
+      lengths[n] = 0;
+      continue;
+    }
+    for (unsigned long i = 0; i < lengths[n]; i++) ir[n][i] *= (float)gain;
+    if (lengths[n] > hold) hold = lengths[n];
+  }
+  if (mode == CONV_MODE_ZERO_LATENCY) {
+    zero_latency *z = create_zero_latency(N, ir, lengths, pluginData->rate, pluginData->isa, &num_threads);
+    pluginData->zl = z;
+    B = CONV_ZL_RUN_PARTITION;
+    for (l = 0; z && l < z->num_levels; l++) B = z->level[l]->partition;
+  } else {
+    B = choose_partition(*(pluginData->partition), N, lengths);
+    pluginData->conv = create_convolver(B, N, ir, lengths);
+  }
+  for (n = 0; n < N; n++) free(ir[n]);
+  //the gate closes when the last non-silent input has left the FDL and the output block
+  set_silence_gate(&pluginData->gate, hold + 2 * B);
+
+  //report the topology
+  if (mode == CONV_MODE_ZERO_LATENCY) {
+    zero_latency *z = pluginData->zl;
+    cout << "Convolver" << N << ": zero latency, " << CONV_ZL_HEAD << " taps in direct form";
+    if (z && z->conv) cout << ", partitions of " << CONV_ZL_RUN_PARTITION << " samples in run";
+    for (l = 0; z && l < z->num_levels; l++) {
+      cout << ", " << z->level[l]->partition << " from tap " << (unsigned long)z->level[l]->ahead * z->level[l]->partition;
+    }
+    if (z && z->num_levels) {
+      if (num_threads) cout << " on " << num_threads << " background thread(s)";
+      else cout << " (ERROR: no background threads, run calculates all partitions)";
+    }
+    cout << endl;
+  } else {
+    cout << "Convolver" << N << ": partition size " << B << " samples, latency " << B << " samples (";
+    cout << fixed << setprecision(1) << 1000.0 * B / pluginData->rate << "ms)" << endl;
+  }
+  for (n = 0; n < N; n++) {
+    cout << "   output " << n+1 << ": " << description[n];
+    if (pluginData->conv && lengths[n]) cout << ", " << pluginData->conv->out[n].num_partitions << " partition(s)";
+    cout << endl;
+  }
+  if (!pluginData->conv && !pluginData->zl) cout << "Convolver" << N << ": ERROR: out of memory. The outputs are silent." << endl;
+
+  char label[TELEMETRY_LABEL_SIZE], info[TELEMETRY_INFO_SIZE];
+  int length = snprintf(info, sizeof(info), "IR");
+  for (n = 0; n < N && length < (int)sizeof(info); n++) {
+    length += snprintf(info + length, sizeof(info) - length, " %u", (unsigned int)*(pluginData->output_params[n][CONV_IR]));
+  }
+  if (length < (int)sizeof(info)) {
+    if (mode == CONV_MODE_ZERO_LATENCY) snprintf(info + length, sizeof(info) - length, ", zero latency");
+    else snprintf(info + length, sizeof(info) - length, ", partition %u", B);
+  }
+  snprintf(label, sizeof(label), "Convolver%u", N);
+  telemetry_open(&pluginData->meter, label, info, N, pluginData->rate);
+}
+
+
+static inline void processZeroLatency(Convolver *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input in the zero latency mode. The input is processed in
+  //  chunks that end at the boundaries of the run partitions, which are also
+  //  the boundaries of the blocks of the background levels.
+  zero_latency *z = pluginData->zl;
+  convolver *c = z->conv;
+  const LADSPA_Data *input = pluginData->input;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  const unsigned int N = pluginData->num_outputs;
+  unsigned long pos, chunk, i;
+  unsigned int n, l;
+  void (*kernel)(convolver *) = CPU_DISPATCH_SELECT(convolve_block, pluginData->isa);
+  void (*head)(zero_latency *, const unsigned int, const unsigned int) = CPU_DISPATCH_SELECT(direct_form_head, pluginData->isa);
+
+  if (pluginData->latency) *(pluginData->latency) = 0;
+  if (pluginData->margin) *(pluginData->margin) = (LADSPA_Data)(100.0 * z->margin);
+  if (pluginData->misses) *(pluginData->misses) = (LADSPA_Data)z->misses;
+  //while the gate is closed the processing stands still. The state holds
+  //  the silent input from before, so it needs no clearing and the workers
+  //  can finish their jobs undisturbed.
+  if (silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count)) {
+    for (n = 0; n < N; n++) write_silence(pluginData->output[n], sample_count, adding);
+    return;
+  }
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > CONV_ZL_RUN_PARTITION - z->fill) chunk = CONV_ZL_RUN_PARTITION - z->fill;
+    //the input goes to the direct form, the run partitions and each level
+    memcpy(z->history + CONV_ZL_HEAD - 1, input + pos, chunk * sizeof(LADSPA_Data));
+    if (c) memcpy(c->input + CONV_ZL_RUN_PARTITION + z->fill, input + pos, chunk * sizeof(LADSPA_Data));
+    for (l = 0; l < z->num_levels; l++) {
+      background_level *level = z->level[l];
+      float *block = level->input + (unsigned long)(level->block % level->ring_size) * level->partition;
+      memcpy(block + level->fill, input + pos, chunk * sizeof(LADSPA_Data));
+    }
+    //the output is the sum of all parts
+    head(z, N, chunk);
+    for (n = 0; n < N; n++) {
+      float *sum = z->work[n];
+      LADSPA_Data *output = pluginData->output[n] + pos;
+      if (c) {
+        const float *block = c->out[n].output + z->fill;
+        for (i = 0; i < chunk; i++) sum[i] += block[i];
+      }
+      for (l = 0; l < z->num_levels; l++) {
+        const float *block = z->level[l]->current[n];
+        if (!block) continue;
+        block += z->level[l]->fill;
+        for (i = 0; i < chunk; i++) sum[i] += block[i];
+      }
+      if (adding) {
+        for (i = 0; i < chunk; i++) output[i] += gain * sum[i];
+      } else {
+        memcpy(output, sum, chunk * sizeof(LADSPA_Data));
+      }
+    }
+    //advance
+    memmove(z->history, z->history + chunk, (CONV_ZL_HEAD - 1) * sizeof(float));
+    z->fill += chunk;
+    if (z->fill == CONV_ZL_RUN_PARTITION) {
+      if (c) kernel(c);
+      z->fill = 0;
+    }
+    for (l = 0; l < z->num_levels; l++) {
+      background_level *level = z->level[l];
+      level->fill += chunk;
+      if (level->fill < level->partition) continue;
+      submit_job(&level->task, level->block, worker_clock());
+      level->block++;
+      level->fill = 0;
+      start_output_block(z, level);
+    }
+  }
+} //end processZeroLatency
+
+
+static inline void processConvolver(Convolver *pluginData, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffers
+  //  (run) or is multiplied by the run_adding gain and added to them (run_adding).
+  convolver *c = pluginData->conv;
+  const LADSPA_Data *input = pluginData->input;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  unsigned long pos, chunk, i;
+  unsigned int n;
+  void (*kernel)(convolver *) = CPU_DISPATCH_SELECT(convolve_block, pluginData->isa);
+
+  if (pluginData->zl) {
+    processZeroLatency(pluginData, sample_count, adding);
+    return;
+  }
+  if (pluginData->latency) *(pluginData->latency) = c ? (LADSPA_Data)c->partition : 0;
+  if (pluginData->margin) *(pluginData->margin) = 100;
+  if (pluginData->misses) *(pluginData->misses) = 0;
+  if (!c || silence_gate_skip(&pluginData->gate, is_silent(input, sample_count), sample_count)) {
+    for (n = 0; n < pluginData->num_outputs; n++) write_silence(pluginData->output[n], sample_count, adding);
+    return;
+  }
+  //the input is collected into blocks of B samples. The output is taken from
+  //  the output blocks that were calculated from the previous input block.
+  //  The input is read before any output is written, so the host may use the
+  //  same buffer for the input and an output.
+  for (pos = 0; pos < sample_count; pos += chunk) {
+    chunk = sample_count - pos;
+    if (chunk > c->partition - c->fill) chunk = c->partition - c->fill;
+    memcpy(c->input + c->partition + c->fill, input + pos, chunk * sizeof(LADSPA_Data));
+    for (n = 0; n < c->num_outputs; n++) {
+      const float *block = c->out[n].output + c->fill;
+      LADSPA_Data *output = pluginData->output[n] + pos;
+      if (adding) {
+        for (i = 0; i < chunk; i++) output[i] += gain * block[i];
+      } else {
+        memcpy(output, block, chunk * sizeof(LADSPA_Data));
+      }
+    }
+    c->fill += chunk;
+    if (c->fill == c->partition) {
+      kernel(c);
+      c->fill = 0;
+    }
+  }
+  if (silence_gate_closing(&pluginData->gate)) clear_convolver(c);
+} //end processConvolver
+
+
+static inline void meterConvolver(Convolver *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, pluginData->output, sample_count, state, start);
+}
+
+
+void runConvolver(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((Convolver *)instance)->meter);
+  processConvolver((Convolver *)instance, sample_count, false);
+  meterConvolver((Convolver *)instance, sample_count, start);
+} //end runConvolver
+
+
+void runAddingConvolver(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((Convolver *)instance)->meter);
+  processConvolver((Convolver *)instance, sample_count, true);
+  meterConvolver((Convolver *)instance, sample_count, start);
+} //end runAddingConvolver
+
+
+void setRunAddingGainConvolver(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((Convolver *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupConvolver(LADSPA_Handle instance) {
+  Convolver *pluginData = (Convolver *)instance;
+  zero_latency *z = pluginData->zl;
+  if (z && z->jobs) {
+    //report the statistics of the background levels
+    cout << "Convolver" << pluginData->num_outputs << ": " << z->jobs << " blocks calculated in the background, ";
+    cout << z->jobs_in_run << " of them in run, " << z->misses << " missed the deadline, worst-case margin ";
+    cout << fixed << setprecision(0) << 100.0 * z->margin << "%" << endl;
+  }
+  telemetry_close(&pluginData->meter);
+  free_convolver(pluginData->conv);
+  free_zero_latency(z);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    LADSPA_Descriptor *descriptor;
+    unsigned int N;
+    unsigned long num_ports, port;
+
+    for (unsigned int index = 0; index < CONV_NUM_DESCRIPTORS; index++) {
+      ConvolverDescriptor[index] = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+      descriptor = ConvolverDescriptor[index];
+      if (!descriptor) continue;
+      std::string text;
+      N = CONV_outputs[index];
+      num_ports = CONV_NUM_PORTS(N);
+      //plugin descriptor info
+      descriptor->UniqueID = CONV_FIRST_ID + index;
+      text = "Convolver" + to_string(N);
+      descriptor->Label = strdup(text.c_str());
+      descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "Convolver v1.0: partitioned FFT convolution (FIR filter) with " + to_string(N) + " output(s)";
+      descriptor->Name = strdup(text.c_str());
+      descriptor->Maker = "Charlie Laub, 2025";
+      descriptor->Copyright = "GPLv3";
+      descriptor->PortCount = num_ports;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
+      descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
+      descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(num_ports, sizeof(char*));
+      descriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the parameters of each output, named ir1, channel1, db1, polarity1, ir2, ...
+      for (unsigned int n = 0; n < N; n++) {
+        port = n * CONV_OUTPUT_PORTS + CONV_IR;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "ir" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+        port_range_hints[port].LowerBound = 0;
+        port_range_hints[port].UpperBound = CONV_MAX_IR_NUMBER;
+
+        port = n * CONV_OUTPUT_PORTS + CONV_CHANNEL;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "channel" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_1;
+        port_range_hints[port].LowerBound = 1;
+        port_range_hints[port].UpperBound = CONV_MAX_CHANNELS;
+
+        port = n * CONV_OUTPUT_PORTS + CONV_DB;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "db" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0;
+        port_range_hints[port].LowerBound = -99;
+        port_range_hints[port].UpperBound = 99;
+
+        port = n * CONV_OUTPUT_PORTS + CONV_POLARITY;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "polarity" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_1;
+        port_range_hints[port].LowerBound = -1;
+        port_range_hints[port].UpperBound = 1;
+      }
+
+      //port = CONV_PARTITION, 0 chooses the partition size automatically
+      port = CONV_PARTITION(N);
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("partition");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[port].LowerBound = 0;
+      port_range_hints[port].UpperBound = CONV_MAX_PARTITION;
+
+      //port = CONV_MODE, 0 = uniform partitions, 1 = zero latency
+      port = CONV_MODE(N);
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("mode");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[port].LowerBound = CONV_MODE_UNIFORM;
+      port_range_hints[port].UpperBound = CONV_MODE_ZERO_LATENCY;
+
+      //audio ports, named Input and Output1 ... OutputN
+      port = CONV_INPUT(N);
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+      port_names[port] = strdup("Input");
+      for (unsigned int n = 0; n < N; n++) {
+        port = CONV_OUTPUT(N) + n;
+        port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+        text = "Output" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+      }
+
+      //port = CONV_LATENCY
+      port = CONV_LATENCY(N);
+      port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("latency");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[port].LowerBound = 0;
+
+      //port = CONV_MARGIN
+      port = CONV_MARGIN(N);
+      port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("margin");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE;
+      port_range_hints[port].LowerBound = 0;
+      port_range_hints[port].UpperBound = 100;
+
+      //port = CONV_MISSES
+      port = CONV_MISSES(N);
+      port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("misses");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[port].LowerBound = 0;
+
+      descriptor->activate = activateConvolver;
+      descriptor->cleanup = cleanupConvolver;
+      descriptor->connect_port = connectPortConvolver;
+      descriptor->deactivate = NULL;
+      descriptor->instantiate = instantiateConvolver;
+      descriptor->run = runConvolver;
+      descriptor->run_adding = runAddingConvolver;
+      descriptor->set_run_adding_gain = setRunAddingGainConvolver;
+    }
+  }
+  ~Initialiser() {
+    stop_workers();
+    for (unsigned int index = 0; index < CONV_NUM_DESCRIPTORS; index++) {
+      if (ConvolverDescriptor[index]) {
+        free((LADSPA_PortDescriptor *)ConvolverDescriptor[index]->PortDescriptors);
+        free((char **)ConvolverDescriptor[index]->PortNames);
+        free((LADSPA_PortRangeHint *)ConvolverDescriptor[index]->PortRangeHints);
+        free(ConvolverDescriptor[index]);
+      }
+    }
+  }
+} g_theInitialiser;
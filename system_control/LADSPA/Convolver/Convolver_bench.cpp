@@ -0,0 +1,305 @@
+/* Convolver_bench
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Measures the CPU time used by the Convolver LADSPA plugin for impulse
+  responses with 4k, 16k and 64k taps, for several partition sizes and for the
+  partition size that the plugin chooses itself. For comparison, the time of a
+  direct form FIR filter (a dot product per sample) is measured as well, and
+  the time of one Convolver4 with four IRs is compared to four Convolver1.
+  The times are given in milliseconds per second of audio at 48kHz, i.e. in
+  tenths of a percent of one CPU core, using the GSASysCon buffer size of
+  1024 samples.
+  The zero latency mode is measured with IRs of 1 and 3 seconds at 96kHz. The
+  buffers are passed to the plugin in real time, as by a sound card, so that
+  the background threads work as they would in GSASysCon. The time used by
+  run and the CPU time of the whole process (run plus the background threads)
+  are given, together with the worst-case margin and the missed deadlines.
+
+  Build and run it from the Convolver directory with:
+    make bench
+  The plugin is loaded from ./Convolver.so. The IRs are written to a temporary
+  directory as WAV files. Set GSASYSCON_ISA (see ../common/cpu_dispatch.h) to
+  measure a particular instruction set.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+#define BENCH_RATE         48000  //sample rate
+#define BENCH_BUFFER        1024  //samples per run, as in GSASysCon
+#define BENCH_SECONDS         10  //seconds of audio per measurement
+#define BENCH_FIR_SECONDS      1  //seconds of audio for the direct form FIR
+#define BENCH_ZL_RATE      96000  //sample rate of the zero latency measurement
+#define BENCH_ZL_SECONDS       8  //seconds of audio per zero latency measurement, in real time
+
+static const unsigned long bench_taps[3] = { 4096, 16384, 65536 };
+static const unsigned int bench_partitions[4] = { 256, 1024, 4096, 0 }; //0 = automatic
+static const unsigned int bench_zl_seconds[2] = { 1, 3 }; //IR lengths of the zero latency measurement
+
+
+static unsigned int noise_state = 12345;
+static float noise() {
+  //uniform noise between -1 and 1
+  noise_state = noise_state * 1664525u + 1013904223u;
+  return (float)((int)(noise_state >> 8) - (1 << 23)) / (float)(1 << 23);
+}
+
+
+static double seconds(const clockid_t clock = CLOCK_MONOTONIC) {
+  struct timespec t;
+  clock_gettime(clock, &t);
+  return t.tv_sec + 1.e-9 * t.tv_nsec;
+}
+
+
+static void write_le(FILE *file, const unsigned long value, const unsigned int bytes) {
+  for (unsigned int i = 0; i < bytes; i++) fputc((value >> (8 * i)) & 0xFF, file);
+}
+
+
+static bool write_IR(const string &path, const float *ir, const unsigned long taps, const unsigned long rate) {
+  //writes the IR as a mono WAV file with 32 bit floating point samples
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) return false;
+  fwrite("RIFF", 1, 4, file); write_le(file, 36 + 4 * taps, 4); fwrite("WAVE", 1, 4, file);
+  fwrite("fmt ", 1, 4, file); write_le(file, 16, 4); write_le(file, 3, 2); write_le(file, 1, 2);
+  write_le(file, rate, 4); write_le(file, 4 * rate, 4); write_le(file, 4, 2); write_le(file, 32, 2);
+  fwrite("data", 1, 4, file); write_le(file, 4 * taps, 4);
+  fwrite(ir, sizeof(float), taps, file);
+  fclose(file);
+  return true;
+}
+
+
+static const LADSPA_Descriptor *find_plugin(void *library, const char *label) {
+  LADSPA_Descriptor_Function descriptor_function = (LADSPA_Descriptor_Function)dlsym(library, "ladspa_descriptor");
+  const LADSPA_Descriptor *descriptor;
+  if (!descriptor_function) return NULL;
+  for (unsigned long index = 0; (descriptor = descriptor_function(index)) != NULL; index++) {
+    if (strcmp(descriptor->Label, label) == 0) return descriptor;
+  }
+  return NULL;
+}
+
+
+static double time_convolver(const LADSPA_Descriptor *descriptor, const unsigned int *ir_numbers,
+                             const unsigned int partition, const unsigned int instances, unsigned int *latency) {
+  //returns the time in ms per second of audio used by the given number of
+  //  instances of the plugin. Each instance gets the IRs in ir_numbers.
+  LADSPA_Handle handle[4];
+  LADSPA_Data controls[4][64], input[BENCH_BUFFER], outputs[4][BENCH_BUFFER];
+  unsigned int output = 0;
+  unsigned long port, pos;
+  double start;
+
+  for (unsigned int i = 0; i < instances; i++) {
+    handle[i] = descriptor->instantiate(descriptor, BENCH_RATE);
+    output = 0;
+    for (port = 0; port < descriptor->PortCount; port++) {
+      LADSPA_PortDescriptor pd = descriptor->PortDescriptors[port];
+      string name = descriptor->PortNames[port];
+      if (LADSPA_IS_PORT_AUDIO(pd)) {
+        descriptor->connect_port(handle[i], port, LADSPA_IS_PORT_INPUT(pd) ? input : outputs[output++]);
+        continue;
+      }
+      controls[i][port] = 0.0;
+      if (name.compare(0, 2, "ir") == 0) controls[i][port] = ir_numbers[atoi(name.c_str() + 2) - 1];
+      if (name.compare(0, 7, "channel") == 0 || name.compare(0, 8, "polarity") == 0) controls[i][port] = 1.0;
+      if (name == "partition") controls[i][port] = partition;
+      descriptor->connect_port(handle[i], port, &controls[i][port]);
+    }
+    descriptor->activate(handle[i]);
+  }
+  for (pos = 0; pos < BENCH_BUFFER; pos++) input[pos] = noise();
+  //one second to settle, then the measurement
+  for (pos = 0; pos < BENCH_RATE; pos += BENCH_BUFFER) {
+    for (unsigned int i = 0; i < instances; i++) descriptor->run(handle[i], BENCH_BUFFER);
+  }
+  start = seconds();
+  for (pos = 0; pos < (unsigned long)BENCH_SECONDS * BENCH_RATE; pos += BENCH_BUFFER) {
+    for (unsigned int i = 0; i < instances; i++) descriptor->run(handle[i], BENCH_BUFFER);
+  }
+  start = seconds() - start;
+  for (port = 0; port < descriptor->PortCount; port++) {
+    if (strcmp(descriptor->PortNames[port], "latency") == 0) *latency = (unsigned int)controls[0][port];
+  }
+  for (unsigned int i = 0; i < instances; i++) descriptor->cleanup(handle[i]);
+  return 1000.0 * start / BENCH_SECONDS;
+} //end time_convolver
+
+
+static double time_zero_latency(const LADSPA_Descriptor *descriptor, const unsigned int ir_number,
+                                double *process_ms, double *margin, unsigned int *misses) {
+  //returns the time in ms per second of audio used by run in the zero latency
+  //  mode. The buffers are passed in real time. process_ms is the CPU time of
+  //  the process, including the background threads.
+  LADSPA_Handle handle = descriptor->instantiate(descriptor, BENCH_ZL_RATE);
+  LADSPA_Data controls[64], input[BENCH_BUFFER], output[BENCH_BUFFER];
+  const unsigned long buffers = (unsigned long)BENCH_ZL_SECONDS * BENCH_ZL_RATE / BENCH_BUFFER;
+  unsigned long port, pos, b;
+  double start, cpu, run_time = 0.0, due;
+  struct timespec t;
+
+  for (port = 0; port < descriptor->PortCount; port++) {
+    LADSPA_PortDescriptor pd = descriptor->PortDescriptors[port];
+    string name = descriptor->PortNames[port];
+    if (LADSPA_IS_PORT_AUDIO(pd)) {
+      descriptor->connect_port(handle, port, LADSPA_IS_PORT_INPUT(pd) ? input : output);
+      continue;
+    }
+    controls[port] = 0.0;
+    if (name == "ir1") controls[port] = ir_number;
+    if (name == "channel1" || name == "polarity1" || name == "mode") controls[port] = 1.0;
+    descriptor->connect_port(handle, port, &controls[port]);
+  }
+  descriptor->activate(handle);
+  for (pos = 0; pos < BENCH_BUFFER; pos++) input[pos] = noise();
+  cpu = seconds(CLOCK_PROCESS_CPUTIME_ID);
+  start = seconds();
+  for (b = 0; b < buffers; b++) {
+    //wait for the sound card
+    due = start + (double)b * BENCH_BUFFER / BENCH_ZL_RATE;
+    t.tv_sec = (time_t)due;
+    t.tv_nsec = (long)(1.e9 * (due - t.tv_sec));
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) != 0);
+    due = seconds();
+    descriptor->run(handle, BENCH_BUFFER);
+    run_time += seconds() - due;
+  }
+  cpu = seconds(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+  for (port = 0; port < descriptor->PortCount; port++) {
+    if (strcmp(descriptor->PortNames[port], "margin") == 0) *margin = controls[port];
+    if (strcmp(descriptor->PortNames[port], "misses") == 0) *misses = (unsigned int)controls[port];
+  }
+  descriptor->cleanup(handle);
+  *process_ms = 1000.0 * cpu / BENCH_ZL_SECONDS;
+  return 1000.0 * run_time / BENCH_ZL_SECONDS;
+} //end time_zero_latency
+
+
+static double time_direct_FIR(const float *ir, const unsigned long taps) {
+  //returns the time in ms per second of audio used by a direct form FIR filter
+  const unsigned long length = (unsigned long)BENCH_FIR_SECONDS * BENCH_RATE;
+  float *x = (float *)calloc(length + taps, sizeof(float));
+  volatile float sink = 0.0f;
+  unsigned long n, k;
+  double start;
+  if (!x) return 0.0;
+  for (n = 0; n < length + taps; n++) x[n] = noise();
+  start = seconds();
+  for (n = 0; n < length; n++) {
+    float y = 0.0f;
+    for (k = 0; k < taps; k++) y += ir[k] * x[n + taps - k];
+    sink = sink + y;
+  }
+  start = seconds() - start;
+  free(x);
+  return 1000.0 * start / BENCH_FIR_SECONDS;
+} //end time_direct_FIR
+
+
+int main() {
+  char directory[] = "/tmp/Convolver_bench_XXXXXX";
+  void *library = dlopen("./Convolver.so", RTLD_NOW | RTLD_LOCAL);
+  const LADSPA_Descriptor *convolver1, *convolver4;
+  float *ir[3];
+  unsigned int latency = 0, numbers[4];
+  unsigned long n, t;
+
+  if (!library) {
+    cout << "cannot load ./Convolver.so: " << dlerror() << endl;
+    return 1;
+  }
+  convolver1 = find_plugin(library, "Convolver1");
+  convolver4 = find_plugin(library, "Convolver4");
+  if (!convolver1 || !convolver4 || !mkdtemp(directory)) {
+    cout << "the plugins or the IR directory are not available" << endl;
+    return 1;
+  }
+  //exponentially decaying noise, numbered 1 to 3
+  for (t = 0; t < 3; t++) {
+    ir[t] = (float *)malloc(bench_taps[t] * sizeof(float));
+    for (n = 0; n < bench_taps[t]; n++) ir[t][n] = noise() * expf(-5.0f * n / bench_taps[t]);
+    write_IR(string(directory) + "/" + to_string(t + 1) + "_bench.wav", ir[t], bench_taps[t], BENCH_RATE);
+  }
+  setenv("GSASYSCON_IR_PATH", directory, 1);
+
+  //the plugin prints its topology when it is activated. Collect the results
+  //  and print them at the end.
+  std::ostringstream report;
+  report << fixed << setprecision(2);
+  report << endl << "ms per second of audio at " << BENCH_RATE << "Hz (= 0.1% of a CPU core), buffer size " << BENCH_BUFFER << endl;
+  report << "   taps   direct FIR";
+  for (unsigned int p = 0; p < 4; p++) {
+    if (bench_partitions[p]) report << "   B=" << setw(5) << bench_partitions[p];
+    else report << "   automatic";
+  }
+  report << endl;
+  for (t = 0; t < 3; t++) {
+    numbers[0] = t + 1;
+    report << setw(7) << bench_taps[t] << setw(13) << time_direct_FIR(ir[t], bench_taps[t]);
+    for (unsigned int p = 0; p < 4; p++) {
+      double ms = time_convolver(convolver1, numbers, bench_partitions[p], 1, &latency);
+      report << setw(10) << ms;
+      if (!bench_partitions[p]) report << " (B=" << latency << ")";
+      else report << "  ";
+    }
+    report << endl;
+  }
+
+  //four outputs with 16k taps each, sharing the FFT of the input
+  numbers[0] = numbers[1] = numbers[2] = numbers[3] = 2;
+  report << endl << "four 16384 tap IRs on one input, B=1024:" << endl;
+  report << "   Convolver4:          " << setw(8) << time_convolver(convolver4, numbers, 1024, 1, &latency) << endl;
+  report << "   4 times Convolver1:  " << setw(8) << time_convolver(convolver1, numbers, 1024, 4, &latency) << endl;
+
+  //zero latency mode, IRs 4 and 5
+  report << endl << "zero latency mode at " << BENCH_ZL_RATE << "Hz, ms per second of audio, in real time:" << endl;
+  report << "   IR length      run   process   worst-case margin   misses" << endl;
+  for (t = 0; t < 2; t++) {
+    const unsigned long taps = (unsigned long)bench_zl_seconds[t] * BENCH_ZL_RATE;
+    float *long_ir = (float *)malloc(taps * sizeof(float));
+    double process_ms = 0.0, margin = 0.0;
+    unsigned int misses = 0;
+    for (n = 0; long_ir && n < taps; n++) long_ir[n] = noise() * expf(-5.0f * n / taps);
+    if (!long_ir || !write_IR(string(directory) + "/" + to_string(t + 4) + "_bench.wav", long_ir, taps, BENCH_ZL_RATE)) continue;
+    free(long_ir);
+    double ms = time_zero_latency(convolver1, t + 4, &process_ms, &margin, &misses);
+    report << setw(10) << bench_zl_seconds[t] << " s" << setw(9) << ms << setw(10) << process_ms;
+    report << setw(19) << margin << "%" << setw(9) << misses << endl;
+  }
+  cout << report.str();
+
+  for (t = 0; t < 5; t++) {
+    unlink((string(directory) + "/" + to_string(t + 1) + "_bench.wav").c_str());
+  }
+  for (t = 0; t < 3; t++) free(ir[t]);
+  rmdir(directory);
+  dlclose(library);
+  return 0;
+}
@@ -0,0 +1,296 @@
+/* Convolver_fft.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  The FFT used by the Convolver LADSPA plugin.
+
+  The convolution only needs the FFT of a real signal with 2*N samples, where
+  N is a power of 2, and the inverse of it. The real signal is packed into a
+  complex signal of N samples (the even samples are the real part and the odd
+  samples the imaginary part), which is transformed by a complex FFT of size N,
+  and the spectrum of the real signal is then separated from the result.
+
+  The complex FFT is a radix-2 Stockham FFT. It does not need a bit reversal
+  and each pass reads and writes the data in order. The real and imaginary
+  parts are held in separate arrays ("split" format), so that the butterflies
+  of a pass can be calculated with vector instructions, FFT_LANES at a time.
+  In the first FFT_SHORT passes the butterflies that are calculated together
+  have different twiddle factors, which are stored for each butterfly, and
+  the results are interleaved with vector shuffles.
+  The passes are kernels in the sense of cpu_dispatch.h: they are inlined into
+  the functions of the plugin that are compiled for each instruction set.
+
+  The N+1 bins of a spectrum are stored in N real and N imaginary values. The
+  bins 0 (DC) and N (Nyquist) are both real; the real part of bin N is kept in
+  the imaginary part of bin 0. The spectra are not normalized: a spectrum
+  calculated by real_fft and transformed back by real_ifft is 4*N times the
+  original signal.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONVOLVER_FFT_H
+#define CONVOLVER_FFT_H
+
+#include <string.h>
+#include <stdlib.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "cpu_dispatch.h"
+
+#define FFT_LANES      8  //number of floats calculated side by side
+#define FFT_SHORT      3  //log2(FFT_LANES), the number of passes with a stride below FFT_LANES
+#define FFT_ALIGNMENT 64  //alignment of all FFT buffers, in bytes
+
+typedef float vNf __attribute__((vector_size(FFT_LANES * sizeof(float))));
+typedef int vNi __attribute__((vector_size(FFT_LANES * sizeof(int))));
+
+
+typedef struct {
+  unsigned int size; //N, the size of the complex FFT. The real signal has 2*N samples.
+  unsigned int passes; //log2(N)
+  float *wr, *wi; //twiddle factors exp(-2*pi*i*k/N), k = 0 ... N/2-1
+  float *er[FFT_SHORT], *ei[FFT_SHORT]; //the twiddle factor of each butterfly of the
+                                       //  passes with a stride below FFT_LANES, N/2 each
+  float *rr, *ri; //twiddle factors exp(-pi*i*k/N) of the real FFT, k = 0 ... N-1
+  float *ur, *ui; //work buffers with N values each
+  float *tr, *ti;
+} fft_setup;
+
+
+static inline float *fft_alloc(const unsigned long count) {
+  //returns an aligned buffer of count floats, set to zero, or NULL
+  void *memory = NULL;
+  if (posix_memalign(&memory, FFT_ALIGNMENT, (count ? count : 1) * sizeof(float)) != 0) return NULL;
+  memset(memory, 0, count * sizeof(float));
+  return (float *)memory;
+}
+
+
+static void free_fft(fft_setup *s) {
+  free(s->wr); free(s->wi); free(s->rr); free(s->ri);
+  for (unsigned int pass = 0; pass < FFT_SHORT; pass++) {
+    free(s->er[pass]); free(s->ei[pass]);
+  }
+  free(s->tr); free(s->ti); free(s->ur); free(s->ui);
+  memset(s, 0, sizeof(fft_setup));
+}
+
+
+static bool init_fft(fft_setup *s, const unsigned int real_size) {
+  //prepares the FFT of a real signal with real_size samples. real_size must be
+  //  a power of 2 and at least 4*FFT_LANES. Returns false if out of memory.
+  const unsigned int N = real_size / 2;
+  memset(s, 0, sizeof(fft_setup));
+  s->size = N;
+  for (s->passes = 0; (1u << s->passes) < N; s->passes++);
+  s->wr = fft_alloc(N / 2); s->wi = fft_alloc(N / 2);
+  s->rr = fft_alloc(N); s->ri = fft_alloc(N);
+  s->tr = fft_alloc(N); s->ti = fft_alloc(N);
+  s->ur = fft_alloc(N); s->ui = fft_alloc(N);
+  bool ok = s->wr && s->wi && s->rr && s->ri && s->tr && s->ti && s->ur && s->ui;
+  for (unsigned int pass = 0; pass < FFT_SHORT; pass++) {
+    s->er[pass] = fft_alloc(N / 2); s->ei[pass] = fft_alloc(N / 2);
+    ok = ok && s->er[pass] && s->ei[pass];
+  }
+  if (!ok) {
+    free_fft(s);
+    return false;
+  }
+  //the twiddle factors are calculated in double precision, each one directly
+  for (unsigned int k = 0; k < N; k++) {
+    if (k < N / 2) {
+      s->wr[k] = (float)cos(2.0 * M_PI * k / N);
+      s->wi[k] = (float)-sin(2.0 * M_PI * k / N);
+    }
+    s->rr[k] = (float)cos(M_PI * k / N);
+    s->ri[k] = (float)-sin(M_PI * k / N);
+  }
+  //butterfly j of the pass with stride 2^pass uses the twiddle factor of
+  //  sequence j/stride, which is wr[(j/stride)*stride]
+  for (unsigned int pass = 0; pass < FFT_SHORT; pass++) {
+    for (unsigned int j = 0; j < N / 2; j++) {
+      s->er[pass][j] = s->wr[j & ~((1u << pass) - 1)];
+      s->ei[pass][j] = s->wi[j & ~((1u << pass) - 1)];
+    }
+  }
+  return true;
+}
+
+
+//index of lane i of the first (i < FFT_LANES) or second half of the output of
+//  a pass with a stride S below FFT_LANES, in the concatenation of the sums and
+//  the differences of FFT_LANES butterflies. Groups of S sums and S
+//  differences alternate.
+#define FFT_SHUFFLE(i, S) ((((i) / (S)) & 1) * FFT_LANES + ((i) / (2 * (S))) * (S) + (i) % (S))
+
+template <unsigned int S>
+CPU_KERNEL_INLINE void fft_short_pass(const fft_setup *s, const unsigned int pass,
+                                      const float *xr, const float *xi, float *yr, float *yi) {
+  //one radix-2 pass of the Stockham FFT with a stride S below FFT_LANES.
+  //  FFT_LANES butterflies, which belong to FFT_LANES/S sequences, are
+  //  calculated side by side and the results are interleaved in groups of S.
+  const unsigned int half = s->size / 2;
+  const vNi first = { FFT_SHUFFLE(0, S), FFT_SHUFFLE(1, S), FFT_SHUFFLE(2, S), FFT_SHUFFLE(3, S),
+                      FFT_SHUFFLE(4, S), FFT_SHUFFLE(5, S), FFT_SHUFFLE(6, S), FFT_SHUFFLE(7, S) };
+  const vNi second = first + FFT_LANES / 2;
+  const float *er = s->er[pass], *ei = s->ei[pass];
+  vNf ar, ai, br, bi, wr, wi, sr, si, dr, di, v;
+
+  for (unsigned int j = 0; j < half; j += FFT_LANES) {
+    memcpy(&ar, xr + j, sizeof(vNf)); memcpy(&ai, xi + j, sizeof(vNf));
+    memcpy(&br, xr + j + half, sizeof(vNf)); memcpy(&bi, xi + j + half, sizeof(vNf));
+    memcpy(&wr, er + j, sizeof(vNf)); memcpy(&wi, ei + j, sizeof(vNf));
+    sr = ar + br; si = ai + bi;
+    dr = (ar - br) * wr - (ai - bi) * wi;
+    di = (ar - br) * wi + (ai - bi) * wr;
+    v = __builtin_shuffle(sr, dr, first); memcpy(yr + 2 * j, &v, sizeof(vNf));
+    v = __builtin_shuffle(sr, dr, second); memcpy(yr + 2 * j + FFT_LANES, &v, sizeof(vNf));
+    v = __builtin_shuffle(si, di, first); memcpy(yi + 2 * j, &v, sizeof(vNf));
+    v = __builtin_shuffle(si, di, second); memcpy(yi + 2 * j + FFT_LANES, &v, sizeof(vNf));
+  }
+} //end fft_short_pass
+
+
+CPU_KERNEL_INLINE void fft_pass(const fft_setup *s, const unsigned int n, const unsigned int stride,
+                                const float *xr, const float *xi, float *yr, float *yi) {
+  //one radix-2 pass of the Stockham FFT. The data consists of stride
+  //  interleaved sequences of length n, which are split into 2*stride
+  //  sequences of length n/2. The butterflies that share a twiddle factor
+  //  are calculated as vectors.
+  const unsigned int m = n / 2;
+  const unsigned int step = s->size / n; //step through the twiddle factors
+  const vNf zero = {};
+  vNf ar, ai, br, bi, wr, wi, sr, si, dr, di;
+
+  switch (stride) {
+  case 1:
+    fft_short_pass<1>(s, 0, xr, xi, yr, yi);
+    return;
+  case 2:
+    fft_short_pass<2>(s, 1, xr, xi, yr, yi);
+    return;
+  case 4:
+    fft_short_pass<4>(s, 2, xr, xi, yr, yi);
+    return;
+  }
+  for (unsigned int p = 0; p < m; p++) {
+    const float *x0r = xr + stride * p, *x0i = xi + stride * p;
+    const float *x1r = xr + stride * (p + m), *x1i = xi + stride * (p + m);
+    float *y0r = yr + stride * 2 * p, *y0i = yi + stride * 2 * p;
+    float *y1r = yr + stride * (2 * p + 1), *y1i = yi + stride * (2 * p + 1);
+    wr = zero + s->wr[p * step];
+    wi = zero + s->wi[p * step];
+    for (unsigned int q = 0; q < stride; q += FFT_LANES) {
+      memcpy(&ar, x0r + q, sizeof(vNf)); memcpy(&ai, x0i + q, sizeof(vNf));
+      memcpy(&br, x1r + q, sizeof(vNf)); memcpy(&bi, x1i + q, sizeof(vNf));
+      sr = ar + br; si = ai + bi;
+      dr = (ar - br) * wr - (ai - bi) * wi;
+      di = (ar - br) * wi + (ai - bi) * wr;
+      memcpy(y0r + q, &sr, sizeof(vNf)); memcpy(y0i + q, &si, sizeof(vNf));
+      memcpy(y1r + q, &dr, sizeof(vNf)); memcpy(y1i + q, &di, sizeof(vNf));
+    }
+  }
+} //end fft_pass
+
+
+CPU_KERNEL_INLINE bool complex_fft(const fft_setup *s, float *ar, float *ai, float *br, float *bi) {
+  //forward complex FFT of size N of the data in a. The passes alternate between
+  //  a and b, so both are changed. Returns true if the result is in b and false
+  //  if it is in a. The inverse FFT (without the 1/N) is calculated by
+  //  exchanging the real and imaginary parts of the data and of the result.
+  unsigned int n = s->size, stride = 1;
+  for (unsigned int pass = 0; pass < s->passes; pass++) {
+    if (pass & 1) {
+      fft_pass(s, n, stride, br, bi, ar, ai);
+    } else {
+      fft_pass(s, n, stride, ar, ai, br, bi);
+    }
+    n /= 2;
+    stride *= 2;
+  }
+  return (s->passes & 1);
+} //end complex_fft
+
+
+CPU_KERNEL_INLINE void real_fft(const fft_setup *s, const float *x, float *Xr, float *Xi) {
+  //calculates the spectrum X of the real signal x with 2*N samples
+  const unsigned int N = s->size;
+  float *zr = s->ur, *zi = s->ui;
+  float fer, fei, for_, foi, tr, ti;
+  unsigned int k;
+
+  for (k = 0; k < N; k++) {
+    zr[k] = x[2 * k];
+    zi[k] = x[2 * k + 1];
+  }
+  if (complex_fft(s, zr, zi, s->tr, s->ti)) {
+    zr = s->tr;
+    zi = s->ti;
+  }
+  //separate the spectra of the even samples (fe) and of the odd samples (fo)
+  //  and combine them: X[k] = fe[k] + exp(-pi*i*k/N) * fo[k]. Both halves of
+  //  the spectrum are calculated from the bins k and N-k. Like all bins, the
+  //  real bins 0 and N are twice the true value.
+  Xr[0] = 2.0f * (zr[0] + zi[0]);
+  Xi[0] = 2.0f * (zr[0] - zi[0]); //bin N
+  for (k = 1; k <= N / 2; k++) {
+    fer = zr[k] + zr[N-k];
+    fei = zi[k] - zi[N-k];
+    for_ = zi[k] + zi[N-k];
+    foi = zr[N-k] - zr[k];
+    tr = for_ * s->rr[k] - foi * s->ri[k];
+    ti = for_ * s->ri[k] + foi * s->rr[k];
+    Xr[k] = fer + tr;
+    Xi[k] = fei + ti;
+    Xr[N-k] = fer - tr;
+    Xi[N-k] = ti - fei;
+  }
+} //end real_fft
+
+
+CPU_KERNEL_INLINE void real_ifft(const fft_setup *s, const float *Xr, const float *Xi, float *x) {
+  //calculates the real signal x with 2*N samples from its spectrum X, times 4*N
+  const unsigned int N = s->size;
+  float *zr = s->ur, *zi = s->ui;
+  float fer, fei, for_, foi, dr, di;
+  unsigned int k;
+
+  //z[k] = fe[k] + i*fo[k], with fe[k] = X[k] + conj(X[N-k]) and
+  //  fo[k] = (X[k] - conj(X[N-k])) * exp(pi*i*k/N)
+  zr[0] = Xr[0] + Xi[0];
+  zi[0] = Xr[0] - Xi[0];
+  for (k = 1; k <= N / 2; k++) {
+    fer = Xr[k] + Xr[N-k];
+    fei = Xi[k] - Xi[N-k];
+    dr = Xr[k] - Xr[N-k];
+    di = Xi[k] + Xi[N-k];
+    for_ = dr * s->rr[k] + di * s->ri[k];
+    foi = di * s->rr[k] - dr * s->ri[k];
+    zr[k] = fer - foi;
+    zi[k] = fei + for_;
+    zr[N-k] = fer + foi;
+    zi[N-k] = for_ - fei;
+  }
+  //the inverse FFT is the forward FFT with the real and imaginary parts exchanged
+  if (complex_fft(s, zi, zr, s->ti, s->tr)) {
+    zr = s->tr;
+    zi = s->ti;
+  }
+  for (k = 0; k < N; k++) {
+    x[2 * k] = zr[k];
+    x[2 * k + 1] = zi[k];
+  }
+} //end real_ifft
+
+#endif
@@ -0,0 +1,232 @@
+/* Convolver_workers.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  The background threads of the zero latency mode of the Convolver LADSPA
+  plugin.
+
+  A task is a sequence of jobs that must be calculated in order, e.g. the
+  blocks of one partition size of one convolver. The run function of the
+  plugin submits a job when its input is complete and picks up the result
+  when it is needed, a fixed number of samples later. The time between the
+  two is the budget of the job. The workers are a small pool of threads that
+  is shared by all instances of the plugin. A worker that is woken up
+  calculates the ready job with the earliest deadline (submission time plus
+  budget) of all tasks, and repeats this until no job is ready.
+
+  run never waits for a worker. The tasks are handed over with atomic
+  counters only:
+    submitted   jobs submitted by run, after the input of the job is stored
+    claimed     jobs taken for calculation, by a worker or by run
+    completed   jobs finished, after the result of the job is stored
+  A job can be claimed when all earlier jobs are completed, by a compare and
+  exchange of claimed, so that exactly one thread calculates it. When a job
+  has not been claimed by a worker at the time its result is needed, run
+  claims and calculates it itself. When a worker still calculates the job or
+  an earlier one, the result is missing and run goes on without it; the
+  plugin counts this as a missed deadline. Waking the workers with sem_post
+  does not block either.
+
+  The tasks are registered in a fixed table. A worker announces that it uses
+  a table entry by incrementing its count of users before it reads the task,
+  so a task can be removed safely (outside of run) by clearing the entry and
+  waiting until the entry has no users.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONVOLVER_WORKERS_H
+#define CONVOLVER_WORKERS_H
+
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <atomic>
+
+#define WORKER_MAX_THREADS  3  //leaves a core of a 4 core CPU for the host and the other plugins
+#define WORKER_MAX_TASKS   64  //largest number of registered tasks, of all instances
+
+
+typedef struct worker_task worker_task;
+struct worker_task {
+  std::atomic<long> submitted, claimed, completed; //job counters, see above
+  std::atomic<int64_t> *submit_time; //when each job was submitted, a ring of ring_size entries
+  unsigned int ring_size;
+  int64_t budget; //time from the submission of a job to its deadline, in ns
+  long (*process)(worker_task *task, long job); //calculates the job and returns the next job
+};
+
+
+typedef struct {
+  std::atomic<worker_task *> task;
+  std::atomic<unsigned int> users; //workers that are reading the task
+} worker_entry;
+
+
+static struct {
+  pthread_mutex_t lock; //protects starting the threads and changing the table
+  std::atomic<unsigned int> num_threads; //set after the semaphore is initialized
+  pthread_t thread[WORKER_MAX_THREADS];
+  sem_t wake;
+  std::atomic<bool> stop;
+  worker_entry entry[WORKER_MAX_TASKS];
+} workers = { PTHREAD_MUTEX_INITIALIZER };
+
+
+static inline int64_t worker_clock() {
+  //monotonic time in ns
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+
+static inline bool job_ready(const worker_task *t, long *job) {
+  //true if the next job of the task has been submitted and can be claimed
+  *job = t->claimed.load(std::memory_order_acquire);
+  return t->completed.load(std::memory_order_acquire) == *job && t->submitted.load(std::memory_order_acquire) > *job;
+}
+
+
+static inline bool claim_job(worker_task *t, const long job) {
+  //claims the job for the calling thread. Fails if an earlier job is not yet
+  //  completed or the job has not been submitted or has already been claimed.
+  long expected = job;
+  if (t->completed.load(std::memory_order_acquire) != job) return false;
+  if (t->submitted.load(std::memory_order_acquire) <= job) return false;
+  return t->claimed.compare_exchange_strong(expected, job + 1, std::memory_order_acq_rel);
+}
+
+
+static inline void finish_job(worker_task *t, const long job, const long next) {
+  //completes a claimed job. next is the job that follows; it is later than
+  //  job + 1 if the process function skipped jobs.
+  if (next != job + 1) t->claimed.store(next, std::memory_order_release);
+  t->completed.store(next, std::memory_order_release);
+}
+
+
+static inline void submit_job(worker_task *t, const long job, const int64_t now) {
+  //called by run when the input of the job is complete
+  t->submit_time[job % t->ring_size].store(now, std::memory_order_relaxed);
+  t->submitted.store(job + 1, std::memory_order_release);
+  if (workers.num_threads.load()) sem_post(&workers.wake);
+}
+
+
+static void run_ready_jobs() {
+  //calculates ready jobs, the one with the earliest deadline first, until no
+  //  job is ready
+  for (;;) {
+    int best = -1;
+    int64_t best_deadline = INT64_MAX;
+    long job;
+    for (int i = 0; i < WORKER_MAX_TASKS; i++) {
+      worker_entry *e = &workers.entry[i];
+      if (!e->task.load(std::memory_order_relaxed)) continue;
+      e->users.fetch_add(1);
+      worker_task *t = e->task.load();
+      if (t && job_ready(t, &job)) {
+        int64_t deadline = t->submit_time[job % t->ring_size].load(std::memory_order_relaxed) + t->budget;
+        if (deadline < best_deadline) {
+          //keep using this entry, release the previous best
+          if (best >= 0) workers.entry[best].users.fetch_sub(1);
+          best = i;
+          best_deadline = deadline;
+          continue;
+        }
+      }
+      e->users.fetch_sub(1);
+    }
+    if (best < 0) return;
+    worker_task *t = workers.entry[best].task.load();
+    if (job_ready(t, &job) && claim_job(t, job)) finish_job(t, job, t->process(t, job));
+    workers.entry[best].users.fetch_sub(1);
+  }
+} //end run_ready_jobs
+
+
+static void *worker_thread(void *) {
+  while (!workers.stop.load()) {
+    if (sem_wait(&workers.wake) != 0 && errno == EINTR) continue;
+    if (workers.stop.load()) break;
+    run_ready_jobs();
+  }
+  return NULL;
+}
+
+
+static unsigned int start_workers() {
+  //starts the threads when they are first needed and returns their number.
+  //  One core is left for the host: 3 threads on a 4 core CPU.
+  pthread_mutex_lock(&workers.lock);
+  if (workers.num_threads == 0 && !workers.stop.load()) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int count = (cores > 1) ? (unsigned int)(cores - 1) : 1;
+    if (count > WORKER_MAX_THREADS) count = WORKER_MAX_THREADS;
+    unsigned int started = 0;
+    if (sem_init(&workers.wake, 0, 0) == 0) {
+      while (started < count && pthread_create(&workers.thread[started], NULL, worker_thread, NULL) == 0) started++;
+      if (started == 0) sem_destroy(&workers.wake);
+    }
+    workers.num_threads.store(started);
+  }
+  pthread_mutex_unlock(&workers.lock);
+  return workers.num_threads.load();
+} //end start_workers
+
+
+static void stop_workers() {
+  //stops and joins the threads, when the plugin library is unloaded
+  pthread_mutex_lock(&workers.lock);
+  workers.stop.store(true);
+  const unsigned int count = workers.num_threads.exchange(0);
+  for (unsigned int i = 0; i < count; i++) sem_post(&workers.wake);
+  for (unsigned int i = 0; i < count; i++) pthread_join(workers.thread[i], NULL);
+  if (count) sem_destroy(&workers.wake);
+  pthread_mutex_unlock(&workers.lock);
+}
+
+
+static bool register_task(worker_task *t) {
+  //adds the task to the table. Returns false if the table is full; the jobs of
+  //  the task are then calculated by run.
+  bool found = false;
+  pthread_mutex_lock(&workers.lock);
+  for (int i = 0; i < WORKER_MAX_TASKS && !found; i++) {
+    if (!workers.entry[i].task.load()) {
+      workers.entry[i].task.store(t);
+      found = true;
+    }
+  }
+  pthread_mutex_unlock(&workers.lock);
+  return found;
+}
+
+
+static void unregister_task(worker_task *t) {
+  //removes the task from the table and waits until no worker uses it
+  pthread_mutex_lock(&workers.lock);
+  for (int i = 0; i < WORKER_MAX_TASKS; i++) {
+    if (workers.entry[i].task.load() != t) continue;
+    workers.entry[i].task.store(NULL);
+    while (workers.entry[i].users.load()) sched_yield();
+  }
+  pthread_mutex_unlock(&workers.lock);
+}
+
+#endif
@@ -0,0 +1,544 @@
+/* Delay LADSPA plugin, version 1.0
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Delay is a multichannel delay line with fractional sample resolution for
+  the time alignment of drivers in GSASysCon. Each channel has its own delay,
+  in milliseconds, which can be changed while the plugin runs. Each channel
+  count has its own plugin label:
+    Delay1, Delay2, ... Delay8
+  Under Gstreamer a plugin with several inputs and outputs processes an
+  interleaved multichannel stream, so one Delay4 after a filter bank replaces
+  four DELAY elements on the routes of its bands.
+
+  The channels share one arena that is allocated when the plugin is
+  activated. It holds a ring buffer for each channel that is long enough for
+  the largest delay, set by the parameter max. The first DELAY_GUARD samples
+  of each ring are repeated after its end, so the samples that are needed for
+  a block of output are always contiguous in memory. Changing a delay does
+  not allocate memory. Delays above max are limited to max.
+
+  The delay is divided into whole samples and a fraction mu. The fraction is
+  calculated by an FIR filter with DELAY_TAPS taps, a Kaiser windowed sinc
+  whose taps are polynomials of order DELAY_ORDER in mu (the Farrow
+  structure). The polynomials are fitted to the windowed sinc when the plugin
+  is loaded. While a delay is constant, the taps for its fraction are
+  calculated once and the filter runs as a plain FIR filter that the compiler
+  vectorizes (see cpu_dispatch.h). A whole number of samples is copied
+  without filtering. Up to 20kHz at 48kHz the error of the fractional delay
+  is below 0.01dB and 0.05 degrees.
+
+  When a delay is changed while the plugin runs, the taps for the new delay
+  are evaluated from the polynomials and the output crossfades from the old
+  delay to the new one over DELAY_FADE_MS, so the change does not cause a
+  click. A change that arrives during a crossfade is applied when it ends.
+
+  The filter needs DELAY_LATENCY samples of the future input, so all channels
+  are delayed by DELAY_LATENCY samples in addition to their delay. This is
+  reported by the latency port and is compensated by GSASysCon like the
+  latency of other plugins. The delays that are set are not reported.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define DELAY_MAX_CHANNELS         8  //maximum number of channels
+#define DELAY_FIRST_ID          5241  //UniqueID of the first descriptor
+#define DELAY_MAX_MS            1000  //largest value of max, in milliseconds
+#define DELAY_TAPS                24  //taps of the fractional delay filter
+#define DELAY_ORDER                5  //order of the polynomials of the taps in the fraction
+#define DELAY_KAISER_BETA        6.0  //shape of the window of the sinc
+#define DELAY_LATENCY   (DELAY_TAPS / 2 - 1)  //delay of the filter for a fraction of 0, in samples
+#define DELAY_BLOCK             1024  //samples processed at a time
+#define DELAY_GUARD   (DELAY_BLOCK + DELAY_TAPS)  //samples repeated after the end of each ring
+#define DELAY_FADE_MS             10  //duration of the crossfade when a delay is changed
+#define DELAY_ALIGNMENT           64  //alignment of the arena and of each ring, in bytes
+
+//each channel has a delay parameter. They occupy the first ports and are
+//  followed by the maximum delay, the inputs, the outputs and the latency.
+#define DELAY_DELAY(channel)       (channel)
+#define DELAY_MAX(channels)        (channels)
+#define DELAY_INPUT(channels)      (DELAY_MAX(channels) + 1)
+#define DELAY_OUTPUT(channels)     (DELAY_INPUT(channels) + (channels))
+#define DELAY_LATENCY_PORT(channels) (DELAY_OUTPUT(channels) + (channels))
+#define DELAY_NUM_PORTS(channels)  (DELAY_LATENCY_PORT(channels) + 1)
+
+//one descriptor is created for each number of channels:
+#define DELAY_NUM_DESCRIPTORS DELAY_MAX_CHANNELS
+static LADSPA_Descriptor *DelayDescriptor[DELAY_NUM_DESCRIPTORS];
+
+//the Farrow structure: tap j of the filter for the fraction mu is the sum over p of
+//  farrow[p][j] * mu^p. The filter output is the sum over j of tap j times x[n - whole - j].
+static float farrow[DELAY_ORDER + 1][DELAY_TAPS];
+
+
+typedef struct {
+  double delay; //the delay in samples, without DELAY_LATENCY
+  unsigned long whole; //whole samples of the delay
+  bool fractional; //false if the delay is a whole number of samples
+  float taps[DELAY_TAPS]; //the filter for the fraction of the delay, in reverse order
+} delay_setting;
+
+
+typedef struct {
+  float *ring; //the last inputs, size + DELAY_GUARD samples
+  delay_setting current;
+  delay_setting previous; //the delay before the last change, while fading out
+  unsigned long fade; //samples left of the crossfade from previous to current
+} delay_channel;
+
+
+typedef struct {
+  LADSPA_Data *delay_ms[DELAY_MAX_CHANNELS];
+  LADSPA_Data *max_ms;
+  LADSPA_Data *input[DELAY_MAX_CHANNELS];
+  LADSPA_Data *output[DELAY_MAX_CHANNELS];
+  LADSPA_Data *latency; //output: DELAY_LATENCY
+  LADSPA_Data rate;
+  unsigned int num_channels;
+  int isa; //instruction set of the filter, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  void *arena; //the rings of all channels. NULL until the plugin has been activated
+  unsigned long size; //size of each ring without the guard, a power of 2
+  unsigned long max_delay; //the largest delay, in samples
+  unsigned long position; //number of input samples received since activation
+  unsigned long fade_length; //DELAY_FADE_MS in samples
+  float work[2][DELAY_BLOCK]; //output of the current block of one channel for the current and previous delays
+  delay_channel channel[DELAY_MAX_CHANNELS];
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the outputs in shared memory, see telemetry.h
+} Delay;
+
+
+/************************ the Farrow structure ************************/
+
+static double bessel_i0(const double x) {
+  //modified Bessel function of order 0, for the Kaiser window
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 50; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+
+static double windowed_sinc(const unsigned int tap, const double mu) {
+  //tap of the ideal filter for a delay of DELAY_LATENCY + mu samples
+  const double x = tap - (DELAY_LATENCY + mu);
+  const double w = 1.0 - (2.0 * x / DELAY_TAPS) * (2.0 * x / DELAY_TAPS);
+  if (w <= 0.0) return 0.0;
+  const double window = bessel_i0(DELAY_KAISER_BETA * sqrt(w)) / bessel_i0(DELAY_KAISER_BETA);
+  return (fabs(x) < 1.e-12) ? window : window * sin(M_PI * x) / (M_PI * x);
+}
+
+
+static void design_farrow() {
+  //fits the polynomials of the taps to the windowed sinc at DELAY_ORDER + 1
+  //  Chebyshev nodes of mu in [0, 1], by solving the Vandermonde system
+  const int P = DELAY_ORDER + 1;
+  double node[P], a[P][P + 1], factor;
+  int p, q, r, k;
+
+  for (k = 0; k < P; k++) node[k] = 0.5 - 0.5 * cos(M_PI * (2 * k + 1) / (2.0 * P));
+  for (unsigned int j = 0; j < DELAY_TAPS; j++) {
+    for (k = 0; k < P; k++) {
+      for (p = 0; p < P; p++) a[k][p] = pow(node[k], p);
+      a[k][P] = windowed_sinc(j, node[k]);
+    }
+    //Gauss-Jordan elimination with partial pivoting
+    for (p = 0; p < P; p++) {
+      r = p;
+      for (q = p + 1; q < P; q++) if (fabs(a[q][p]) > fabs(a[r][p])) r = q;
+      for (q = 0; q <= P; q++) swap(a[p][q], a[r][q]);
+      for (r = 0; r < P; r++) {
+        if (r == p) continue;
+        factor = a[r][p] / a[p][p];
+        for (q = p; q <= P; q++) a[r][q] -= factor * a[p][q];
+      }
+    }
+    for (p = 0; p < P; p++) farrow[p][j] = (float)(a[p][P] / a[p][p]);
+  }
+} //end design_farrow
+
+
+static void set_delay(delay_setting *d, const double delay) {
+  //sets a delay and evaluates the taps of the filter for its fraction
+  const double mu = delay - floor(delay);
+  d->delay = delay;
+  d->whole = (unsigned long)floor(delay);
+  d->fractional = (mu != 0.0);
+  for (unsigned int j = 0; j < DELAY_TAPS; j++) {
+    double tap = farrow[DELAY_ORDER][j];
+    for (int p = DELAY_ORDER - 1; p >= 0; p--) tap = tap * mu + farrow[p][j];
+    d->taps[DELAY_TAPS - 1 - j] = (float)tap;
+  }
+} //end set_delay
+
+
+static double requested_delay(const Delay *pluginData, const unsigned int n) {
+  //the delay of channel n in samples, limited to the range of the ring
+  double delay = *(pluginData->delay_ms[n]) * pluginData->rate / 1000.0;
+  if (!(delay > 0.0)) delay = 0.0;
+  if (delay > pluginData->max_delay) delay = pluginData->max_delay;
+  return delay;
+}
+
+
+/************************ the LADSPA interface ************************/
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  if (index < DELAY_NUM_DESCRIPTORS) return DelayDescriptor[index];
+  return NULL;
+}
+
+
+LADSPA_Handle instantiateDelay(const LADSPA_Descriptor *descriptor, unsigned long sample_rate) {
+  Delay *pluginData = (Delay *)calloc(1, sizeof(Delay));
+  if (!pluginData) return NULL;
+  pluginData->rate = (LADSPA_Data)sample_rate;
+  pluginData->num_channels = descriptor->UniqueID - DELAY_FIRST_ID + 1;
+  pluginData->isa = select_cpu_isa(descriptor->Label);
+  pluginData->run_adding_gain = 1.0;
+  return (LADSPA_Handle)pluginData;
+}
+
+
+void connectPortDelay(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  Delay *pluginData = (Delay *)instance;
+  const unsigned int N = pluginData->num_channels;
+  if (port < DELAY_MAX(N)) {
+    pluginData->delay_ms[port] = data;
+  } else if (port == DELAY_MAX(N)) {
+    pluginData->max_ms = data;
+  } else if (port < DELAY_OUTPUT(N)) {
+    pluginData->input[port - DELAY_INPUT(N)] = data;
+  } else if (port < DELAY_LATENCY_PORT(N)) {
+    pluginData->output[port - DELAY_OUTPUT(N)] = data;
+  } else if (port == DELAY_LATENCY_PORT(N)) {
+    pluginData->latency = data;
+  }
+}
+
+
+static void clear_rings(Delay *pluginData) {
+  //clears the input history of all channels, as when the plugin was activated
+  for (unsigned int n = 0; n < pluginData->num_channels; n++) {
+    memset(pluginData->channel[n].ring, 0, (pluginData->size + DELAY_GUARD) * sizeof(float));
+  }
+}
+
+
+void activateDelay(LADSPA_Handle instance) {
+  Delay *pluginData = (Delay *)instance;
+  const unsigned int N = pluginData->num_channels;
+  double max_ms = *(pluginData->max_ms);
+  size_t ring_bytes;
+  unsigned int n;
+
+  free(pluginData->arena);
+  pluginData->arena = NULL;
+  if (pluginData->latency) *(pluginData->latency) = DELAY_LATENCY;
+  if (!(max_ms > 0.0)) max_ms = 0.0;
+  if (max_ms > DELAY_MAX_MS) max_ms = DELAY_MAX_MS;
+  pluginData->max_delay = (unsigned long)ceil(max_ms * pluginData->rate / 1000.0);
+  //each ring holds the largest delay, the taps and a block
+  for (pluginData->size = DELAY_BLOCK; pluginData->size < pluginData->max_delay + DELAY_TAPS + DELAY_BLOCK; pluginData->size *= 2);
+  ring_bytes = ((pluginData->size + DELAY_GUARD) * sizeof(float) + DELAY_ALIGNMENT - 1) & ~(size_t)(DELAY_ALIGNMENT - 1);
+  if (posix_memalign(&pluginData->arena, DELAY_ALIGNMENT, N * ring_bytes) != 0) {
+    pluginData->arena = NULL;
+    cout << "Delay" << N << ": ERROR: out of memory for delays of up to " << max_ms << " ms. The output is silent." << endl;
+    return;
+  }
+  for (n = 0; n < N; n++) pluginData->channel[n].ring = (float *)((char *)pluginData->arena + n * ring_bytes);
+  clear_rings(pluginData);
+  pluginData->position = 0;
+  pluginData->fade_length = (unsigned long)ceil(DELAY_FADE_MS * pluginData->rate / 1000.0);
+  for (n = 0; n < N; n++) {
+    set_delay(&pluginData->channel[n].current, requested_delay(pluginData, n));
+    pluginData->channel[n].fade = 0;
+  }
+  //the output is silent once the largest delay and the filter have passed
+  set_silence_gate(&pluginData->gate, pluginData->max_delay + DELAY_TAPS);
+
+  cout << "Delay" << N << ": delays of up to " << max_ms << " ms (" << pluginData->max_delay << " samples) use ";
+  cout << N * ring_bytes / 1024 << " kB of memory. The delays are:" << endl;
+  for (n = 0; n < N; n++) {
+    cout << "   channel " << n + 1 << ": " << pluginData->channel[n].current.delay << " samples";
+    if (*(pluginData->delay_ms[n]) * pluginData->rate / 1000.0 > pluginData->max_delay) cout << " (limited by max)";
+    cout << endl;
+  }
+  cout << "All channels are delayed by " << DELAY_LATENCY << " more samples, which is reported as the latency." << endl;
+
+  char label[TELEMETRY_LABEL_SIZE], info[TELEMETRY_INFO_SIZE];
+  int length = snprintf(info, sizeof(info), "ms");
+  for (n = 0; n < N && length < (int)sizeof(info); n++) {
+    length += snprintf(info + length, sizeof(info) - length, " %g", *(pluginData->delay_ms[n]));
+  }
+  snprintf(label, sizeof(label), "Delay%u", N);
+  telemetry_open(&pluginData->meter, label, info, N, pluginData->rate);
+} //end activateDelay
+
+
+static void write_input(Delay *pluginData, const unsigned int n, const LADSPA_Data *input, const unsigned long count) {
+  //appends count samples to the ring of channel n and repeats those in the guard
+  float *ring = pluginData->channel[n].ring;
+  const unsigned long size = pluginData->size, at = pluginData->position & (size - 1);
+  const unsigned long first = (count < size - at) ? count : size - at;
+
+  memcpy(ring + at, input, first * sizeof(float));
+  memcpy(ring, input + first, (count - first) * sizeof(float));
+  if (at < DELAY_GUARD) {
+    const unsigned long end = (at + first < DELAY_GUARD) ? at + first : DELAY_GUARD;
+    memcpy(ring + size + at, ring + at, (end - at) * sizeof(float));
+  }
+  if (count > first) {
+    const unsigned long end = (count - first < DELAY_GUARD) ? count - first : DELAY_GUARD;
+    memcpy(ring + size, ring, end * sizeof(float));
+  }
+} //end write_input
+
+
+CPU_KERNEL_INLINE void fractional_delay(const float *__restrict window, const float *__restrict taps,
+                                        float *__restrict out, const unsigned long count) {
+  //the FIR filter of a constant fractional delay. The window holds the
+  //  count + DELAY_TAPS - 1 input samples that the outputs depend on.
+  unsigned long i;
+  for (i = 0; i < count; i++) out[i] = taps[0] * window[i];
+  for (unsigned int k = 1; k < DELAY_TAPS; k++) {
+    const float tap = taps[k];
+    const float *x = window + k;
+    for (i = 0; i < count; i++) out[i] += tap * x[i];
+  }
+} //end fractional_delay
+
+CPU_DISPATCH_KERNELS(fractional_delay, (const float *__restrict window, const float *__restrict taps,
+                     float *__restrict out, const unsigned long count), (window, taps, out, count))
+
+
+static const float *delayed_block(Delay *pluginData, const delay_channel *c, const delay_setting *d,
+                                  float *work, const unsigned long count,
+                                  void (*kernel)(const float *, const float *, float *, const unsigned long)) {
+  //returns the next count samples of the ring delayed by d, either in work or,
+  //  for a whole number of samples, directly from the ring
+  //the oldest sample that the block depends on. The window of the block is
+  //  contiguous because of the guard after the end of the ring.
+  const float *window = c->ring + ((pluginData->position - d->whole - (DELAY_TAPS - 1)) & (pluginData->size - 1));
+  if (!d->fractional) return window + DELAY_TAPS - 1 - DELAY_LATENCY;
+  kernel(window, d->taps, work, count);
+  return work;
+} //end delayed_block
+
+
+static inline void processDelay(Delay *pluginData, unsigned long sample_count, const bool adding) {
+  //delays the inputs. The result replaces the contents of the output buffers
+  //  (run) or is multiplied by the run_adding gain and added to them (run_adding).
+  const unsigned int N = pluginData->num_channels;
+  const LADSPA_Data gain = pluginData->run_adding_gain;
+  const double fade_step = 1.0 / pluginData->fade_length;
+  void (*kernel)(const float *, const float *, float *, const unsigned long) =
+    CPU_DISPATCH_SELECT(fractional_delay, pluginData->isa);
+  unsigned long pos, count, i, fading;
+  unsigned int n;
+  bool silent = true;
+
+  if (pluginData->latency) *(pluginData->latency) = DELAY_LATENCY;
+  for (n = 0; n < N && silent; n++) silent = is_silent(pluginData->input[n], sample_count);
+  if (!pluginData->arena || silence_gate_skip(&pluginData->gate, silent, sample_count)) {
+    for (n = 0; n < N; n++) write_silence(pluginData->output[n], sample_count, adding);
+    return;
+  }
+  for (pos = 0; pos < sample_count; pos += count) {
+    count = (sample_count - pos < DELAY_BLOCK) ? sample_count - pos : DELAY_BLOCK;
+    //all inputs are read before any output is written, so the host may use
+    //  the same buffer for an input and an output
+    for (n = 0; n < N; n++) write_input(pluginData, n, pluginData->input[n] + pos, count);
+    for (n = 0; n < N; n++) {
+      delay_channel *c = &pluginData->channel[n];
+      if (c->fade == 0) {
+        const double target = requested_delay(pluginData, n);
+        if (target != c->current.delay) {
+          c->previous = c->current;
+          set_delay(&c->current, target);
+          c->fade = pluginData->fade_length;
+        }
+      }
+      const float *result = delayed_block(pluginData, c, &c->current, pluginData->work[0], count, kernel);
+      if (c->fade > 0) {
+        //crossfade from the previous delay, whose weight falls linearly to 0
+        const float *old = delayed_block(pluginData, c, &c->previous, pluginData->work[1], count, kernel);
+        float *mixed = pluginData->work[0];
+        fading = (c->fade < count) ? c->fade : count;
+        for (i = 0; i < fading; i++) {
+          const float weight = (float)((c->fade - i) * fade_step);
+          mixed[i] = result[i] + weight * (old[i] - result[i]);
+        }
+        if (result != mixed) memcpy(mixed + fading, result + fading, (count - fading) * sizeof(float));
+        result = mixed;
+        c->fade -= fading;
+      }
+      LADSPA_Data *output = pluginData->output[n] + pos;
+      if (adding) {
+        for (i = 0; i < count; i++) output[i] += gain * result[i];
+      } else {
+        memcpy(output, result, count * sizeof(LADSPA_Data));
+      }
+    }
+    pluginData->position += count;
+  }
+  if (silence_gate_closing(&pluginData->gate)) clear_rings(pluginData);
+} //end processDelay
+
+
+static inline void meterDelay(Delay *pluginData, unsigned long sample_count, const int64_t start) {
+  const unsigned int state = pluginData->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&pluginData->meter, pluginData->output, sample_count, state, start);
+}
+
+
+void runDelay(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((Delay *)instance)->meter);
+  processDelay((Delay *)instance, sample_count, false);
+  meterDelay((Delay *)instance, sample_count, start);
+}
+
+
+void runAddingDelay(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((Delay *)instance)->meter);
+  processDelay((Delay *)instance, sample_count, true);
+  meterDelay((Delay *)instance, sample_count, start);
+}
+
+
+void setRunAddingGainDelay(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((Delay *)instance)->run_adding_gain = gain;
+}
+
+
+void cleanupDelay(LADSPA_Handle instance) {
+  telemetry_close(&((Delay *)instance)->meter);
+  free(((Delay *)instance)->arena);
+  free(instance);
+}
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    LADSPA_Descriptor *descriptor;
+    unsigned int N;
+    unsigned long num_ports, port;
+
+    design_farrow();
+    for (unsigned int index = 0; index < DELAY_NUM_DESCRIPTORS; index++) {
+      DelayDescriptor[index] = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+      descriptor = DelayDescriptor[index];
+      if (!descriptor) continue;
+      std::string text;
+      N = index + 1;
+      num_ports = DELAY_NUM_PORTS(N);
+      //plugin descriptor info
+      descriptor->UniqueID = DELAY_FIRST_ID + index;
+      text = "Delay" + to_string(N);
+      descriptor->Label = strdup(text.c_str());
+      descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      text = "Delay v1.0: fractional delay with " + to_string(N) + " channel(s)";
+      descriptor->Name = strdup(text.c_str());
+      descriptor->Maker = "Charlie Laub, 2025";
+      descriptor->Copyright = "GPLv3";
+      descriptor->PortCount = num_ports;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
+      descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
+      descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(num_ports, sizeof(char*));
+      descriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      //ports for the delay of each channel in milliseconds, named delay1 ... delayN
+      for (unsigned int n = 0; n < N; n++) {
+        port = DELAY_DELAY(n);
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "delay" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0;
+        port_range_hints[port].LowerBound = 0;
+        port_range_hints[port].UpperBound = DELAY_MAX_MS;
+      }
+
+      //port = DELAY_MAX, the largest delay in milliseconds, set at activation
+      port = DELAY_MAX(N);
+      port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("max");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_100;
+      port_range_hints[port].LowerBound = 0;
+      port_range_hints[port].UpperBound = DELAY_MAX_MS;
+
+      //audio ports, named Input1 ... InputN and Output1 ... OutputN
+      for (unsigned int n = 0; n < N; n++) {
+        port = DELAY_INPUT(N) + n;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+        text = "Input" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+        port = DELAY_OUTPUT(N) + n;
+        port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+        text = "Output" + to_string(n+1);
+        port_names[port] = strdup(text.c_str());
+      }
+
+      //port = DELAY_LATENCY_PORT
+      port = DELAY_LATENCY_PORT(N);
+      port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      port_names[port] = strdup("latency");
+      port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[port].LowerBound = 0;
+
+      descriptor->activate = activateDelay;
+      descriptor->cleanup = cleanupDelay;
+      descriptor->connect_port = connectPortDelay;
+      descriptor->deactivate = NULL;
+      descriptor->instantiate = instantiateDelay;
+      descriptor->run = runDelay;
+      descriptor->run_adding = runAddingDelay;
+      descriptor->set_run_adding_gain = setRunAddingGainDelay;
+    }
+  }
+  ~Initialiser() {
+    for (unsigned int index = 0; index < DELAY_NUM_DESCRIPTORS; index++) {
+      if (DelayDescriptor[index]) {
+        free((LADSPA_PortDescriptor *)DelayDescriptor[index]->PortDescriptors);
+        free((char **)DelayDescriptor[index]->PortNames);
+        free((LADSPA_PortRangeHint *)DelayDescriptor[index]->PortRangeHints);
+        free(DelayDescriptor[index]);
+      }
+    }
+  }
+} g_theInitialiser;
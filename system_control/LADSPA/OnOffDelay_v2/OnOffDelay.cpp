@@ -10,11 +10,12 @@
   'on' state, the plugin sets one or more GPIO pins to 'high'. When entering
   the 'off' state, these same GPIO pins are set to 'low'. The GPIO pins can
   be used to trigger external equipment like relays, put amps or power supplies
-  into standby, etc. The plugin monitors each of two (e.g. stereo) inputs. 
+  into standby, etc. OnOffDelay monitors one input, and OnOffDelay2 ...
+  OnOffDelay8 monitor 2 to 8 inputs (e.g. all channels of a system). 
   
   Audio Trigger Threshold: 
-  The plugin's two audio inputs are both analyzed and used to trigger the
-  on-delay and off-delay behavior of the output. The peak level of the input
+  All audio inputs of the plugin are analyzed and used together to trigger the
+  on-delay and off-delay behavior of the outputs. The peak level of the input
   (e.g. audio signal) is monitored and compared to a reference level called the
   'Threshold', specified in dB below maximum. When the peak level within a
   frame exceeds the threshold, a timer is started. As long as the peak signal
@@ -94,12 +95,15 @@
 
 #include <ladspa.h>
 #include <string>
-#include <sstream>
 #include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
+#include "cpu_dispatch.h"
+#include "silence_gate.h"
+#include "OnOffDelay_gpio.h"
+#include "telemetry.h"
 using namespace std;
 
 //DEFAULT, MINIMUM, AND MAXIMUM PARAMETER VALUES:
@@ -119,79 +123,51 @@ static const float Default_DelayOFF = 120.0;
 static const float Default_DelayON = 0.0;
 static const bool PassThru = false; 
 
-
-//---- GPIO MANIPULATION FUNCTIONS --------------------------------------------
-//The following functions employ the linux kernel's GPIO Sysfs Interface
-
-#define GPIO_ON 1
-#define GPIO_OFF 0
-#define OS_sleep_between_commands 0.1
-
-void configure_GPIO_for_output (unsigned int pin_index, int map[] ) {
-  //first check to make sure that a GPIO has been associated with this index
-  if (map[pin_index] == -1) {
-    cout << "no valid GPIO has been associated with index " << pin_index << endl;
-    cout << "please correct this error and try again." << endl;
-    return;
-  }
-  std::stringstream commandString;
-  //build the command string; 
-  commandString << "echo " << map[pin_index] << " > /sys/class/gpio/export";
-  //run the command on the system
-  int retval = system( strdup( (commandString.str()).c_str() ) ); //run command string in shell
-  if (retval != 0) cout << "OnOffDelay ERROR: could not run command in shell!" << endl;
-  //clear contents of command string by setting it equal to empty string - must do this after
-  //  each command if multiple commands are run within the same function call
-  commandString.str("");
-  commandString << "sleep " << OS_sleep_between_commands; //needed to allow command to complete in OS
-  retval = system( strdup( (commandString.str()).c_str() ) ); //run command string in shell
-  if (retval != 0) cerr << "OnOffDelay: ERROR encountered when attempting to run command in shell!" << endl;
-  commandString.str("");  
-  commandString << "echo \"out\" > /sys/class/gpio/gpio" << map[pin_index] <<"/direction";
-  //run the command on the system
-  retval = system( strdup( (commandString.str()).c_str() ) ); //run command string in shell
-  if (retval != 0) cerr << "OnOffDelay: ERROR encountered when attempting to run command in shell!" << endl;
-} // end configure_GPIO_for_output
-
-
-void set_GPIO_state (unsigned int pin_index, bool pin_state, int map[]) {
-  //first check to make sure that a GPIO has been associated with this index
-  if (map[pin_index] == -1) return;
-  std::stringstream commandString;
-  //build the command string; syntax: 
-  commandString << "echo " << (unsigned int)pin_state << " > /sys/class/gpio/gpio" << map[pin_index] <<"/value";
-  //run the command on the system
-  int retval = system( (commandString.str()).c_str() ); //run command string in shell
-  if (retval != 0) cerr << "OnOffDelay: ERROR encountered when attempting to run command in shell!" << endl;
-  //clear contents of command string by setting it equal to empty string - must do this after
-  //  each command if multiple commands are run within the same function call
-  commandString.str(""); 
-} //end set_GPIO_state
-
-
-void GPIO_teardown (unsigned int array_of_GPIOs_in_use[], unsigned int num_GPIOs, int map[]) {
-  //this function is called when exiting the plugin. Note that it may also be called once when
-  //  the plugin is initializing (this behavior may be LADSPA host dependent)
-  std::stringstream commandString;
-  int GPIO;
-  for (unsigned int j=0; j < num_GPIOs; j++) {
-    GPIO = map[array_of_GPIOs_in_use[j]];
-    //check to make sure that a GPIO has been associated with this index
-    if (GPIO != -1) {
-      //build the command string; 
-      commandString << "echo " << GPIO << " > /sys/class/gpio/unexport";
-      //run the command on the system
-      system( strdup( (commandString.str()).c_str() ) ); //run command string in shell
-      //clear contents of command string by setting it equal to empty string - must do this after
-      //  each command if multiple commands are run within the same function call
-      commandString.str("");  
-      commandString << "sleep " << OS_sleep_between_commands; //needed to allow command to complete in OS
-      system( strdup( (commandString.str()).c_str() ) ); //run command string in shell
+//PORTS AND PLUGIN VARIANTS:
+//  OnOffDelay has one audio input and output. OnOffDelay2 ... OnOffDelay8 have 2 to 8 of
+//  each, which share the on/off behavior and the GPIOs. The parameters occupy the first
+//  ports, followed by the inputs and then the outputs.
+#define ONOFF_MAX_CHANNELS 8
+#define ONOFF_FIRST_MULTI_ID 5249 //UniqueID of OnOffDelay2
+#define ONOFF_INPUT 6 //the first audio input
+#define ONOFF_OUTPUT(channels) (ONOFF_INPUT + (channels))
+#define ONOFF_NUM_PORTS(channels) (ONOFF_OUTPUT(channels) + (channels))
+
+
+
+//---- SIGNAL PEAK DETECTION --------------------------------------------------
+//The peak level of each frame is found using vectors of PEAK_LANES samples. The
+//  kernel is compiled for several instruction sets and the best one for the CPU
+//  is chosen when the plugin is instantiated (see cpu_dispatch.h)
+
+#define PEAK_LANES 8
+typedef float peak_vector __attribute__((vector_size(PEAK_LANES * sizeof(float))));
+typedef int peak_bits __attribute__((vector_size(PEAK_LANES * sizeof(int))));
+
+CPU_KERNEL_INLINE void find_signal_peaks(const LADSPA_Data *const *inputs, unsigned int num_channels,
+                                         unsigned long sample_count, LADSPA_Data *peaks) {
+  //finds the peak of each channel
+  for (unsigned int ch = 0; ch < num_channels; ch++) {
+    const LADSPA_Data *input = inputs[ch];
+    peak_vector x, vector_peak = {};
+    peak_bits bits;
+    LADSPA_Data signal_peak = 0.0;
+    unsigned long pos = 0;
+    for (; pos + PEAK_LANES <= sample_count; pos += PEAK_LANES) {
+      memcpy(&bits, &input[pos], sizeof(peak_bits));
+      bits &= 0x7fffffff; //clearing the sign bit gives the absolute value
+      memcpy(&x, &bits, sizeof(peak_vector));
+      vector_peak = (x > vector_peak) ? x : vector_peak;
     }
+    for (unsigned int lane = 0; lane < PEAK_LANES; lane++) signal_peak = std::max( vector_peak[lane], signal_peak);
+    for (; pos < sample_count; pos++) signal_peak = std::max( std::abs( input[pos] ), signal_peak);
+    peaks[ch] = signal_peak;
   }
 }
+CPU_DISPATCH_KERNELS(find_signal_peaks, (const LADSPA_Data *const *inputs, unsigned int num_channels, unsigned long sample_count, LADSPA_Data *peaks),
+                     (inputs, num_channels, sample_count, peaks))
 
-//---- END GPIO MANIPULATION FUNCTIONS ----------------------------------------
+//---- END SIGNAL PEAK DETECTION ----------------------------------------------
 
 
 
@@ -214,38 +190,63 @@ typedef struct {
   float FadeUpFactor;
   float FadeMultiplier;
   bool OutputEnabled;
-  bool SetPinsHighActionNeeded;
   unsigned int PinCount;
   unsigned int PinIndexList[7];
   int index_to_GPIO_map[10];
+  gpio_lines GPIO_lines; //the worker that switches the GPIOs
+  telemetry_meter meter; //level of the outputs in shared memory, see telemetry.h
+  int isa; //instruction set used for peak detection, see cpu_dispatch.h
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
 } ParameterStorage;
 
 
 typedef struct {
   ParameterStorage * Parameters;
-  LADSPA_Data *ch1_input;
-  LADSPA_Data *ch1_output;
+  unsigned int num_channels;
+  LADSPA_Data *input[ONOFF_MAX_CHANNELS];
+  LADSPA_Data *output[ONOFF_MAX_CHANNELS];
 } PluginDataContainer;
 
 
-static LADSPA_Descriptor *PluginDescriptor = NULL;
+//---- GPIO MANIPULATION ------------------------------------------------------
+//The GPIOs are switched by a worker thread of each plugin instance, so that run
+//  does not wait for the system (see OnOffDelay_gpio.h)
 
-const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
-  switch (index) {
-  case 0:
-    return PluginDescriptor;
-  default:
-    return NULL;
+static void start_GPIO_lines(ParameterStorage *PS) {
+  //starts the worker for the GPIOs in the PinIndexList. Indexes that have no GPIO are skipped.
+  int GPIOs[7];
+  unsigned int count = 0;
+  for (unsigned int j=0; j < PS->PinCount; j++) {
+    if (PS->index_to_GPIO_map[PS->PinIndexList[j]] == -1) {
+      cout << "no valid GPIO has been associated with index " << PS->PinIndexList[j] << endl;
+      cout << "please correct this error and try again." << endl;
+      continue;
+    }
+    GPIOs[count++] = PS->index_to_GPIO_map[PS->PinIndexList[j]];
   }
+  start_gpio_lines(&PS->GPIO_lines, GPIOs, count);
+} //end start_GPIO_lines
+
+//---- END GPIO MANIPULATION --------------------------------------------------
+
+
+static LADSPA_Descriptor *PluginDescriptor[ONOFF_MAX_CHANNELS];
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  if (index < ONOFF_MAX_CHANNELS) return PluginDescriptor[index];
+  return NULL;
 }
 
 
 LADSPA_Handle Instantiate_Plugin(const LADSPA_Descriptor *descriptor, unsigned long sample_rate) {
   PluginDataContainer *pluginData = (PluginDataContainer *)malloc(sizeof(PluginDataContainer));
   ParameterStorage *PS = NULL;
-  PS = (ParameterStorage *)malloc(sizeof(ParameterStorage));
+  PS = (ParameterStorage *)calloc(1, sizeof(ParameterStorage));
   PS->sample_rate = sample_rate;
+  PS->isa = select_cpu_isa("OnOffDelay");
+  PS->run_adding_gain = 1.0;
   pluginData->Parameters = PS;
+  pluginData->num_channels = (descriptor->PortCount - ONOFF_INPUT) / 2;
   return (LADSPA_Handle)pluginData;
 }
 
@@ -277,11 +278,11 @@ void Connect_Plugin_Ports(LADSPA_Handle instance, unsigned long port, LADSPA_Dat
     else
       PS->PassThru = true;
     break;
-  case 6: //port = first audio input
-    pluginData->ch1_input = data;
-    break;
-  case 7: //port = first audio output
-    pluginData->ch1_output = data;
+  default: //ports = audio inputs, then audio outputs
+    if (port < ONOFF_OUTPUT(pluginData->num_channels))
+      pluginData->input[port - ONOFF_INPUT] = data;
+    else if (port < ONOFF_NUM_PORTS(pluginData->num_channels))
+      pluginData->output[port - ONOFF_OUTPUT(pluginData->num_channels)] = data;
     break;
   }
 }
@@ -392,8 +393,10 @@ void Activate_Plugin(LADSPA_Handle instance) {
     } while (( value/= 10 ) && ( PS->PinCount < 7 ));
   }
 
-  //set up the pins in the PinIndexList for output
-  for (unsigned int j=0; j < PS->PinCount; j++) configure_GPIO_for_output(PS->PinIndexList[j], PS->index_to_GPIO_map);
+  //set up the pins in the PinIndexList for output. A plugin that is activated
+  //  again releases its pins first.
+  stop_gpio_lines(&PS->GPIO_lines);
+  start_GPIO_lines(PS);
 
   //Extract the duration of the Delay and Fade-in from the passed value
   //The number of seconds of delay are taken as the digits left of the decimal point
@@ -408,34 +411,65 @@ void Activate_Plugin(LADSPA_Handle instance) {
 
   //initialize remaining values
   PS->OutputEnabled = false;
-  PS->SetPinsHighActionNeeded = false;
   PS->OnOffDelay_counter = 0;
   PS->MuteAndFade_counter = 0;
-  
+
+  char label[TELEMETRY_LABEL_SIZE], info[TELEMETRY_INFO_SIZE];
+  snprintf(label, sizeof(label), (pluginData->num_channels == 1) ? "OnOffDelay" : "OnOffDelay%u", pluginData->num_channels);
+  snprintf(info, sizeof(info), "DelayOFF %gs, %u GPIO(s)", PS->DelayOFF, PS->GPIO_lines.num_lines);
+  telemetry_open(&PS->meter, label, info, pluginData->num_channels, PS->sample_rate);
 } //end Activate_Plugin
 
 
-void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
+static inline void Write_Output(LADSPA_Data *output, const LADSPA_Data *input, unsigned long sample_count,
+                                const LADSPA_Data multiplier, const bool adding, const LADSPA_Data gain) {
+  //writes the input multiplied by multiplier to the output. A multiplier of zero
+  //  mutes the output. When adding is true the result, multiplied by the 
+  //  run_adding gain, is added to the output instead.
+  unsigned long pos;
+  if (adding) {
+    if (multiplier == 0.0) return;
+    for (pos = 0; pos < sample_count; pos++) output[pos] += gain * multiplier * input[pos];
+  } else if (multiplier == 0.0) {
+    for (pos = 0; pos < sample_count; pos++) output[pos] = 0.0;
+  } else if (multiplier == 1.0) {
+    for (pos = 0; pos < sample_count; pos++) output[pos] = input[pos];
+  } else {
+    for (pos = 0; pos < sample_count; pos++) output[pos] = input[pos] * multiplier;
+  }
+} //end Write_Output
+
+
+static inline void Write_Outputs(PluginDataContainer *pluginData, unsigned long sample_count, const LADSPA_Data multiplier,
+                                 const LADSPA_Data level[], const bool adding) {
+  //writes all channels with the same multiplier, times the level of each channel
+  for (unsigned int ch = 0; ch < pluginData->num_channels; ch++) {
+    Write_Output(pluginData->output[ch], pluginData->input[ch], sample_count, multiplier * level[ch],
+                 adding, pluginData->Parameters->run_adding_gain);
+  }
+} //end Write_Outputs
+
+
+static inline void Process_Plugin(LADSPA_Handle instance, unsigned long sample_count, const bool adding) {
+  //the output replaces the contents of the output buffer (run) or is multiplied
+  //  by the run_adding gain and added to it (run_adding). All channels are
+  //  switched together, triggered by the highest peak of any channel.
   PluginDataContainer *pluginData = (PluginDataContainer *)instance;
-  const LADSPA_Data *ch1_input = pluginData->ch1_input;
-  LADSPA_Data *ch1_output = pluginData->ch1_output;
   ParameterStorage *PS = pluginData->Parameters;
 
   LADSPA_Data signal_peak = 0.0;
+  LADSPA_Data peak[ONOFF_MAX_CHANNELS], level[ONOFF_MAX_CHANNELS];
   bool have_input_signal;
-  unsigned long pos;
 
-  //if SetPinsHighActionNeeded has been set to true in a previous call, set the output pin(s) HIGH and
-  //  reset the SetPinsHighActionNeeded flag
-  if (PS->SetPinsHighActionNeeded) {
-    //set pins in PinIndexList to 'on' state
-    for (unsigned int j=0; j < PS->PinCount; j++) set_GPIO_state(PS->PinIndexList[j], GPIO_ON, PS->index_to_GPIO_map);
-    //reset flag
-    PS->SetPinsHighActionNeeded = false;
-  }
+  //search over the inputs for the highest level of each channel in this frame
+  CPU_DISPATCH_SELECT(find_signal_peaks, PS->isa)(pluginData->input, pluginData->num_channels, sample_count, peak);
 
-  //search over the input for the highest level in this frame  
-  for (pos = 0; pos < sample_count; pos++) signal_peak = std::max( std::abs( ch1_input[pos] ), signal_peak);
+  //an input below SILENCE_THRESHOLD is passed on as exact zeros, so that the
+  //  silence gates of the plugins that follow can close (see silence_gate.h)
+  for (unsigned int ch = 0; ch < pluginData->num_channels; ch++) {
+    level[ch] = (peak[ch] < SILENCE_THRESHOLD) ? 0.0 : 1.0;
+    signal_peak = std::max(peak[ch], signal_peak);
+  }
 
   //check to see if any peaks > Threshold were detected during the frame
   if (signal_peak > PS->Threshold)
@@ -454,8 +488,8 @@ void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
     if ( (PS->OnOffDelay_counter / PS->sample_rate) > PS->DelayON ) {
       PS->OutputEnabled = true;
       PS->OnOffDelay_counter = 0;
-      //set the PS->SetPinsHighActionNeeded flag to set pins to 'on'  
-      PS->SetPinsHighActionNeeded = true;
+      //set pins in PinIndexList to 'on' state
+      request_gpio_state(&PS->GPIO_lines, GPIO_ON);
       //determine how many buffers span the delay period (signal is muted during this time)
       PS->BuffersOfMuting = (unsigned int)( 0.5+(PS->sample_rate/sample_count)*PS->TurnOnMuteDuration );
       PS->BuffersOfFadeIn = (unsigned int)( 0.5+(PS->sample_rate/sample_count)*PS->TurnOnFadeInDuration );
@@ -480,7 +514,7 @@ void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
       PS->OutputEnabled = false;
       PS->OnOffDelay_counter = 0;
       //set pins in PinIndexList to 'off' state
-      for (unsigned int j=0; j < PS->PinCount; j++) set_GPIO_state(PS->PinIndexList[j], GPIO_OFF, PS->index_to_GPIO_map);
+      request_gpio_state(&PS->GPIO_lines, GPIO_OFF);
     }
   }
   
@@ -489,37 +523,27 @@ void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
     //test if PassThru is true...
     if ( PS->PassThru )
       //continue to pass the input signal to the output
-      for (pos = 0; pos < sample_count; pos++) {
-        ch1_output[pos] = ch1_input[pos];
-      }
+      Write_Outputs(pluginData, sample_count, 1.0, level, adding);
     else
       //set output values to 0.0
-      for (pos = 0; pos < sample_count; pos++) {
-        ch1_output[pos] = 0.0;
-      }
+      Write_Outputs(pluginData, sample_count, 0.0, level, adding);
     return;
   }  
   //if we get here, output is enabled. Determine output mode and set output values
   if (PS->MuteAndFade_counter == 0) {
   //when MuteAndFade_counter == 0 normal output mode is ocurring, so pass input to output and return
-    for (pos = 0; pos < sample_count; pos++) {
-      ch1_output[pos] = ch1_input[pos];
-    }
+    Write_Outputs(pluginData, sample_count, 1.0, level, adding);
     return;
   }
   //if we get here, operation is in DelayAndFadeIn mode 
   if (PS->MuteAndFade_counter < PS->BuffersOfMuting) {
     //delay (mute) the output 
-    for (pos = 0; pos < sample_count; pos++) {
-      ch1_output[pos] = 0.0;
-    }
+    Write_Outputs(pluginData, sample_count, 0.0, level, adding);
   }
   else
   {
     //apply the mutliplier to the output to fade up the level
-    for (pos = 0; pos < sample_count; pos++) {
-      ch1_output[pos] = ch1_input[pos]*PS->FadeMultiplier;
-    }
+    Write_Outputs(pluginData, sample_count, PS->FadeMultiplier, level, adding);
     //increase the multiplier by the FadeUpFactor
     PS->FadeMultiplier *= PS->FadeUpFactor;
   }
@@ -528,13 +552,43 @@ void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
   //check if the delay and fade has completed and, if so, reset the counter to enter normal output mode
   if ( PS->MuteAndFade_counter > (PS->BuffersOfMuting + PS->BuffersOfFadeIn) ) PS->MuteAndFade_counter = 0;
 
+} //end Process_Plugin
+
+
+static inline void Meter_Plugin(LADSPA_Handle instance, unsigned long sample_count, const int64_t start) {
+  //the state is off while the output, and the GPIOs, are switched off
+  PluginDataContainer *pluginData = (PluginDataContainer *)instance;
+  ParameterStorage *PS = pluginData->Parameters;
+  const unsigned int state = PS->OutputEnabled ? TELEMETRY_ACTIVE : TELEMETRY_OFF;
+  telemetry_update(&PS->meter, pluginData->output, sample_count, state, start);
+}
+
+
+void Run_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((PluginDataContainer *)instance)->Parameters->meter);
+  Process_Plugin(instance, sample_count, false);
+  Meter_Plugin(instance, sample_count, start);
 } //end Run_Plugin
 
 
+void Run_Adding_Plugin(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((PluginDataContainer *)instance)->Parameters->meter);
+  Process_Plugin(instance, sample_count, true);
+  Meter_Plugin(instance, sample_count, start);
+} //end Run_Adding_Plugin
+
+
+void Set_Run_Adding_Gain(LADSPA_Handle instance, LADSPA_Data gain) {
+  PluginDataContainer *pluginData = (PluginDataContainer *)instance;
+  pluginData->Parameters->run_adding_gain = gain;
+}
+
+
 void Free_Allocated_Storage(LADSPA_Handle instance) {
   PluginDataContainer *pluginData = (PluginDataContainer *)instance;
   ParameterStorage *PS = pluginData->Parameters;
-  GPIO_teardown (PS->PinIndexList, PS->PinCount, PS->index_to_GPIO_map);
+  stop_gpio_lines(&PS->GPIO_lines);
+  telemetry_close(&PS->meter);
   free(pluginData->Parameters);
   free(instance);
 }
@@ -547,27 +601,41 @@ public:
     char **port_names;
     LADSPA_PortDescriptor *port_descriptors;
     LADSPA_PortRangeHint *port_range_hints;
-    PluginDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+    LADSPA_Descriptor *descriptor;
     std::string text;
-    const unsigned long num_ports = 8;
-  
-    if (PluginDescriptor) {
-      //plugin descriptor info
-      PluginDescriptor->UniqueID = 5223;
-      PluginDescriptor->Label = "OnOffDelay";
-      PluginDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-      PluginDescriptor->Name = "OnOffDelay v2.0: Toggle GPIO pins with on- and off-delay behavior";
-      PluginDescriptor->Maker = "Charlie Laub, 2018";
-      PluginDescriptor->Copyright = "GPLv3";
-      PluginDescriptor->PortCount = num_ports;
+    unsigned long num_ports, port;
+
+    for (unsigned int index = 0; index < ONOFF_MAX_CHANNELS; index++) {
+      PluginDescriptor[index] = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+      descriptor = PluginDescriptor[index];
+      if (!descriptor) continue;
+      const unsigned int channels = index + 1;
+      num_ports = ONOFF_NUM_PORTS(channels);
+
+      //plugin descriptor info. The single channel plugin keeps its original ID and label
+      if (channels == 1) {
+        descriptor->UniqueID = 5223;
+        descriptor->Label = "OnOffDelay";
+        descriptor->Name = "OnOffDelay v2.0: Toggle GPIO pins with on- and off-delay behavior";
+      } else {
+        descriptor->UniqueID = ONOFF_FIRST_MULTI_ID + index - 1;
+        text = "OnOffDelay" + to_string(channels);
+        descriptor->Label = strdup(text.c_str());
+        text = "OnOffDelay v2.0: Toggle GPIO pins with on- and off-delay behavior, " + to_string(channels) + " channels";
+        descriptor->Name = strdup(text.c_str());
+      }
+      descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      descriptor->Maker = "Charlie Laub, 2018";
+      descriptor->Copyright = "GPLv3";
+      descriptor->PortCount = num_ports;
   
       //create storage for port_descriptors, port_range_hints, and port_names        
       port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
-      PluginDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
       port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
-      PluginDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
       port_names = (char **)calloc(num_ports, sizeof(char*));
-      PluginDescriptor->PortNames = (const char **)port_names;
+      descriptor->PortNames = (const char **)port_names;
       //done creating storage. now set the descriptor, range_hints, and name for each port:
  
       //ports for user parameters are numbered 0-5     
@@ -611,39 +679,44 @@ public:
       port_range_hints[5].LowerBound = 0;
       port_range_hints[5].UpperBound = 1.0;
   
-      //port = audio input 1    
-      port_descriptors[6] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-      text = "input_1";
-      port_names[6] = strdup(text.c_str());
-      port_range_hints[6].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE;
-      port_range_hints[6].LowerBound = -1.0;
-      port_range_hints[6].UpperBound = +1.0;
-  
-      //port = audio output 1
-      port_descriptors[7] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-      text = "output_1";
-      port_names[7] = strdup(text.c_str());
-      port_range_hints[7].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE;
-      port_range_hints[7].LowerBound = -1.0;
-      port_range_hints[7].UpperBound = +1.0;
+      //ports = audio inputs and outputs, named input_1 ... input_N and output_1 ... output_N
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        port = ONOFF_INPUT + ch;
+        port_descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+        text = "input_" + to_string(ch + 1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE;
+        port_range_hints[port].LowerBound = -1.0;
+        port_range_hints[port].UpperBound = +1.0;
+
+        port = ONOFF_OUTPUT(channels) + ch;
+        port_descriptors[port] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+        text = "output_" + to_string(ch + 1);
+        port_names[port] = strdup(text.c_str());
+        port_range_hints[port].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE;
+        port_range_hints[port].LowerBound = -1.0;
+        port_range_hints[port].UpperBound = +1.0;
+      }
   
       //specify the names of functions that will be called by LADSPA  
-      PluginDescriptor->activate = Activate_Plugin;
-      PluginDescriptor->cleanup = Free_Allocated_Storage;
-      PluginDescriptor->connect_port = Connect_Plugin_Ports;
-      PluginDescriptor->deactivate = NULL;
-      PluginDescriptor->instantiate = Instantiate_Plugin;
-      PluginDescriptor->run = Run_Plugin;
-      PluginDescriptor->run_adding = NULL;
-      PluginDescriptor->set_run_adding_gain = NULL;
+      descriptor->activate = Activate_Plugin;
+      descriptor->cleanup = Free_Allocated_Storage;
+      descriptor->connect_port = Connect_Plugin_Ports;
+      descriptor->deactivate = NULL;
+      descriptor->instantiate = Instantiate_Plugin;
+      descriptor->run = Run_Plugin;
+      descriptor->run_adding = Run_Adding_Plugin;
+      descriptor->set_run_adding_gain = Set_Run_Adding_Gain;
     }
   }
   ~Initialiser() {
-    if (PluginDescriptor) {
-      free((LADSPA_PortDescriptor *)PluginDescriptor->PortDescriptors);
-      free((char **)PluginDescriptor->PortNames);
-      free((LADSPA_PortRangeHint *)PluginDescriptor->PortRangeHints);
-      free(PluginDescriptor);
+    for (unsigned int index = 0; index < ONOFF_MAX_CHANNELS; index++) {
+      if (PluginDescriptor[index]) {
+        free((LADSPA_PortDescriptor *)PluginDescriptor[index]->PortDescriptors);
+        free((char **)PluginDescriptor[index]->PortNames);
+        free((LADSPA_PortRangeHint *)PluginDescriptor[index]->PortRangeHints);
+        free(PluginDescriptor[index]);
+      }
     }
   }
 } g_theInitialiser;                                      
@@ -0,0 +1,249 @@
+/* OnOffDelay_gpio.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  The GPIO outputs of the OnOffDelay LADSPA plugin.
+
+  Switching a GPIO takes system calls that may block, and exporting a GPIO
+  through sysfs takes the kernel and udev up to a few hundred milliseconds, so
+  this is not done by run. Each plugin instance has a worker thread that owns
+  its GPIO lines. run stores the requested state (on or off) together with a
+  sequence number in one atomic word and wakes the worker with sem_post,
+  neither of which blocks. Only the most recent request matters, so a new
+  request replaces the previous one even if the worker has not seen it yet,
+  e.g. while it waits for udev to set up a sysfs GPIO. The worker sets all
+  lines of the instance at once to the state of the latest request.
+
+  The lines are opened once, when the plugin is activated, and stay open
+  until it is cleaned up. The GPIO character device GPIO_CHIP is used if
+  possible: all lines are requested as outputs in one request and are set
+  together with one ioctl. This is the interface of current kernels and does
+  not need a helper library. If the character device cannot be used, the
+  lines are exported through the sysfs interface GPIO_SYSFS and their value
+  files are kept open.
+
+  The paths of the character device and sysfs start with the directory in the
+  environment variable GSASYSCON_GPIO_ROOT, if it is set, so the plugin can be
+  tried out with a directory of ordinary files instead of real GPIOs. Such a
+  directory needs the files sys/class/gpio/export, sys/class/gpio/unexport and
+  sys/class/gpio/gpioN/direction and sys/class/gpio/gpioN/value for each GPIO N.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ONOFFDELAY_GPIO_H
+#define ONOFFDELAY_GPIO_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <atomic>
+#include <string>
+#include <iostream>
+
+#define GPIO_ON 1
+#define GPIO_OFF 0
+#define GPIO_ROOT_VARIABLE "GSASYSCON_GPIO_ROOT"  //directory that the paths below start with
+#define GPIO_CHIP          "/dev/gpiochip0"       //the GPIO numbers are the line numbers of this chip
+#define GPIO_SYSFS         "/sys/class/gpio"
+#define GPIO_CONSUMER      "OnOffDelay"           //shown as the user of the lines, e.g. by gpioinfo
+#define GPIO_MAX_LINES        7  //largest number of GPIOs of one plugin instance
+#define GPIO_EXPORT_WAIT_MS 1000  //longest wait for udev to set up an exported sysfs GPIO
+
+
+typedef struct {
+  unsigned int num_lines;
+  int gpio[GPIO_MAX_LINES]; //the GPIO numbers
+  int handle; //file descriptor of the lines requested from the character device, or -1
+  int value_file[GPIO_MAX_LINES]; //the open sysfs value files, or -1
+  //the latest request, written by run: its sequence number times 2 plus the state.
+  //  The worker applies a request once, when it sees a new sequence number.
+  std::atomic<unsigned int> request;
+  sem_t wake;
+  pthread_t thread;
+  bool running; //the worker thread has been started
+  std::atomic<bool> stop;
+} gpio_lines;
+
+
+static std::string gpio_path(const char *path) {
+  //the path of the character device or sysfs, below GSASYSCON_GPIO_ROOT if it is set
+  const char *root = getenv(GPIO_ROOT_VARIABLE);
+  return std::string(root ? root : "") + path;
+}
+
+
+static bool write_gpio_file(const std::string &path, const char *text) {
+  //writes text to a sysfs file. Returns false if the file cannot be written.
+  int file = open(path.c_str(), O_WRONLY);
+  if (file < 0) return false;
+  const ssize_t length = strlen(text);
+  const bool written = (write(file, text, length) == length);
+  close(file);
+  return written;
+}
+
+
+static bool open_gpio_chip(gpio_lines *g) {
+  //requests all lines as outputs from the character device, initially off
+  struct gpiohandle_request request;
+  const std::string path = gpio_path(GPIO_CHIP);
+  int chip = open(path.c_str(), O_RDWR | O_CLOEXEC);
+  if (chip < 0) return false;
+  memset(&request, 0, sizeof(request));
+  for (unsigned int j = 0; j < g->num_lines; j++) {
+    request.lineoffsets[j] = g->gpio[j];
+    request.default_values[j] = GPIO_OFF;
+  }
+  request.lines = g->num_lines;
+  request.flags = GPIOHANDLE_REQUEST_OUTPUT;
+  strncpy(request.consumer_label, GPIO_CONSUMER, sizeof(request.consumer_label) - 1);
+  const bool requested = (ioctl(chip, GPIO_GET_LINEHANDLE_IOCTL, &request) == 0);
+  if (!requested) std::cerr << "OnOffDelay: the GPIOs could not be requested from " << path << ": " << strerror(errno) << std::endl;
+  close(chip);
+  if (requested) g->handle = request.fd;
+  return requested;
+} //end open_gpio_chip
+
+
+static bool open_gpio_sysfs(gpio_lines *g) {
+  //exports the GPIOs through sysfs, sets them to outputs and opens their value
+  //  files. Returns false if one of them fails.
+  const std::string sysfs = gpio_path(GPIO_SYSFS);
+  const struct timespec pause = { 0, 10000000 }; //10ms
+  bool opened = true;
+  for (unsigned int j = 0; j < g->num_lines; j++) {
+    const std::string number = std::to_string(g->gpio[j]);
+    const std::string gpio = sysfs + "/gpio" + number;
+    //an export fails if the GPIO is already exported, which does no harm
+    const bool exported = write_gpio_file(sysfs + "/export", number.c_str()) || access(gpio.c_str(), F_OK) == 0;
+    //udev makes the files of a new GPIO writable shortly after the export
+    bool output = false;
+    for (int waited = 0; exported && !output && waited <= GPIO_EXPORT_WAIT_MS; waited += 10) {
+      output = write_gpio_file(gpio + "/direction", "out");
+      if (!output) nanosleep(&pause, NULL);
+    }
+    if (output) g->value_file[j] = open((gpio + "/value").c_str(), O_WRONLY | O_CLOEXEC);
+    if (g->value_file[j] < 0) {
+      std::cerr << "OnOffDelay: ERROR: GPIO " << number << " could not be set up in " << sysfs << std::endl;
+      opened = false;
+    }
+  }
+  return opened;
+} //end open_gpio_sysfs
+
+
+static void set_gpio_lines(gpio_lines *g, const bool state) {
+  //sets all lines to the state
+  if (g->handle >= 0) {
+    struct gpiohandle_data data;
+    memset(&data, 0, sizeof(data));
+    for (unsigned int j = 0; j < g->num_lines; j++) data.values[j] = state;
+    if (ioctl(g->handle, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data) != 0) {
+      std::cerr << "OnOffDelay: ERROR: the GPIOs could not be set" << std::endl;
+    }
+    return;
+  }
+  for (unsigned int j = 0; j < g->num_lines; j++) {
+    if (g->value_file[j] < 0) continue;
+    if (pwrite(g->value_file[j], state ? "1" : "0", 1, 0) != 1) {
+      std::cerr << "OnOffDelay: ERROR: GPIO " << g->gpio[j] << " could not be set" << std::endl;
+    }
+  }
+} //end set_gpio_lines
+
+
+static void close_gpio_lines(gpio_lines *g) {
+  //releases the lines. Sysfs GPIOs are unexported.
+  if (g->handle >= 0) close(g->handle);
+  g->handle = -1;
+  for (unsigned int j = 0; j < g->num_lines; j++) {
+    if (g->value_file[j] < 0) continue;
+    close(g->value_file[j]);
+    g->value_file[j] = -1;
+    write_gpio_file(gpio_path(GPIO_SYSFS) + "/unexport", std::to_string(g->gpio[j]).c_str());
+  }
+} //end close_gpio_lines
+
+
+static void *gpio_worker(void *data) {
+  gpio_lines *g = (gpio_lines *)data;
+  unsigned int applied = 0; //the last request that was applied. Request 0 is the initial off state.
+  if (open_gpio_chip(g)) {
+    std::cout << "OnOffDelay: " << g->num_lines << " GPIO(s) opened on " << gpio_path(GPIO_CHIP) << std::endl;
+  } else if (open_gpio_sysfs(g)) {
+    std::cout << "OnOffDelay: " << g->num_lines << " GPIO(s) opened in " << gpio_path(GPIO_SYSFS) << std::endl;
+  }
+  for (;;) {
+    if (sem_wait(&g->wake) != 0 && errno == EINTR) continue;
+    //only the most recent request matters, the earlier ones were replaced
+    const unsigned int request = g->request.load(std::memory_order_acquire);
+    if ((request >> 1) != (applied >> 1)) {
+      set_gpio_lines(g, request & 1);
+      applied = request;
+    }
+    if (g->stop.load()) break;
+  }
+  close_gpio_lines(g);
+  return NULL;
+} //end gpio_worker
+
+
+static void request_gpio_state(gpio_lines *g, const bool state) {
+  //called by run. Replaces the previous request with the state, without blocking.
+  //  run is the only writer, so the sequence number is simply incremented.
+  if (!g->running) return;
+  const unsigned int sequence = (g->request.load(std::memory_order_relaxed) >> 1) + 1;
+  g->request.store((sequence << 1) | (state ? 1 : 0), std::memory_order_release);
+  sem_post(&g->wake);
+} //end request_gpio_state
+
+
+static void start_gpio_lines(gpio_lines *g, const int gpio[], const unsigned int num_lines) {
+  //starts the worker for the GPIOs. The lines are opened by the worker, so
+  //  this returns without waiting for the export of sysfs GPIOs.
+  g->num_lines = 0;
+  for (unsigned int j = 0; j < num_lines && g->num_lines < GPIO_MAX_LINES; j++) g->gpio[g->num_lines++] = gpio[j];
+  g->handle = -1;
+  for (unsigned int j = 0; j < GPIO_MAX_LINES; j++) g->value_file[j] = -1;
+  g->request.store(0);
+  g->stop.store(false);
+  g->running = false;
+  if (g->num_lines == 0) return;
+  if (sem_init(&g->wake, 0, 0) != 0) return;
+  g->running = (pthread_create(&g->thread, NULL, gpio_worker, g) == 0);
+  if (!g->running) {
+    sem_destroy(&g->wake);
+    std::cerr << "OnOffDelay: ERROR: the GPIO thread could not be started" << std::endl;
+  }
+} //end start_gpio_lines
+
+
+static void stop_gpio_lines(gpio_lines *g) {
+  //applies the latest request, releases the lines and stops the worker
+  if (!g->running) return;
+  g->stop.store(true);
+  sem_post(&g->wake);
+  pthread_join(g->thread, NULL);
+  sem_destroy(&g->wake);
+  g->running = false;
+} //end stop_gpio_lines
+
+#endif
@@ -7,6 +7,10 @@
   is truncated. Higher values of SNR better match the full impulse tail
   of the AP filter but give rise to higher latency (delay) of the output
   signal. A conservative value for SNR is 80.
+  With mode=1 the filter is calculated by block time reversal instead, and
+  the latency and memory are set by the block size (see riir_stages.h).
+  The latency is reported by the latency port, so that the host can delay
+  other channels by the same amount.
 
   This program is free software: you can redistribute it and/or modify
   it under the terms of the GNU General Public License as published by
@@ -37,8 +41,11 @@
 #include <math.h>
 #include <ladspa.h>
 #include <string>
-#include <vector>
 #include <complex>
+#include "silence_gate.h"
+#include "cpu_dispatch.h"
+#include "riir_stages.h"
+#include "telemetry.h"
 using namespace std;
 
 
@@ -47,24 +54,25 @@ using namespace std;
 #define RIIRAP1_SNR       1 
 #define RIIRAP1_INPUT     2 
 #define RIIRAP1_OUTPUT    3 
+#define RIIRAP1_MODE      4  //0 = cascade of stages, 1 = block time reversal
+#define RIIRAP1_BLOCK     5  //block size of block time reversal. 0 = automatic
+#define RIIRAP1_LATENCY   6  //output: delay of the output, in samples
 
 
 static LADSPA_Descriptor *RIIRAP1_Descriptor = NULL;
 
 typedef struct {
-  double a;
-  vector<double> past_x_inputs; //buffer to hold recent inputs (real pipeline)
-  unsigned int cb_index; //circular buffer read/write index
-  unsigned int cb_size; //size of circular buffer
-} RPstage_data_struct;
-
-
-typedef struct {
-  unsigned short num_RP1stages; //number of stages used in calculation for real pole
-  double RP1; // " "
-  LADSPA_Data x1; //one input sample ago
+  double RP1; //the real pole
+  double x1; //one input sample ago
   unsigned long startup_samples;
-  unsigned int instance_index; //the index of the correct num_RP1stages vectors
+  unsigned long latency; //delay of the output, in samples
+  int mode; //RIIR_MODE_CASCADE or RIIR_MODE_BLOCK, set at activation
+  riir_chain RP1chain; //the stages of the real pole. num_stages is the number of stages used
+  riir_reverser reverser; //block time reversal
+  void *arena; //storage of the stages, see riir_stages.h. NULL until activated
+  double *work[2]; //the block buffers of the stages, in the arena
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
 } per_instance_data_struct;
 
 
@@ -73,23 +81,19 @@ typedef struct {
   //  and other instance-specific data 
   LADSPA_Data *fp_ptr;
   LADSPA_Data *SNR_ptr;
+  LADSPA_Data *mode_ptr;
+  LADSPA_Data *block_ptr;
   LADSPA_Data *input_ptr;
   LADSPA_Data *output_ptr;
+  LADSPA_Data *latency_ptr;
   float SR; //sample rate of the data stream
-  unsigned int instance_data_index; //points to the correct instance data
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  int isa; //instruction set of the processing kernel, see cpu_dispatch.h
+  per_instance_data_struct instance_data; //the filter of this instance. There is no shared storage,
+                                          //  so instances can run in different threads.
 } plugin_data_struct;
 
 
-//dedlare global storage that will be available to all procs in this file:
-//  NOTE: these data structures will be shared by ALL INSTANCES of this plugin 
-//    that are created by the host! The data for eahc instance is differentiated
-//    using the outer vector index 
-//storage involved in calculating the real pole
-  static vector< vector<RPstage_data_struct> > RP1stage; //stores data for each reverse IIR RPstage, real pole 1
-//storage for instance data. The instances are differentiated using the vector index
-  static vector<per_instance_data_struct> instance_data;
-
-
 
 const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
   switch (index) {
@@ -103,9 +107,12 @@ const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
 
 LADSPA_Handle RIIRAP1_instantiate(const LADSPA_Descriptor *descriptor, unsigned long sample_rate) {
   //one-liner to create a pointer to a plugin_data_struct and allocate its memory 
-  plugin_data_struct *plugin_data = (plugin_data_struct *)malloc(sizeof(plugin_data_struct));
+  plugin_data_struct *plugin_data = (plugin_data_struct *)calloc(1, sizeof(plugin_data_struct));
+  if (!plugin_data) return NULL;
   //Use the pointer to store the sample rate
   plugin_data->SR = (float)sample_rate;
+  plugin_data->run_adding_gain = 1.0;
+  plugin_data->isa = select_cpu_isa("RIIR_AP1");
   //return the pointer plugin_data to the LADSPA host 
   return (LADSPA_Handle)plugin_data; 
 }
@@ -126,6 +133,15 @@ void RIIRAP1_connectPort(LADSPA_Handle instance, unsigned long port, LADSPA_Data
   case RIIRAP1_OUTPUT:
     plugin_data->output_ptr = data;
     break;
+  case RIIRAP1_MODE:
+    plugin_data->mode_ptr = data;
+    break;
+  case RIIRAP1_BLOCK:
+    plugin_data->block_ptr = data;
+    break;
+  case RIIRAP1_LATENCY:
+    plugin_data->latency_ptr = data;
+    break;
   }
 }
 
@@ -137,102 +153,193 @@ void RIIRAP1_activate(LADSPA_Handle instance) {
   LADSPA_Data Fp = *(plugin_data->fp_ptr); 
   LADSPA_Data SNR = *(plugin_data->SNR_ptr);
   double RP1;
-  unsigned int ii, idi;
+  per_instance_data_struct *id = &plugin_data->instance_data;
   const double Wp = 2.0*M_PI*Fp; //for analog radian frequency
   const double K = 2.0*plugin_data->SR;
 
-  //push back a new instance_data and store the index of it in plugin_data
-  instance_data.push_back(per_instance_data_struct() );
-  plugin_data->instance_data_index = idi = instance_data.size()-1;
+  //free the storage of a previous activation
+  free(id->arena);
+  id->arena = NULL;
 
   //initialize past samples x1, x2 to zero in instance_data:
-  instance_data[idi].x1 = 0.0;
+  id->x1 = 0.0;
 
   //calculate the real pole from the Fpole specification. Adopted from :
   //https://ccrma.stanford.edu/~jos/pasp/Classic_Virtual_Analog_Phase.html
-  instance_data[idi].RP1 = RP1 = (1.0 - tan( Wp/K ))/(1.0 + tan( Wp/K ));
-  //Initialize storage and parameters for each pole separately
-  //push back a new instance of RP1stage and RP2stage
-  RP1stage.push_back( vector<RPstage_data_struct>() );
-  //set the plugin_data's instance_index, and the local variable id, to RP1stage.size()-1
-  instance_data[idi].instance_index = ii = RP1stage.size()-1;
+  id->RP1 = RP1 = (1.0 - tan( Wp/K ))/(1.0 + tan( Wp/K ));
+
+  id->mode = ( *(plugin_data->mode_ptr) >= 0.5 ) ? RIIR_MODE_BLOCK : RIIR_MODE_CASCADE;
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "Fp %g, %s mode", Fp, ( id->mode == RIIR_MODE_BLOCK ) ? "block" : "cascade");
+  telemetry_open(&id->meter, "RIIR_AP1", info, 1, plugin_data->SR);
+  if ( id->mode == RIIR_MODE_BLOCK ) {
+    //block time reversal of the pole 1/(1 - RP1 z^-1), with blocks of block_size samples.
+    //  The numerator is RP1*x1 - x, see RIIRAP1_block.
+    const riir_allpass filter = { -RP1, 0.0, 0.0, RP1, -1.0 };
+    const unsigned long block_size = riir_block_size(*(plugin_data->block_ptr), &filter, 1, SNR);
+    id->latency = 2*block_size + 1;
+    if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+    id->arena = riir_alloc_reverser(&id->reverser, &filter, 1, block_size, id->work);
+    if (!id->arena) {
+      cout << "RIIR_AP1: ERROR: out of memory for blocks of " << block_size << " samples. The output is silent." << endl;
+      return;
+    }
+    //the blocks start out cleared, so nothing is muted
+    id->startup_samples = 0;
+    //the blocks hold 2*block_size samples and x1 one
+    set_silence_gate(&id->gate, 2*block_size + 1);
+    cout << "For the RIIR_AP1 instance with Fp = " << Fp << " in block mode:" << endl;
+    cout << "   blocks of " << block_size << " samples use " << riir_reverser_size(block_size, 1) / 1024 << " kB of memory." << endl;
+    cout << "The latency produced by the reverse-IIR processing will be:" << endl;
+    cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+    cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;
+    cout << "The error from truncating the impulse response is " << setprecision(1) << riir_truncation_dB(&filter, 1, block_size) << " dB." << endl;
+    return;
+  }
 
   //begin RP1 initializations:
   //calculate num_RP1stages, the required numer of stages, using SNR and ABS(c).
   //  the number of required stages is rounded to the nearest integer
-   //calculate real poles RP1 and RP2 from biquad coefficients:
-  //proceed first with RP1: 
-  instance_data[idi].num_RP1stages = trunc( 0.5 + log2( -SNR / (20.0*log10( instance_data[idi].RP1 ) ) ) );
-  //resize the RP1stage[] vector
-  RP1stage[ii].resize(instance_data[idi].num_RP1stages+1); //the +1 is because there is a 0th stage
-  //loop over CCstage vector and peform setup tasks:
-  for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP1stages; stage_index++) {
-    RP1stage[ii][stage_index].cb_size = pow(2,stage_index); //calc the circular buffer size
-    // resize vector to hold cb_size values and fill with zeroes :
-    RP1stage[ii][stage_index].past_x_inputs.assign( RP1stage[ii][stage_index].cb_size, 0.0 );
+  id->RP1chain.num_stages = trunc( 0.5 + log2( -SNR / (20.0*log10( id->RP1 ) ) ) );
+  id->RP1chain.is_complex = false;
+  //each stage delays by the size of its buffer, 2^stage_index, and the numerator by
+  //  one sample, so the output is delayed by 2^(num_stages+1) samples
+  id->latency = 2ul << id->RP1chain.num_stages;
+  //the latency is also reported by run, in case the port is connected later
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  //allocate the stages and their circular buffers, sized 2^stage_index, in one arena
+  id->arena = riir_alloc_chains(&id->RP1chain, 1, id->work);
+  if (!id->arena) {
+    cout << "RIIR_AP1: ERROR: out of memory for " << id->RP1chain.num_stages << " stages. The output is silent." << endl;
+    return;
+  }
+  //loop over the stages and calculate the coefficients:
+  for (unsigned int stage_index=0; stage_index<=id->RP1chain.num_stages; stage_index++) {
     // calculate a value for each stage from c:
-    RP1stage[ii][stage_index].a = pow( RP1, pow( 2, stage_index ) ); //calculate c^2^N 
-    RP1stage[ii][stage_index].cb_index = 0; //set an arbitrary start value for the c.b.
+    id->RP1chain.stage[stage_index].a = pow( RP1, pow( 2, stage_index ) ); //calculate c^2^N 
   } //end for-loop over RP1 stages
   //done with RP1 initializations:
 
   //store the number of output samples that should be set to zero at startup
-  instance_data[idi].startup_samples = pow(2, instance_data[idi].num_RP1stages);
-  //report the latency
+  id->startup_samples = pow(2, id->RP1chain.num_stages);
+  //the response is truncated, so the stages hold only zeros once as many silent
+  //  samples have passed through as the stage buffers (2*startup_samples - 1)
+  //  and x1 hold
+  set_silence_gate(&id->gate, 2*id->startup_samples);
   cout << "For the RIIR_AP1 instance with Fp = " << Fp << ", and SNR = " << SNR << ":" << endl;
-  cout << "   " << instance_data[idi].num_RP1stages << " stages are required for the real pole." << endl;
+  cout << "   " << id->RP1chain.num_stages << " stages are required for the real pole. They use ";
+  cout << riir_chains_size(&id->RP1chain, 1) / 1024 << " kB of memory." << endl;
   cout << "The latency produced by the reverse-IIR processing will be:" << endl;
-  cout << "   " << instance_data[idi].startup_samples << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
-  cout << fixed << setprecision(3) << 1000.0* instance_data[idi].startup_samples / plugin_data->SR << " milliseconds." << endl;    
+  cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+  cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;    
 
 } //end activate_RIIRAP1
 
 
 
 
-void RIIRAP1_run(LADSPA_Handle instance, unsigned long sample_count) {
+static void RIIRAP1_clear(per_instance_data_struct *id) {
+  //clears the stage buffers and x1 of an instance, as when it was activated
+  if (id->mode == RIIR_MODE_BLOCK) riir_clear_reverser(&id->reverser);
+  else riir_clear_chains(&id->RP1chain, 1);
+  id->x1 = 0.0;
+} //end RIIRAP1_clear
+
+
+CPU_KERNEL_INLINE void RIIRAP1_block(per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain,
+                                     const bool adding) {
+  //filters a block of up to RIIR_BLOCK samples, one stage at a time
+  double *x = id->work[0];
+  //RIIR calculation of the pole (denominator of TF)
+  if (id->mode == RIIR_MODE_BLOCK) {
+    riir_run_reverser(&id->reverser, input, x, count);
+  } else {
+    for (unsigned long n = 0; n < count; n++) x[n] = input[n];
+    x = riir_run_chain(&id->RP1chain, x, id->work[1], count);
+  }
+  //numerator of the TF, into the other buffer
+  double *y = (x == id->work[0]) ? id->work[1] : id->work[0];
+  const double RP1 = id->RP1;
+  y[0] = RP1 * id->x1 - x[0];
+  for (unsigned long n = 1; n < count; n++) y[n] = RP1 * x[n-1] - x[n];
+  id->x1 = x[count-1];
+  riir_write_output(y, output, count, muted, gain, adding);
+} //end RIIRAP1_block
+
+CPU_DISPATCH_KERNELS(RIIRAP1_block, (per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain, const bool adding),
+                     (id, input, output, count, muted, gain, adding))
+
+
+static inline void RIIRAP1_process(LADSPA_Handle instance, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
   plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
   const LADSPA_Data *input = plugin_data->input_ptr;
   LADSPA_Data *output = plugin_data->output_ptr; 
+  const LADSPA_Data gain = plugin_data->run_adding_gain;
+  unsigned long muted; //number of output samples that are discarded during startup
+  unsigned long count;
 
-  double x, y; 
-  unsigned int ii, idi;
-   
-  //get indeces for this particular instance of the plugin:
-  idi = plugin_data->instance_data_index;
-  ii = instance_data[idi].instance_index;   
-  //begin RIIR calculation of poles (denominator of TF)
-  for (unsigned long pos = 0; pos < sample_count; pos++) {
-    x = input[pos];
-    //RP1:      
-    for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP1stages; stage_index++) {
-      y = RP1stage[ii][stage_index].a * x + RP1stage[ii][stage_index].past_x_inputs[RP1stage[ii][stage_index].cb_index]; 
-      RP1stage[ii][stage_index].past_x_inputs[RP1stage[ii][stage_index].cb_index] = x;
-      RP1stage[ii][stage_index].cb_index = ( RP1stage[ii][stage_index].cb_index + 1 ) % RP1stage[ii][stage_index].cb_size;
-      x = y;
-    }
-    //done with RP1. 
-    output[pos] = instance_data[idi].RP1 * instance_data[idi].x1 - x;
-    //update value for x1
-    instance_data[idi].x1 = x;
-  } //end for-loop over samples
-  //test if we are still in the startup period...
-  if ( instance_data[idi].startup_samples > 0 ) {
-    for (unsigned long pos = 0; pos < sample_count; pos++) {
-      //the output should be discarded until startup_samples samples have passed through
-      output[pos] = 0.0;
-      instance_data[idi].startup_samples -= 1;
-      if ( instance_data[idi].startup_samples == 0 ) break;
-    }     
-  } //end check for startup samples
+  per_instance_data_struct *id = &plugin_data->instance_data;
+
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  if (!id->arena) {
+    //not activated, or out of memory
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  //the output should be discarded until startup_samples samples have passed through
+  muted = id->startup_samples;
+  if (muted > sample_count) muted = sample_count;
+  id->startup_samples -= muted;
+  if (silence_gate_skip(&id->gate, is_silent(input, sample_count), sample_count)) {
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  void (*kernel)(per_instance_data_struct *, const LADSPA_Data *, LADSPA_Data *, const unsigned long,
+                 const unsigned long, const LADSPA_Data, const bool) = CPU_DISPATCH_SELECT(RIIRAP1_block, plugin_data->isa);
+  for (unsigned long pos = 0; pos < sample_count; pos += count) {
+    count = (sample_count - pos < RIIR_BLOCK) ? sample_count - pos : RIIR_BLOCK;
+    kernel(id, input + pos, output + pos, count, (muted > pos) ? muted - pos : 0, gain, adding);
+  }
+  if (silence_gate_closing(&id->gate)) RIIRAP1_clear(id);
+} //end RIIRAP1_process
+
+
+static inline void RIIRAP1_meter(LADSPA_Handle instance, unsigned long sample_count, const int64_t start) {
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+  const unsigned int state = id->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&id->meter, &plugin_data->output_ptr, sample_count, state, start);
+}
+
+
+void RIIRAP1_run(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAP1_process(instance, sample_count, false);
+  RIIRAP1_meter(instance, sample_count, start);
 } //end run_RIIRAP1.
 
 
+void RIIRAP1_run_adding(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAP1_process(instance, sample_count, true);
+  RIIRAP1_meter(instance, sample_count, start);
+} //end RIIRAP1_run_adding
+
+
+void RIIRAP1_set_run_adding_gain(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((plugin_data_struct *)instance)->run_adding_gain = gain;
+}
+
+
 
 void RIIRAP1_cleanup(LADSPA_Handle instance) {
-  //free storage used by global data containers
-  RP1stage.clear();
-  instance_data.clear();
+  telemetry_close(&((plugin_data_struct *)instance)->instance_data.meter);
+  //free the stage storage of this instance only
+  free(((plugin_data_struct *)instance)->instance_data.arena);
   //free memory obtained via malloc for the LADSPA plugin interface
   free(instance); 
 }
@@ -246,7 +353,7 @@ public:
     LADSPA_PortDescriptor *port_descriptors;
     LADSPA_PortRangeHint *port_range_hints;
     RIIRAP1_Descriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
-    const unsigned long num_ports = 4;
+    const unsigned long num_ports = 7;
     string text;
 
     if (RIIRAP1_Descriptor) {
@@ -294,14 +401,37 @@ public:
       text = "Output";
       port_names[RIIRAP1_OUTPUT] = strdup(text.c_str());
 
+      //port = calculation method, selected at activation
+      port_descriptors[RIIRAP1_MODE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "mode";
+      port_names[RIIRAP1_MODE] = strdup(text.c_str());
+      port_range_hints[RIIRAP1_MODE].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAP1_MODE].LowerBound = RIIR_MODE_CASCADE;
+      port_range_hints[RIIRAP1_MODE].UpperBound = RIIR_MODE_BLOCK;
+
+      //port = block size of block time reversal, in samples
+      port_descriptors[RIIRAP1_BLOCK] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "block";
+      port_names[RIIRAP1_BLOCK] = strdup(text.c_str());
+      port_range_hints[RIIRAP1_BLOCK].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAP1_BLOCK].LowerBound = 0;
+      port_range_hints[RIIRAP1_BLOCK].UpperBound = RIIR_MAX_BLOCK;
+
+      //port = latency, the delay of the output in samples
+      port_descriptors[RIIRAP1_LATENCY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      text = "latency";
+      port_names[RIIRAP1_LATENCY] = strdup(text.c_str());
+      port_range_hints[RIIRAP1_LATENCY].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[RIIRAP1_LATENCY].LowerBound = 0;
+
       RIIRAP1_Descriptor->activate = RIIRAP1_activate;
       RIIRAP1_Descriptor->cleanup = RIIRAP1_cleanup;
       RIIRAP1_Descriptor->connect_port = RIIRAP1_connectPort;
       RIIRAP1_Descriptor->deactivate = NULL;
       RIIRAP1_Descriptor->instantiate = RIIRAP1_instantiate;
       RIIRAP1_Descriptor->run = RIIRAP1_run;
-      RIIRAP1_Descriptor->run_adding = NULL;
-      RIIRAP1_Descriptor->set_run_adding_gain = NULL;
+      RIIRAP1_Descriptor->run_adding = RIIRAP1_run_adding;
+      RIIRAP1_Descriptor->set_run_adding_gain = RIIRAP1_set_run_adding_gain;
     }
   }
   ~Initialiser() {
@@ -7,6 +7,10 @@
   impulse tail is truncated. Higher values of SNR better match the full
   impulse tail of the AP filter but give rise to higher latency (delay)
   of the output signal. A conservative value for SNR is 80.
+  With mode=1 the filter is calculated by block time reversal instead, and
+  the latency and memory are set by the block size (see riir_stages.h).
+  The latency is reported by the latency port, so that the host can delay
+  other channels by the same amount.
 
   This program is free software: you can redistribute it and/or modify
   it under the terms of the GNU General Public License as published by
@@ -37,8 +41,11 @@
 #include <math.h>
 #include <ladspa.h>
 #include <string>
-#include <vector>
 #include <complex>
+#include "silence_gate.h"
+#include "cpu_dispatch.h"
+#include "riir_stages.h"
+#include "telemetry.h"
 using namespace std;
 
 
@@ -48,40 +55,37 @@ using namespace std;
 #define RIIRAP2_SNR       2 
 #define RIIRAP2_INPUT     3 
 #define RIIRAP2_OUTPUT    4 
+#define RIIRAP2_MODE      5  //0 = cascade of stages, 1 = block time reversal
+#define RIIRAP2_BLOCK     6  //block size of block time reversal. 0 = automatic
+#define RIIRAP2_LATENCY   7  //output: delay of the output, in samples
 
 
 static LADSPA_Descriptor *RIIRAP2_Descriptor = NULL;
 
-typedef struct {
-  double a;
-  double b;
-  vector<double> past_x_inputs; //buffer to hold recent inputs (real pipeline)
-  vector<double> past_y_inputs; //buffer to hold recent inputs (imag pipeline)
-  unsigned int cb_index; //circular buffer read/write index
-  unsigned int cb_size; //size of circular buffer
-} CCstage_data_struct;
-
-
-typedef struct {
-  double a;
-  vector<double> past_x_inputs; //buffer to hold recent inputs (real pipeline)
-  unsigned int cb_index; //circular buffer read/write index
-  unsigned int cb_size; //size of circular buffer
-} RPstage_data_struct;
+//the stage chains of an instance, see riir_stages.h:
+#define RIIRAP2_CC         0  //complex conjugate poles, when Q>0.5
+#define RIIRAP2_RP1        0  //real pole 1, when Q<=0.5
+#define RIIRAP2_RP2        1  //real pole 2, when Q<=0.5
 
 
 typedef struct {
-  unsigned short num_CCstages; //number of complex conjugate stages used in calculations
-  unsigned short num_RP1stages; //number of stages used in calculation for real pole 1
-  unsigned short num_RP2stages; //number of stages used in calculation for real pole 2
+  int mode; //RIIR_MODE_CASCADE or RIIR_MODE_BLOCK, set at activation
+  bool complex_poles; //Q>0.5 at activation: one chain of complex conjugate stages, else two real chains
+  unsigned int num_chains;
+  riir_chain chain[2]; //num_stages is the number of stages used for each pole
+  riir_reverser reverser; //block time reversal, of both poles
+  void *arena; //storage of the stages. NULL until activated
+  double *work[2]; //the block buffers of the stages, in the arena
   double a_over_b; //value used in last CCstage calculation
   LADSPA_Data b0; //forward IIR 2nd order allpass TF coefficients:
   LADSPA_Data b1; // " "
   LADSPA_Data b2; // " "
-  LADSPA_Data x1; //one input sample ago
-  LADSPA_Data x2; //two input samples ago
+  double x1; //one input sample ago
+  double x2; //two input samples ago
   unsigned long startup_samples;
-  unsigned int instance_index; //the index of the correct num_CCstages or num_RP1stages and num_RP2stages vectors
+  unsigned long latency; //delay of the output, in samples
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
 } per_instance_data_struct;
 
 
@@ -91,26 +95,19 @@ typedef struct {
   LADSPA_Data *fp_ptr;
   LADSPA_Data *qp_ptr;
   LADSPA_Data *SNR_ptr;
+  LADSPA_Data *mode_ptr;
+  LADSPA_Data *block_ptr;
   LADSPA_Data *input_ptr;
   LADSPA_Data *output_ptr;
+  LADSPA_Data *latency_ptr;
   float SR; //sample rate of the data stream
-  unsigned int instance_data_index; //points to the correct instance data
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  int isa; //instruction set of the processing kernel, see cpu_dispatch.h
+  per_instance_data_struct instance_data; //the filter of this instance. There is no shared storage,
+                                          //  so instances can run in different threads.
 } plugin_data_struct;
 
 
-//dedlare global storage that will be available to all procs in this file:
-//  NOTE: these data structures will be shared by ALL INSTANCES of this plugin 
-//    that are created by the host! The data for eahc instance is differentiated
-//    using the outer vector index 
-//storage involved in calculating complex poles, when Q>0.5
-  static vector< vector<CCstage_data_struct> > CCstage; //stores data for each reverse IIR CCstage
-//storage involved in calculating real poles, when Q<=0.5
-  static vector< vector<RPstage_data_struct> > RP1stage; //stores data for each reverse IIR RPstage, real pole 1
-  static vector< vector<RPstage_data_struct> > RP2stage; //stores data for each reverse IIR RPstage, real pole 2
-//storage for instance data. The instances are differentiated using the vector index
-  static vector<per_instance_data_struct> instance_data;
-
-
 
 const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
   switch (index) {
@@ -124,9 +121,12 @@ const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
 
 LADSPA_Handle RIIRAP2_instantiate(const LADSPA_Descriptor *descriptor, unsigned long sample_rate) {
   //one-liner to create a pointer to a plugin_data_struct and allocate its memory 
-  plugin_data_struct *plugin_data = (plugin_data_struct *)malloc(sizeof(plugin_data_struct));
+  plugin_data_struct *plugin_data = (plugin_data_struct *)calloc(1, sizeof(plugin_data_struct));
+  if (!plugin_data) return NULL;
   //Use the pointer to store the sample rate
   plugin_data->SR = (float)sample_rate;
+  plugin_data->run_adding_gain = 1.0;
+  plugin_data->isa = select_cpu_isa("RIIR_AP2");
   //return the pointer plugin_data to the LADSPA host 
   return (LADSPA_Handle)plugin_data; 
 }
@@ -150,6 +150,15 @@ void RIIRAP2_connectPort(LADSPA_Handle instance, unsigned long port, LADSPA_Data
   case RIIRAP2_OUTPUT:
     plugin_data->output_ptr = data;
     break;
+  case RIIRAP2_MODE:
+    plugin_data->mode_ptr = data;
+    break;
+  case RIIRAP2_BLOCK:
+    plugin_data->block_ptr = data;
+    break;
+  case RIIRAP2_LATENCY:
+    plugin_data->latency_ptr = data;
+    break;
   }
 }
 
@@ -164,7 +173,7 @@ void RIIRAP2_activate(LADSPA_Handle instance) {
   LADSPA_Data Fp = *(plugin_data->fp_ptr); 
   LADSPA_Data Qp = *(plugin_data->qp_ptr);
   LADSPA_Data SNR = *(plugin_data->SNR_ptr);
-  unsigned int ii, idi;
+  per_instance_data_struct *id = &plugin_data->instance_data;
 
   //TF coefficient calcs adapted from ACDf LADSPA plugin code:
   double Aa0, Aa1, Aa2, Ab0, Ab1, Ab2; //analog TF coefficients
@@ -200,56 +209,93 @@ void RIIRAP2_activate(LADSPA_Handle instance) {
   Da2 /= Da0;
   //done with TF coefficient calcs...
   
-  //push back a new instance_data and store the index of it in plugin_data
-  instance_data.push_back(per_instance_data_struct() );
-  plugin_data->instance_data_index = idi = instance_data.size()-1;
+  //free the storage of a previous activation
+  free(id->arena);
+  id->arena = NULL;
 
   // store Db0, Db1, and Db2 in instance_data:
-  instance_data[idi].b0 = Db0;
-  instance_data[idi].b1 = Db1;
-  instance_data[idi].b2 = Db2;
+  id->b0 = Db0;
+  id->b1 = Db1;
+  id->b2 = Db2;
   //initialize past samples x1, x2 to zero in instance_data:
-  instance_data[idi].x1 = 0.0;
-  instance_data[idi].x2 = 0.0;
+  id->x1 = 0.0;
+  id->x2 = 0.0;
+
+  id->complex_poles = ( Qp > 0.5 );
+  id->mode = ( *(plugin_data->mode_ptr) >= 0.5 ) ? RIIR_MODE_BLOCK : RIIR_MODE_CASCADE;
+  id->num_chains = 0;
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "Fp %g Qp %g, %s mode", Fp, Qp, ( id->mode == RIIR_MODE_BLOCK ) ? "block" : "cascade");
+  telemetry_open(&id->meter, "RIIR_AP2", info, 1, plugin_data->SR);
+  if ( id->mode == RIIR_MODE_BLOCK ) {
+    //block time reversal of the denominator 1 + Da1 z^-1 + Da2 z^-2, with blocks of block_size samples
+    const riir_allpass filter = { Da1, Da2, id->b0, id->b1, id->b2 };
+    const unsigned long block_size = riir_block_size(*(plugin_data->block_ptr), &filter, 1, SNR);
+    id->latency = 2*block_size + 2;
+    if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+    id->arena = riir_alloc_reverser(&id->reverser, &filter, 1, block_size, id->work);
+    if (!id->arena) {
+      cout << "RIIR_AP2: ERROR: out of memory for blocks of " << block_size << " samples. The output is silent." << endl;
+      return;
+    }
+    //the blocks start out cleared, so nothing is muted
+    id->startup_samples = 0;
+    //the blocks hold 2*block_size samples and x1, x2 two
+    set_silence_gate(&id->gate, 2*block_size + 2);
+    cout << "For the RIIR_AP2 instance with Fp = " << Fp << " and Qp = " << Qp << " in block mode:" << endl;
+    cout << "   blocks of " << block_size << " samples use " << riir_reverser_size(block_size, 1) / 1024 << " kB of memory." << endl;
+    cout << "The latency produced by the reverse-IIR processing will be:" << endl;
+    cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+    cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;
+    cout << "The error from truncating the impulse response is " << setprecision(1) << riir_truncation_dB(&filter, 1, block_size) << " dB." << endl;
+    return;
+  }
 
   if ( Qp > 0.5 ) {
     //Q>0.5, so there are two complex poles. Initialize CC storage and parameters.
-    //push back a new instance of CCstage
-    CCstage.push_back( vector<CCstage_data_struct>() );
-    //set the plugin_data's instance_index, and the local variable id, to CCstage.size()-1
-    instance_data[idi].instance_index = ii = CCstage.size()-1;
     //calculate c = a + i*b from biquad coefficients per Martins' post on the KVR forums
     // above EQ rewritten as complex_pole = real_part + 1i * imaginary_part
     real_part = -Da1/2.0;
     imaginary_part = sqrt(Da2 - Da1*Da1/4.0); 
     complex_pole = real_part + 1i * imaginary_part; 
     //calculate a_over_b = a / b 
-    instance_data[idi].a_over_b = real_part / imaginary_part; //a_over_b is a global var
+    id->a_over_b = real_part / imaginary_part;
     //calculate num_CCstages, the required numer of stages, using SNR and ABS(c).
     //  the number of required stages is rounded to the nearest integer
-    instance_data[idi].num_CCstages = trunc( 0.5 + log2( -SNR / (20.0*log10( abs( complex_pole ) ) ) ) );
-    //resize the CCstage[] vector
-    CCstage[ii].resize(instance_data[idi].num_CCstages+1); //the +1 is because there is a 0th stage
-    //loop over CCstage vector and peform setup tasks:
-    for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_CCstages; stage_index++) {
-      CCstage[ii][stage_index].cb_size = pow(2,stage_index); //calc the circular buffer size
-      // resize vectors to hold cb_size values and fill with zeroes :
-      CCstage[ii][stage_index].past_x_inputs.assign( CCstage[ii][stage_index].cb_size, 0.0 );
-      CCstage[ii][stage_index].past_y_inputs.assign( CCstage[ii][stage_index].cb_size, 0.0 );
+    riir_chain *CC = &id->chain[RIIRAP2_CC];
+    CC->num_stages = trunc( 0.5 + log2( -SNR / (20.0*log10( abs( complex_pole ) ) ) ) );
+    CC->is_complex = true;
+    id->num_chains = 1;
+    //each stage delays by the size of its buffer, 2^stage_index, and the numerator
+    //  by two samples
+    id->latency = (2ul << CC->num_stages) + 1;
+    //the latency is also reported by run, in case the port is connected later
+    if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+    //allocate the stages and their circular buffers, sized 2^stage_index, in one arena
+    id->arena = riir_alloc_chains(id->chain, id->num_chains, id->work);
+    if (!id->arena) {
+      cout << "RIIR_AP2: ERROR: out of memory for " << CC->num_stages << " stages. The output is silent." << endl;
+      return;
+    }
+    //loop over the stages and calculate the coefficients:
+    for (unsigned int stage_index=0; stage_index<=CC->num_stages; stage_index++) {
       // calculate a and b values for each stage from c:
       complex_temp = pow( complex_pole, pow( 2, stage_index ) ); //calculate c^2^N
-      CCstage[ii][stage_index].a = real( complex_temp ); 
-      CCstage[ii][stage_index].b = imag( complex_temp );
-      CCstage[ii][stage_index].cb_index = 0; //set an arbitrary start value for the c.b.
+      CC->stage[stage_index].a = real( complex_temp ); 
+      CC->stage[stage_index].b = imag( complex_temp );
     } //end for-loop over stages
     //store the number of output samples that should be set to zero at startup
-    instance_data[idi].startup_samples = pow(2,instance_data[idi].num_CCstages);
-    //report the latency
+    id->startup_samples = pow(2,CC->num_stages);
+    //the response is truncated, so the stages hold only zeros once as many silent
+    //  samples have passed through as the stage buffers (2*startup_samples - 1)
+    //  and x1, x2 hold
+    set_silence_gate(&id->gate, 2*id->startup_samples + 2);
     cout << "For the RIIR_AP2 instance with Fp = " << Fp << ", Qp = " << Qp << ", and SNR = " << SNR << ":" << endl;
-    cout << "   " << instance_data[idi].num_CCstages << " stages are required for the complex pole." << endl;
+    cout << "   " << CC->num_stages << " stages are required for the complex pole. They use ";
+    cout << riir_chains_size(id->chain, id->num_chains) / 1024 << " kB of memory." << endl;
     cout << "The latency produced by the reverse-IIR processing will be:" << endl;
-    cout << "   " << instance_data[idi].startup_samples << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
-    cout << fixed << setprecision(3) << 1000.0* instance_data[idi].startup_samples / plugin_data->SR << " milliseconds." << endl;    
+    cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+    cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;    
     return;
   } //end initializations for Q>0.5
 
@@ -263,150 +309,175 @@ void RIIRAP2_activate(LADSPA_Handle instance) {
     RP2 = -Da1/2.0 - sqrt( Da1*Da1/4.0 - Da2 );
   }     
   //Initialize storage and parameters for each pole separately
-  //push back a new instance of RP1stage and RP2stage
-  RP1stage.push_back( vector<RPstage_data_struct>() );
-  RP2stage.push_back( vector<RPstage_data_struct>() );
-  //set the plugin_data's instance_index, and the local variable id, to RP1stage.size()-1
-  instance_data[idi].instance_index = ii = RP1stage.size()-1;
-
+  riir_chain *RP1chain = &id->chain[RIIRAP2_RP1], *RP2chain = &id->chain[RIIRAP2_RP2];
+  //calculate num_RP1stages and num_RP2stages, the required numer of stages, using SNR and ABS(c).
+  //  the number of required stages is rounded to the nearest integer. The values
+  //  are different since the poles are not identical
+  RP1chain->num_stages = trunc( 0.5 + log2( -SNR / (20.0*log10( RP1 ) ) ) );
+  RP2chain->num_stages = trunc( 0.5 + log2( -SNR / (20.0*log10( RP2 ) ) ) );
+  RP1chain->is_complex = RP2chain->is_complex = false;
+  id->num_chains = 2;
+  //each chain delays by 2^(num_stages+1) - 1 samples and the numerator by two
+  id->latency = (2ul << RP1chain->num_stages) + (2ul << RP2chain->num_stages);
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  //allocate the stages of both poles and their circular buffers, sized 2^stage_index, in one arena
+  id->arena = riir_alloc_chains(id->chain, id->num_chains, id->work);
+  if (!id->arena) {
+    cout << "RIIR_AP2: ERROR: out of memory for " << RP1chain->num_stages << " + " << RP2chain->num_stages;
+    cout << " stages. The output is silent." << endl;
+    return;
+  }
   //begin RP1 initializations:
-  //calculate num_RP1stages, the required numer of stages, using SNR and ABS(c).
-  //  the number of required stages is rounded to the nearest integer
-   //calculate real poles RP1 and RP2 from biquad coefficients:
-  //proceed first with RP1: 
-  instance_data[idi].num_RP1stages = trunc( 0.5 + log2( -SNR / (20.0*log10( RP1 ) ) ) );
-  //resize the RP1stage[] vector
-  RP1stage[ii].resize(instance_data[idi].num_RP1stages+1); //the +1 is because there is a 0th stage
-  //loop over CCstage vector and peform setup tasks:
-  for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP1stages; stage_index++) {
-    RP1stage[ii][stage_index].cb_size = pow(2,stage_index); //calc the circular buffer size
-    // resize vector to hold cb_size values and fill with zeroes :
-    RP1stage[ii][stage_index].past_x_inputs.assign( RP1stage[ii][stage_index].cb_size, 0.0 );
+  for (unsigned int stage_index=0; stage_index<=RP1chain->num_stages; stage_index++) {
     // calculate a value for each stage from c:
-    RP1stage[ii][stage_index].a = pow( RP1, pow( 2, stage_index ) ); //calculate c^2^N 
-    RP1stage[ii][stage_index].cb_index = 0; //set an arbitrary start value for the c.b.
+    RP1chain->stage[stage_index].a = pow( RP1, pow( 2, stage_index ) ); //calculate c^2^N 
   } //end for-loop over RP1 stages
   //done with RP1 initializations:
 
   //begin RP2 initializations:
-  //Repeat for second pole. Values are different since poles are not identical
-  instance_data[idi].num_RP2stages = trunc( 0.5 + log2( -SNR / (20.0*log10( RP2 ) ) ) );
-  //resize the RP2stage[] vector
-  RP2stage[ii].resize(instance_data[idi].num_RP2stages+1); //the +1 is because there is a 0th stage
-  for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP2stages; stage_index++) {
-    RP2stage[ii][stage_index].cb_size = pow(2,stage_index); //calc the circular buffer size
-    // resize vector to hold cb_size values and fill with zeroes :
-    RP2stage[ii][stage_index].past_x_inputs.assign( RP2stage[ii][stage_index].cb_size, 0.0 );
+  for (unsigned int stage_index=0; stage_index<=RP2chain->num_stages; stage_index++) {
     // calculate a value for each stage from c:
-    RP2stage[ii][stage_index].a = pow( RP2, pow( 2, stage_index ) ); //calculate c^2^N 
-    RP2stage[ii][stage_index].cb_index = 0; //set an arbitrary start value for the c.b.
+    RP2chain->stage[stage_index].a = pow( RP2, pow( 2, stage_index ) ); //calculate c^2^N 
   } //end for-loop over RP2 stages
   //done with RP2 initializations:
   //store the number of output samples that should be set to zero at startup
-  instance_data[idi].startup_samples = pow(2, instance_data[idi].num_RP1stages);
-  instance_data[idi].startup_samples += pow(2, instance_data[idi].num_RP2stages );
-  //report the latency
+  id->startup_samples = pow(2, RP1chain->num_stages);
+  id->startup_samples += pow(2, RP2chain->num_stages );
+  //the stage buffers of the two real poles hold 2*startup_samples - 2 samples
+  set_silence_gate(&id->gate, 2*id->startup_samples + 2);
   cout << "For the RIIR_AP2 instance with Fp = " << Fp << ", Qp = " << Qp << ", and SNR = " << SNR << ":" << endl;
-  cout << "   " << instance_data[idi].num_RP1stages << " stages are required for real pole 1" << endl;
-  cout << "   " << instance_data[idi].num_RP2stages << " stages are required for real pole 2." << endl;
+  cout << "   " << RP1chain->num_stages << " stages are required for real pole 1" << endl;
+  cout << "   " << RP2chain->num_stages << " stages are required for real pole 2. They use ";
+  cout << riir_chains_size(id->chain, id->num_chains) / 1024 << " kB of memory." << endl;
   cout << "The latency produced by the reverse-IIR processing will be:" << endl;
-  cout << "   " << instance_data[idi].startup_samples << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
-  cout << fixed << setprecision(3) << 1000.0* instance_data[idi].startup_samples / plugin_data->SR << " milliseconds." << endl;    
+  cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+  cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;    
 
 } //end activate_RIIRAP2
 
 
 
 
-void RIIRAP2_run(LADSPA_Handle instance, unsigned long sample_count) {
-  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
-  const LADSPA_Data *input = plugin_data->input_ptr;
-  LADSPA_Data *output = plugin_data->output_ptr;
-  LADSPA_Data Qp = *(plugin_data->qp_ptr);
-  double x, y, u, v; 
-  unsigned int ii, idi;
+static void RIIRAP2_clear(per_instance_data_struct *id) {
+  //clears the stage buffers and x1, x2 of an instance, as when it was activated
+  if (id->mode == RIIR_MODE_BLOCK) riir_clear_reverser(&id->reverser);
+  else riir_clear_chains(id->chain, id->num_chains);
+  id->x1 = 0.0;
+  id->x2 = 0.0;
+} //end RIIRAP2_clear
 
-  //get indeces for this particular instance of the plugin:
-  idi = plugin_data->instance_data_index;
-  ii = instance_data[idi].instance_index;   
+
+CPU_KERNEL_INLINE void RIIRAP2_block(per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain,
+                                     const bool adding) {
+  //filters a block of up to RIIR_BLOCK samples, one stage at a time
+  double *x = id->work[0], *y;
+  unsigned long n;
   //begin RIIR calculation of poles (denominator of TF)
-  //the calculation method depends on the type of poles:
-  if ( Qp > 0.5 ) {
-    //for Q>0.5 there are two complex conjugate poles:      
-    for (unsigned long pos = 0; pos < sample_count; pos++) {
-      x = input[pos];
-      y = 0.0;
-      for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_CCstages; stage_index++) {
-        u = CCstage[ii][stage_index].a * x - CCstage[ii][stage_index].b * y + CCstage[ii][stage_index].past_x_inputs[CCstage[ii][stage_index].cb_index]; 
-        v = CCstage[ii][stage_index].b * x + CCstage[ii][stage_index].a * y + CCstage[ii][stage_index].past_y_inputs[CCstage[ii][stage_index].cb_index];
-        CCstage[ii][stage_index].past_x_inputs[CCstage[ii][stage_index].cb_index] = x;
-        CCstage[ii][stage_index].past_y_inputs[CCstage[ii][stage_index].cb_index] = y;
-        CCstage[ii][stage_index].cb_index = ( CCstage[ii][stage_index].cb_index + 1 ) % CCstage[ii][stage_index].cb_size;
-        x = u;
-        y = v;
-      } //  end for-loop over stages
-      // final combines the real and imaginary outputs:
-      x = x + instance_data[idi].a_over_b * y;
-      //done with RIIR denominator pole calculation for a pair of complex conjugate poles.
-      output[pos] = instance_data[idi].b0 * instance_data[idi].x2 + instance_data[idi].b1 * instance_data[idi].x1 + instance_data[idi].b2 * x;
-      //update values for x1, x2
-      instance_data[idi].x2 = instance_data[idi].x1;
-      instance_data[idi].x1 = x;
-    } //end for-loop over samples
-    //test if we are still in the startup period...
-    if ( instance_data[idi].startup_samples > 0 ) {
-      for (unsigned long pos = 0; pos < sample_count; pos++) {
-        //the output should be discarded until startup_samples samples have passed through
-        output[pos] = 0.0;
-        instance_data[idi].startup_samples -= 1;
-        if ( instance_data[idi].startup_samples == 0 ) break;
-      }     
-    }  //end check for startup samples
-    //end processing for Q>0.5
+  //the calculation method depends on the type of poles, which was set at activation:
+  if ( id->mode == RIIR_MODE_BLOCK ) {
+    //both poles at once, by block time reversal
+    riir_run_reverser(&id->reverser, input, x, count);
+  } else if ( id->complex_poles ) {
+    //for Q>0.5 there are two complex conjugate poles. The input is real:
+    for (n = 0; n < count; n++) {
+      x[2*n] = input[n];
+      x[2*n+1] = 0.0;
+    }
+    y = riir_run_chain(&id->chain[RIIRAP2_CC], x, id->work[1], count);
+    // final combines the real and imaginary outputs:
+    x = (y == id->work[0]) ? id->work[1] : id->work[0];
+    for (n = 0; n < count; n++) x[n] = y[2*n] + id->a_over_b * y[2*n+1];
   } else {
     //for Q<=0.5 there are two real poles. Calculate these in series:
-    for (unsigned long pos = 0; pos < sample_count; pos++) {
-      x = input[pos];
-      //RP1:      
-      for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP1stages; stage_index++) {
-        y = RP1stage[ii][stage_index].a * x + RP1stage[ii][stage_index].past_x_inputs[RP1stage[ii][stage_index].cb_index]; 
-        RP1stage[ii][stage_index].past_x_inputs[RP1stage[ii][stage_index].cb_index] = x;
-        RP1stage[ii][stage_index].cb_index = ( RP1stage[ii][stage_index].cb_index + 1 ) % RP1stage[ii][stage_index].cb_size;
-        x = y;
-      }
-      //done with RP1. Continue with RP2:
-      for (unsigned int stage_index=0; stage_index<=instance_data[idi].num_RP2stages; stage_index++) {
-        y = RP2stage[ii][stage_index].a * x + RP2stage[ii][stage_index].past_x_inputs[RP2stage[ii][stage_index].cb_index]; 
-        RP2stage[ii][stage_index].past_x_inputs[RP2stage[ii][stage_index].cb_index] = x;
-        RP2stage[ii][stage_index].cb_index = ( RP2stage[ii][stage_index].cb_index + 1 ) % RP2stage[ii][stage_index].cb_size;
-        x = y;
-      }
-      //done calculating poles RP1 and RP2 in series 
-      output[pos] = instance_data[idi].b0 * instance_data[idi].x2 + instance_data[idi].b1 * instance_data[idi].x1 + instance_data[idi].b2 * x;
-      //update values for x1, x2
-      instance_data[idi].x2 = instance_data[idi].x1;
-      instance_data[idi].x1 = x;
-    } //end for-loop over samples
-    //test if we are still in the startup period...
-    if ( instance_data[idi].startup_samples > 0 ) {
-      for (unsigned long pos = 0; pos < sample_count; pos++) {
-        //the output should be discarded until startup_samples samples have passed through
-        output[pos] = 0.0;
-        instance_data[idi].startup_samples -= 1;
-        if ( instance_data[idi].startup_samples == 0 ) break;
-      }     
-    } //end check for startup samples
-  } //end processing for Q<=0.5
+    for (n = 0; n < count; n++) x[n] = input[n];
+    x = riir_run_chain(&id->chain[RIIRAP2_RP1], x, id->work[1], count);
+    x = riir_run_chain(&id->chain[RIIRAP2_RP2], x, (x == id->work[0]) ? id->work[1] : id->work[0], count);
+  }
+  //numerator of the TF, into the other buffer
+  y = (x == id->work[0]) ? id->work[1] : id->work[0];
+  const double b0 = id->b0, b1 = id->b1, b2 = id->b2;
+  y[0] = b0 * id->x2 + b1 * id->x1 + b2 * x[0];
+  if (count > 1) y[1] = b0 * id->x1 + b1 * x[0] + b2 * x[1];
+  for (n = 2; n < count; n++) y[n] = b0 * x[n-2] + b1 * x[n-1] + b2 * x[n];
+  //update values for x1, x2
+  id->x2 = (count > 1) ? x[count-2] : id->x1;
+  id->x1 = x[count-1];
+  riir_write_output(y, output, count, muted, gain, adding);
+} //end RIIRAP2_block
+
+CPU_DISPATCH_KERNELS(RIIRAP2_block, (per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain, const bool adding),
+                     (id, input, output, count, muted, gain, adding))
+
+
+static inline void RIIRAP2_process(LADSPA_Handle instance, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  const LADSPA_Data *input = plugin_data->input_ptr;
+  LADSPA_Data *output = plugin_data->output_ptr; 
+  const LADSPA_Data gain = plugin_data->run_adding_gain;
+  unsigned long muted; //number of output samples that are discarded during startup
+  unsigned long count;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  if (!id->arena) {
+    //not activated, or out of memory
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  //the output should be discarded until startup_samples samples have passed through
+  muted = id->startup_samples;
+  if (muted > sample_count) muted = sample_count;
+  id->startup_samples -= muted;
+  if (silence_gate_skip(&id->gate, is_silent(input, sample_count), sample_count)) {
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  void (*kernel)(per_instance_data_struct *, const LADSPA_Data *, LADSPA_Data *, const unsigned long,
+                 const unsigned long, const LADSPA_Data, const bool) = CPU_DISPATCH_SELECT(RIIRAP2_block, plugin_data->isa);
+  for (unsigned long pos = 0; pos < sample_count; pos += count) {
+    count = (sample_count - pos < RIIR_BLOCK) ? sample_count - pos : RIIR_BLOCK;
+    kernel(id, input + pos, output + pos, count, (muted > pos) ? muted - pos : 0, gain, adding);
+  }
+  if (silence_gate_closing(&id->gate)) RIIRAP2_clear(id);
+} //end RIIRAP2_process
+
+
+static inline void RIIRAP2_meter(LADSPA_Handle instance, unsigned long sample_count, const int64_t start) {
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+  const unsigned int state = id->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&id->meter, &plugin_data->output_ptr, sample_count, state, start);
+}
+
+
+void RIIRAP2_run(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAP2_process(instance, sample_count, false);
+  RIIRAP2_meter(instance, sample_count, start);
 } //end run_RIIRAP2.
 
 
+void RIIRAP2_run_adding(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAP2_process(instance, sample_count, true);
+  RIIRAP2_meter(instance, sample_count, start);
+} //end RIIRAP2_run_adding
+
+
+void RIIRAP2_set_run_adding_gain(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((plugin_data_struct *)instance)->run_adding_gain = gain;
+}
+
+
 
 void RIIRAP2_cleanup(LADSPA_Handle instance) {
-  //free storage used by global data containers
-  CCstage.clear();
-  RP1stage.clear();
-  RP2stage.clear();
-  instance_data.clear();
+  telemetry_close(&((plugin_data_struct *)instance)->instance_data.meter);
+  //free the stage storage of this instance only
+  free(((plugin_data_struct *)instance)->instance_data.arena);
   //free memory obtained via malloc for the LADSPA plugin interface
   free(instance); 
 }
@@ -420,7 +491,7 @@ public:
     LADSPA_PortDescriptor *port_descriptors;
     LADSPA_PortRangeHint *port_range_hints;
     RIIRAP2_Descriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
-    const unsigned long num_ports = 5;
+    const unsigned long num_ports = 8;
     string text;
 
     if (RIIRAP2_Descriptor) {
@@ -476,14 +547,37 @@ public:
       text = "Output";
       port_names[RIIRAP2_OUTPUT] = strdup(text.c_str());
 
+      //port = calculation method, selected at activation
+      port_descriptors[RIIRAP2_MODE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "mode";
+      port_names[RIIRAP2_MODE] = strdup(text.c_str());
+      port_range_hints[RIIRAP2_MODE].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAP2_MODE].LowerBound = RIIR_MODE_CASCADE;
+      port_range_hints[RIIRAP2_MODE].UpperBound = RIIR_MODE_BLOCK;
+
+      //port = block size of block time reversal, in samples
+      port_descriptors[RIIRAP2_BLOCK] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "block";
+      port_names[RIIRAP2_BLOCK] = strdup(text.c_str());
+      port_range_hints[RIIRAP2_BLOCK].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAP2_BLOCK].LowerBound = 0;
+      port_range_hints[RIIRAP2_BLOCK].UpperBound = RIIR_MAX_BLOCK;
+
+      //port = latency, the delay of the output in samples
+      port_descriptors[RIIRAP2_LATENCY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      text = "latency";
+      port_names[RIIRAP2_LATENCY] = strdup(text.c_str());
+      port_range_hints[RIIRAP2_LATENCY].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[RIIRAP2_LATENCY].LowerBound = 0;
+
       RIIRAP2_Descriptor->activate = RIIRAP2_activate;
       RIIRAP2_Descriptor->cleanup = RIIRAP2_cleanup;
       RIIRAP2_Descriptor->connect_port = RIIRAP2_connectPort;
       RIIRAP2_Descriptor->deactivate = NULL;
       RIIRAP2_Descriptor->instantiate = RIIRAP2_instantiate;
       RIIRAP2_Descriptor->run = RIIRAP2_run;
-      RIIRAP2_Descriptor->run_adding = NULL;
-      RIIRAP2_Descriptor->set_run_adding_gain = NULL;
+      RIIRAP2_Descriptor->run_adding = RIIRAP2_run_adding;
+      RIIRAP2_Descriptor->set_run_adding_gain = RIIRAP2_set_run_adding_gain;
     }
   }
   ~Initialiser() {
@@ -0,0 +1,253 @@
+/* RIIR_bench
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Compares the two methods of the RIIR_AP1 and RIIR_AP2 LADSPA plugins: the
+  cascade of stages (mode=0), whose size is set by the SNR, and block time
+  reversal (mode=1), whose size is set by the block size. For several filters
+  the CPU time, the latency and the error of each method are measured.
+  The times are given in milliseconds per second of audio at 48kHz, i.e. in
+  tenths of a percent of one CPU core, using the GSASysCon buffer size of
+  1024 samples. The latency is the position of the last non-zero sample of
+  the impulse response. The error is that of the output for white noise,
+  relative to the exact reverse allpass filter, in dB. The exact filter is
+  calculated here by running the poles backwards over the whole signal. The
+  memory used by each instance is printed by the plugin when it is
+  activated.
+
+  Build and run it from the RIIR_AP2 directory with:
+    make bench
+  The plugins are loaded from ../RIIR_AP1/RIIR_AP1.so and ./RIIR_AP2.so. Set
+  GSASYSCON_ISA (see ../common/cpu_dispatch.h) to measure a particular
+  instruction set.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <ladspa.h>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+#define BENCH_RATE         48000  //sample rate
+#define BENCH_BUFFER        1024  //samples per run, as in GSASysCon
+#define BENCH_SECONDS         10  //seconds of audio per measurement
+#define BENCH_ERROR_FROM       1  //the error is measured from 1 to 6 seconds. The exact filter
+#define BENCH_ERROR_TO         6  //  sees the rest of the signal, so its response is complete.
+#define BENCH_IMPULSE    (3 * 65536)  //samples that are searched for the end of the impulse response
+
+typedef struct {
+  const char *label; //RIIR_AP1 or RIIR_AP2
+  float fp, qp; //qp is not used by RIIR_AP1
+} bench_filter;
+
+typedef struct {
+  const char *name;
+  float mode, snr, block;
+} bench_method;
+
+static const bench_filter bench_filters[6] = {
+  { "RIIR_AP1", 20, 0 }, { "RIIR_AP1", 200, 0 },
+  { "RIIR_AP2", 20, 0.7 }, { "RIIR_AP2", 100, 0.5 }, { "RIIR_AP2", 1000, 0.3 }, { "RIIR_AP2", 50, 5 }
+};
+static const bench_method bench_methods[6] = {
+  { "cascade snr=100", 0, 100, 0 }, { "cascade snr=120", 0, 120, 0 },
+  { "block snr=100  ", 1, 100, 0 }, { "block snr=120  ", 1, 120, 0 },
+  { "block 1024     ", 1, 100, 1024 }, { "block 4096     ", 1, 100, 4096 }
+};
+
+
+static unsigned int noise_state = 12345;
+static float noise() {
+  //uniform noise between -1 and 1
+  noise_state = noise_state * 1664525u + 1013904223u;
+  return (float)((int)(noise_state >> 8) - (1 << 23)) / (float)(1 << 23);
+}
+
+
+static double seconds() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1.e-9 * t.tv_nsec;
+}
+
+
+static const LADSPA_Descriptor *find_plugin(const char *path, const char *label) {
+  void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  LADSPA_Descriptor_Function descriptor_function;
+  const LADSPA_Descriptor *descriptor;
+  if (!library) {
+    cout << "cannot load " << path << ": " << dlerror() << endl;
+    return NULL;
+  }
+  descriptor_function = (LADSPA_Descriptor_Function)dlsym(library, "ladspa_descriptor");
+  if (!descriptor_function) return NULL;
+  for (unsigned long index = 0; (descriptor = descriptor_function(index)) != NULL; index++) {
+    if (strcmp(descriptor->Label, label) == 0) return descriptor;
+  }
+  return NULL;
+}
+
+
+static void exact_filter(const bench_filter *f, const float *input, double *output, const unsigned long count) {
+  //the reverse allpass filter without truncation: the poles 1/D(z) are run
+  //  backwards over the whole signal, then the numerator of the plugin is
+  //  applied forwards. The coefficients are calculated as in the plugins.
+  double d1, d2 = 0.0, b0 = 0.0, b1, b2;
+  const double K = 2.0 * BENCH_RATE;
+  if (strcmp(f->label, "RIIR_AP1") == 0) {
+    const double RP1 = (1.0 - tan(2.0 * M_PI * f->fp / K)) / (1.0 + tan(2.0 * M_PI * f->fp / K));
+    d1 = -RP1;
+    b1 = RP1;
+    b2 = -1.0;
+  } else {
+    const double Wp = K * tan(2.0 * M_PI * f->fp / K);
+    const double Da0 = K * K + Wp / f->qp * K + Wp * Wp;
+    d1 = (2.0 * Wp * Wp - 2.0 * K * K) / Da0;
+    d2 = (K * K - Wp / f->qp * K + Wp * Wp) / Da0;
+    //the plugin keeps the numerator as floats
+    b0 = (float)((K * K - Wp / f->qp * K + Wp * Wp) / Da0);
+    b1 = (float)((2.0 * Wp * Wp - 2.0 * K * K) / Da0);
+    b2 = (float)((K * K + Wp / f->qp * K + Wp * Wp) / Da0);
+  }
+  double *w = (double *)malloc((count + 2) * sizeof(double));
+  w[count] = w[count + 1] = 0.0;
+  for (unsigned long n = count; n-- > 0; ) w[n] = input[n] - d1 * w[n + 1] - d2 * w[n + 2];
+  for (unsigned long n = 0; n < count; n++) {
+    output[n] = b2 * w[n] + ((n > 0) ? b1 * w[n - 1] : 0.0) + ((n > 1) ? b0 * w[n - 2] : 0.0);
+  }
+  free(w);
+} //end exact_filter
+
+
+static LADSPA_Handle start_plugin(const LADSPA_Descriptor *descriptor, const bench_filter *f, const bench_method *m,
+                                  LADSPA_Data *controls, LADSPA_Data *input, LADSPA_Data *output) {
+  LADSPA_Handle handle = descriptor->instantiate(descriptor, BENCH_RATE);
+  for (unsigned long port = 0; port < descriptor->PortCount; port++) {
+    LADSPA_PortDescriptor pd = descriptor->PortDescriptors[port];
+    string name = descriptor->PortNames[port];
+    if (LADSPA_IS_PORT_AUDIO(pd)) {
+      descriptor->connect_port(handle, port, LADSPA_IS_PORT_INPUT(pd) ? input : output);
+      continue;
+    }
+    controls[port] = 0.0;
+    if (name == "fp") controls[port] = f->fp;
+    if (name == "qp") controls[port] = f->qp;
+    if (name == "snr") controls[port] = m->snr;
+    if (name == "mode") controls[port] = m->mode;
+    if (name == "block") controls[port] = m->block;
+    descriptor->connect_port(handle, port, &controls[port]);
+  }
+  descriptor->activate(handle);
+  return handle;
+}
+
+
+static unsigned long measure_latency(const LADSPA_Descriptor *descriptor, const bench_filter *f, const bench_method *m) {
+  //returns the position of the last non-zero sample of the impulse response
+  LADSPA_Data controls[16], input[BENCH_BUFFER], output[BENCH_BUFFER];
+  LADSPA_Handle handle = start_plugin(descriptor, f, m, controls, input, output);
+  unsigned long latency = 0;
+  for (unsigned long pos = 0; pos < BENCH_IMPULSE; pos += BENCH_BUFFER) {
+    for (unsigned long n = 0; n < BENCH_BUFFER; n++) input[n] = (pos + n == 0) ? 1.0 : 0.0;
+    descriptor->run(handle, BENCH_BUFFER);
+    for (unsigned long n = 0; n < BENCH_BUFFER; n++) {
+      if (output[n] != 0.0) latency = pos + n;
+    }
+  }
+  descriptor->cleanup(handle);
+  return latency;
+}
+
+
+static double time_plugin(const LADSPA_Descriptor *descriptor, const bench_filter *f, const bench_method *m,
+                          const float *signal, const double *exact, double *error_dB, unsigned long *latency) {
+  //returns the time in ms per second of audio used by the plugin and the
+  //  error of its output relative to the exact filter
+  const unsigned long count = (unsigned long)BENCH_SECONDS * BENCH_RATE;
+  LADSPA_Data controls[16], input[BENCH_BUFFER], buffer[BENCH_BUFFER];
+  float *output = (float *)malloc(count * sizeof(float));
+  const unsigned long delay = measure_latency(descriptor, f, m) - ((strcmp(f->label, "RIIR_AP1") == 0) ? 1 : 2);
+  LADSPA_Handle handle = start_plugin(descriptor, f, m, controls, input, buffer);
+  double start, used = 0.0, error = 0.0, power = 0.0;
+
+  for (unsigned long pos = 0, n; pos < count; pos += n) {
+    n = (count - pos < BENCH_BUFFER) ? count - pos : BENCH_BUFFER;
+    memcpy(input, signal + pos, n * sizeof(float));
+    start = seconds();
+    descriptor->run(handle, n);
+    used += seconds() - start;
+    memcpy(output + pos, buffer, n * sizeof(float));
+  }
+  descriptor->cleanup(handle);
+  //the output is the exact filter delayed by the latency of the poles
+  for (unsigned long n = BENCH_ERROR_FROM * BENCH_RATE; n < BENCH_ERROR_TO * BENCH_RATE; n++) {
+    const double e = output[n + delay] - exact[n];
+    error += e * e;
+    power += exact[n] * exact[n];
+  }
+  free(output);
+  *error_dB = 10.0 * log10(error / power + 1.e-300);
+  *latency = delay + ((strcmp(f->label, "RIIR_AP1") == 0) ? 1 : 2);
+  return 1000.0 * used / BENCH_SECONDS;
+} //end time_plugin
+
+
+int main() {
+  const LADSPA_Descriptor *ap1 = find_plugin("../RIIR_AP1/RIIR_AP1.so", "RIIR_AP1");
+  const LADSPA_Descriptor *ap2 = find_plugin("./RIIR_AP2.so", "RIIR_AP2");
+  const unsigned long count = (unsigned long)BENCH_SECONDS * BENCH_RATE;
+  float *signal = (float *)malloc(count * sizeof(float));
+  double *exact = (double *)malloc(count * sizeof(double));
+  unsigned long latency;
+  double error_dB;
+
+  if (!ap1 || !ap2 || !signal || !exact) {
+    cout << "the plugins are not available" << endl;
+    return 1;
+  }
+  for (unsigned long n = 0; n < count; n++) signal[n] = noise();
+
+  //the plugins print their size when they are activated. Collect the results
+  //  and print them at the end.
+  std::ostringstream report;
+  report << endl << "ms per second of audio at " << BENCH_RATE << "Hz (= 0.1% of a CPU core), buffer size " << BENCH_BUFFER << endl;
+  report << "filter                    method                ms   latency   error dB" << endl;
+  for (unsigned int i = 0; i < sizeof(bench_filters) / sizeof(bench_filters[0]); i++) {
+    const bench_filter *f = &bench_filters[i];
+    const LADSPA_Descriptor *descriptor = (strcmp(f->label, "RIIR_AP1") == 0) ? ap1 : ap2;
+    exact_filter(f, signal, exact, count);
+    for (unsigned int j = 0; j < sizeof(bench_methods) / sizeof(bench_methods[0]); j++) {
+      double ms = time_plugin(descriptor, f, &bench_methods[j], signal, exact, &error_dB, &latency);
+      std::ostringstream name;
+      name << f->label << " fp=" << f->fp;
+      if (f->qp > 0) name << " qp=" << f->qp;
+      report << left << setw(26) << ((j == 0) ? name.str() : "") << right << bench_methods[j].name;
+      report << fixed << setprecision(2) << setw(8) << ms << setw(10) << latency;
+      report << setprecision(1) << setw(11) << error_dB << endl;
+    }
+  }
+  cout << report.str();
+  free(signal);
+  free(exact);
+  return 0;
+}
@@ -0,0 +1,240 @@
+/* RIIR_stress
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Checks that instances of the RIIR_AP1 and RIIR_AP2 LADSPA plugins do not
+  share state. Each instance keeps its stages and ring buffers in its own
+  arena (see ../common/riir_stages.h), so an instance must produce the same
+  output whether it runs alone or in a thread next to others.
+
+  First the output of each filter of stress_filters is calculated with a
+  single instance in this thread. Then, in each of STRESS_ROUNDS rounds,
+  STRESS_WORKERS threads each instantiate and activate their own instance of
+  one of the filters and run it over the same signal, while STRESS_CHURNERS
+  other threads keep instantiating, activating, running and cleaning up
+  instances of all filters. The output of every worker is compared bit for
+  bit with the single threaded output. The block sizes passed to run vary
+  from call to call, in the same order in both cases, so that the ring
+  buffers wrap at different positions.
+
+  Build and run it from the RIIR_AP2 directory with:
+    make stress
+  It prints one line per round and returns 1 if any output differs.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <ladspa.h>
+#include <string>
+#include <atomic>
+#include <iostream>
+using namespace std;
+
+#define STRESS_RATE        48000  //sample rate
+#define STRESS_SAMPLES    (2 * STRESS_RATE)  //samples of noise run through each instance
+#define STRESS_MAX_BUFFER   4096  //largest block size passed to run
+#define STRESS_ROUNDS          4
+#define STRESS_WORKERS        12  //threads whose output is checked
+#define STRESS_CHURNERS        4  //threads that create and destroy instances meanwhile
+
+typedef struct {
+  const char *label; //RIIR_AP1 or RIIR_AP2
+  float fp, qp, snr, mode, block; //qp is not used by RIIR_AP1
+} stress_filter;
+
+static const stress_filter stress_filters[8] = {
+  { "RIIR_AP1", 20, 0, 100, 0, 0 }, { "RIIR_AP1", 200, 0, 120, 0, 0 }, { "RIIR_AP1", 100, 0, 100, 1, 1024 },
+  { "RIIR_AP2", 20, 0.7, 100, 0, 0 }, { "RIIR_AP2", 1000, 0.3, 120, 0, 0 }, { "RIIR_AP2", 50, 5, 100, 0, 0 },
+  { "RIIR_AP2", 100, 0.5, 100, 1, 0 }, { "RIIR_AP2", 300, 0.7, 100, 1, 4096 }
+};
+#define STRESS_FILTERS (sizeof(stress_filters) / sizeof(stress_filters[0]))
+
+//the block sizes passed to run, in turn
+static const unsigned long stress_buffers[7] = { 1024, 64, 333, 4096, 1, 777, 2048 };
+
+static const LADSPA_Descriptor *ap1, *ap2;
+static float *signal;
+static float *reference[STRESS_FILTERS];
+static std::atomic<bool> churning;
+
+
+static const LADSPA_Descriptor *find_plugin(const char *path, const char *label) {
+  void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  LADSPA_Descriptor_Function descriptor_function;
+  const LADSPA_Descriptor *descriptor;
+  if (!library) {
+    cout << "cannot load " << path << ": " << dlerror() << endl;
+    return NULL;
+  }
+  descriptor_function = (LADSPA_Descriptor_Function)dlsym(library, "ladspa_descriptor");
+  if (!descriptor_function) return NULL;
+  for (unsigned long index = 0; (descriptor = descriptor_function(index)) != NULL; index++) {
+    if (strcmp(descriptor->Label, label) == 0) return descriptor;
+  }
+  return NULL;
+}
+
+
+static const LADSPA_Descriptor *descriptor_of(const stress_filter *f) {
+  return (strcmp(f->label, "RIIR_AP1") == 0) ? ap1 : ap2;
+}
+
+
+static LADSPA_Handle start_plugin(const stress_filter *f, LADSPA_Data *controls, LADSPA_Data *input,
+                                  LADSPA_Data *output) {
+  const LADSPA_Descriptor *descriptor = descriptor_of(f);
+  LADSPA_Handle handle = descriptor->instantiate(descriptor, STRESS_RATE);
+  if (!handle) return NULL;
+  for (unsigned long port = 0; port < descriptor->PortCount; port++) {
+    LADSPA_PortDescriptor pd = descriptor->PortDescriptors[port];
+    string name = descriptor->PortNames[port];
+    if (LADSPA_IS_PORT_AUDIO(pd)) {
+      descriptor->connect_port(handle, port, LADSPA_IS_PORT_INPUT(pd) ? input : output);
+      continue;
+    }
+    controls[port] = 0.0;
+    if (name == "fp") controls[port] = f->fp;
+    if (name == "qp") controls[port] = f->qp;
+    if (name == "snr") controls[port] = f->snr;
+    if (name == "mode") controls[port] = f->mode;
+    if (name == "block") controls[port] = f->block;
+    descriptor->connect_port(handle, port, &controls[port]);
+  }
+  descriptor->activate(handle);
+  return handle;
+}
+
+
+static bool run_filter(const stress_filter *f, float *output) {
+  //runs a new instance over the signal and stores its output. Returns false
+  //  if the plugin could not be instantiated.
+  LADSPA_Data controls[16], input[STRESS_MAX_BUFFER], buffer[STRESS_MAX_BUFFER];
+  const LADSPA_Descriptor *descriptor = descriptor_of(f);
+  LADSPA_Handle handle = start_plugin(f, controls, input, buffer);
+  if (!handle) return false;
+  for (unsigned long pos = 0, call = 0, n; pos < STRESS_SAMPLES; pos += n, call++) {
+    n = stress_buffers[call % (sizeof(stress_buffers) / sizeof(stress_buffers[0]))];
+    if (n > STRESS_SAMPLES - pos) n = STRESS_SAMPLES - pos;
+    memcpy(input, signal + pos, n * sizeof(float));
+    descriptor->run(handle, n);
+    memcpy(output + pos, buffer, n * sizeof(float));
+  }
+  descriptor->cleanup(handle);
+  return true;
+}
+
+
+typedef struct {
+  pthread_t thread;
+  unsigned int filter;
+  float *output;
+  bool ran;
+} stress_worker;
+
+
+static void *worker_thread(void *data) {
+  stress_worker *w = (stress_worker *)data;
+  w->ran = run_filter(&stress_filters[w->filter], w->output);
+  return NULL;
+}
+
+
+static void *churn_thread(void *data) {
+  //instantiates, activates, runs and cleans up instances of all filters, so
+  //  that the workers run while memory of other instances is taken and freed
+  unsigned int index = (unsigned int)(size_t)data;
+  LADSPA_Data controls[16], input[STRESS_MAX_BUFFER], buffer[STRESS_MAX_BUFFER];
+  memcpy(input, signal, sizeof(input));
+  while (churning.load()) {
+    const stress_filter *f = &stress_filters[index++ % STRESS_FILTERS];
+    const LADSPA_Descriptor *descriptor = descriptor_of(f);
+    LADSPA_Handle handle = start_plugin(f, controls, input, buffer);
+    if (!handle) continue;
+    for (unsigned int call = 0; call < 4; call++) descriptor->run(handle, stress_buffers[(index + call) % 7]);
+    descriptor->cleanup(handle);
+  }
+  return NULL;
+}
+
+
+int main() {
+  stress_worker workers[STRESS_WORKERS];
+  pthread_t churners[STRESS_CHURNERS];
+  unsigned int noise_state = 12345, failed = 0;
+
+  ap1 = find_plugin("../RIIR_AP1/RIIR_AP1.so", "RIIR_AP1");
+  ap2 = find_plugin("./RIIR_AP2.so", "RIIR_AP2");
+  signal = (float *)malloc(STRESS_SAMPLES * sizeof(float));
+  if (!ap1 || !ap2 || !signal) {
+    cout << "the plugins are not available" << endl;
+    return 1;
+  }
+  for (unsigned long n = 0; n < STRESS_SAMPLES; n++) {
+    //uniform noise between -1 and 1
+    noise_state = noise_state * 1664525u + 1013904223u;
+    signal[n] = (float)((int)(noise_state >> 8) - (1 << 23)) / (float)(1 << 23);
+  }
+
+  //the plugins print their size when they are activated. Collect the results
+  //  and print them at the end.
+  string report;
+  for (unsigned int i = 0; i < STRESS_FILTERS; i++) {
+    reference[i] = (float *)malloc(STRESS_SAMPLES * sizeof(float));
+    if (!reference[i] || !run_filter(&stress_filters[i], reference[i])) {
+      cout << stress_filters[i].label << " could not be instantiated" << endl;
+      return 1;
+    }
+  }
+  for (unsigned int j = 0; j < STRESS_WORKERS; j++) workers[j].output = (float *)malloc(STRESS_SAMPLES * sizeof(float));
+
+  for (unsigned int round = 0; round < STRESS_ROUNDS; round++) {
+    unsigned int differ = 0;
+    churning.store(true);
+    for (unsigned int k = 0; k < STRESS_CHURNERS; k++) {
+      pthread_create(&churners[k], NULL, churn_thread, (void *)(size_t)(k + round));
+    }
+    for (unsigned int j = 0; j < STRESS_WORKERS; j++) {
+      workers[j].filter = (j + round) % STRESS_FILTERS;
+      memset(workers[j].output, 0, STRESS_SAMPLES * sizeof(float));
+      pthread_create(&workers[j].thread, NULL, worker_thread, &workers[j]);
+    }
+    for (unsigned int j = 0; j < STRESS_WORKERS; j++) pthread_join(workers[j].thread, NULL);
+    churning.store(false);
+    for (unsigned int k = 0; k < STRESS_CHURNERS; k++) pthread_join(churners[k], NULL);
+
+    for (unsigned int j = 0; j < STRESS_WORKERS; j++) {
+      const stress_filter *f = &stress_filters[workers[j].filter];
+      if (workers[j].ran && memcmp(workers[j].output, reference[workers[j].filter], STRESS_SAMPLES * sizeof(float)) == 0) continue;
+      char line[128];
+      snprintf(line, sizeof(line), "  %s fp=%g qp=%g snr=%g mode=%g block=%g differs from the single threaded output\n",
+               f->label, f->fp, f->qp, f->snr, f->mode, f->block);
+      report += line;
+      differ++;
+    }
+    char line[128];
+    snprintf(line, sizeof(line), "round %u: %u of %u instances identical\n", round + 1, STRESS_WORKERS - differ, STRESS_WORKERS);
+    report += line;
+    failed += differ;
+  }
+  cout << endl << report << (failed ? "FAILED" : "PASSED") << endl;
+
+  for (unsigned int j = 0; j < STRESS_WORKERS; j++) free(workers[j].output);
+  for (unsigned int i = 0; i < STRESS_FILTERS; i++) free(reference[i]);
+  free(signal);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,715 @@
+/*                    RIIR_APN LADSPA plugin, version 1.0
+                       Copyright 2025 Charlie Laub, GPLv3
+
+  RIIR_APN is a LADSPA plugin for implementing the reverse (backwards)
+  application of an allpass filter of any order, e.g. to linearize the phase
+  of an LR8 crossover with a single plugin instead of a chain of RIIR_AP1 and
+  RIIR_AP2 plugins. The filter is a cascade of up to 8 sections that are set
+  by the parameters fp1, qp1 ... fp8, qp8 in the same way as the allpass
+  sections of ACDf: each section is a second order allpass with pole
+  frequency fpK and pole Q qpK, or a first order allpass when qpK is 0.
+  Sections with fpK = 0 are not used. Alternatively, file = n reads up to 16
+  sections from the text file number n, which is found in the same way as the
+  IR files of the Convolver (see ../common/numbered_file.h). The file has
+  one section per line, the pole frequency followed by the pole Q, separated
+  by spaces, tabs, commas or semicolons. A line with only a frequency is a
+  first order section. Lines that do not start with a number are skipped.
+  If the file cannot be read, an error message is printed and the output is
+  silent.
+
+  The parameters SNR, mode and block work as for RIIR_AP2, but for the filter
+  as a whole. All sections share one arena of memory, and the output is muted
+  only once at startup. With mode=1 (block time reversal, see riir_stages.h)
+  the poles of all sections are reversed together, so the latency is that of
+  a single RIIR_AP2, 2*block + 1 sample per order, however many sections
+  there are. With mode=0 the latency of the cascades of stages of all poles
+  adds up. The latency is reported by the latency port, so that the host can
+  delay other channels by the same amount.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+  CREDITS:
+
+  The Reverse-IIR calculation method was devised by Martin Vicanek. See:
+  "A New Reverse IIR Filtering Algorithm" OCT 2015 REVISED JAN 2022
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+#include <complex>
+#include "silence_gate.h"
+#include "cpu_dispatch.h"
+#include "riir_stages.h"
+#include "numbered_file.h"
+#include "telemetry.h"
+using namespace std;
+
+
+#define RIIRAPN_PORT_SECTIONS     8  //sections that are set by the ports fpK, qpK
+#define RIIRAPN_MAX_FILE_NUMBER 9999  //largest section file number, as for the IR files
+
+//order of LADSPA parameters:
+#define RIIRAPN_FP(K)     (2*(K))    //pole frequency of section K (0 to 7). 0 = not used
+#define RIIRAPN_QP(K)     (2*(K)+1)  //pole Q of section K. 0 = first order section
+#define RIIRAPN_FILE      16  //number of the section file. 0 = the sections are set by the ports
+#define RIIRAPN_SNR       17
+#define RIIRAPN_INPUT     18
+#define RIIRAPN_OUTPUT    19
+#define RIIRAPN_MODE      20  //0 = cascade of stages, 1 = block time reversal
+#define RIIRAPN_BLOCK     21  //block size of block time reversal. 0 = automatic
+#define RIIRAPN_LATENCY   22  //output: delay of the output, in samples
+
+
+static LADSPA_Descriptor *RIIRAPN_Descriptor = NULL;
+
+
+typedef struct {
+  LADSPA_Data fp, qp; //pole frequency and Q, qp = 0 for a first order section
+  unsigned int order; //1 or 2
+  bool complex_poles; //Q>0.5: one chain of complex conjugate stages, else one chain per real pole
+  unsigned int first_chain, num_chains; //the chains of the poles, in cascade mode
+  double a_over_b; //value used in last CCstage calculation
+  double x1; //one numerator input sample ago
+  double x2; //two numerator input samples ago
+} RIIRAPN_section;
+
+
+typedef struct {
+  int mode; //RIIR_MODE_CASCADE or RIIR_MODE_BLOCK, set at activation
+  unsigned int num_sections;
+  RIIRAPN_section section[RIIR_MAX_SECTIONS];
+  riir_allpass filter[RIIR_MAX_SECTIONS]; //the poles and numerator of each section
+  unsigned int num_chains;
+  riir_chain chain[2 * RIIR_MAX_SECTIONS]; //num_stages is the number of stages used for each pole
+  riir_reverser reverser; //block time reversal, of all poles
+  void *arena; //storage of the stages of all sections. NULL until activated
+  double *work[2]; //the block buffers of the stages, in the arena
+  unsigned long startup_samples;
+  unsigned long latency; //delay of the output, in samples
+  silence_gate gate; //skips the calculation while the input is silent
+  telemetry_meter meter; //level of the output in shared memory, see telemetry.h
+} per_instance_data_struct;
+
+
+typedef struct {
+  //this structure holds pointers that are obtained from the LADSPA host
+  //  and other instance-specific data
+  LADSPA_Data *fp_ptr[RIIRAPN_PORT_SECTIONS];
+  LADSPA_Data *qp_ptr[RIIRAPN_PORT_SECTIONS];
+  LADSPA_Data *file_ptr;
+  LADSPA_Data *SNR_ptr;
+  LADSPA_Data *mode_ptr;
+  LADSPA_Data *block_ptr;
+  LADSPA_Data *input_ptr;
+  LADSPA_Data *output_ptr;
+  LADSPA_Data *latency_ptr;
+  float SR; //sample rate of the data stream
+  LADSPA_Data run_adding_gain; //gain applied to the output by run_adding
+  int isa; //instruction set of the processing kernel, see cpu_dispatch.h
+  per_instance_data_struct instance_data; //the filter of this instance. There is no shared storage,
+                                          //  so instances can run in different threads.
+} plugin_data_struct;
+
+
+
+const LADSPA_Descriptor *ladspa_descriptor(unsigned long index) {
+  switch (index) {
+  case 0:
+    return RIIRAPN_Descriptor;
+  default:
+    return NULL;
+  }
+}
+
+
+LADSPA_Handle RIIRAPN_instantiate(const LADSPA_Descriptor *descriptor, unsigned long sample_rate) {
+  //one-liner to create a pointer to a plugin_data_struct and allocate its memory
+  plugin_data_struct *plugin_data = (plugin_data_struct *)calloc(1, sizeof(plugin_data_struct));
+  if (!plugin_data) return NULL;
+  //Use the pointer to store the sample rate
+  plugin_data->SR = (float)sample_rate;
+  plugin_data->run_adding_gain = 1.0;
+  plugin_data->isa = select_cpu_isa("RIIR_APN");
+  //return the pointer plugin_data to the LADSPA host
+  return (LADSPA_Handle)plugin_data;
+}
+
+
+void RIIRAPN_connectPort(LADSPA_Handle instance, unsigned long port, LADSPA_Data *data) {
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  if (port < RIIRAPN_FILE) {
+    if (port % 2 == 0) plugin_data->fp_ptr[port / 2] = data;
+    else plugin_data->qp_ptr[port / 2] = data;
+    return;
+  }
+  switch (port) {
+  case RIIRAPN_FILE:
+    plugin_data->file_ptr = data;
+    break;
+  case RIIRAPN_SNR:
+    plugin_data->SNR_ptr = data;
+    break;
+  case RIIRAPN_INPUT:
+    plugin_data->input_ptr = data;
+    break;
+  case RIIRAPN_OUTPUT:
+    plugin_data->output_ptr = data;
+    break;
+  case RIIRAPN_MODE:
+    plugin_data->mode_ptr = data;
+    break;
+  case RIIRAPN_BLOCK:
+    plugin_data->block_ptr = data;
+    break;
+  case RIIRAPN_LATENCY:
+    plugin_data->latency_ptr = data;
+    break;
+  }
+}
+
+
+
+static bool RIIRAPN_read_sections(const unsigned int number, per_instance_data_struct *id, string *error) {
+  //reads the sections from the section file with the given number, one "fp qp"
+  //  per line. Returns false and describes the problem if it cannot be used.
+  const string path = find_numbered_file(number, ".txt");
+  char line[1024], *p, *next;
+  LADSPA_Data fp, qp;
+
+  if (path.empty()) {
+    *error = "no file for the sections " + to_string(number) + " was found in " + numbered_file_path();
+    return false;
+  }
+  FILE *file = fopen(path.c_str(), "r");
+  if (!file) {
+    *error = path + " cannot be opened";
+    return false;
+  }
+  id->num_sections = 0;
+  while (fgets(line, sizeof(line), file)) {
+    p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (!isdigit((unsigned char)*p) && *p != '-' && *p != '+' && *p != '.') continue;
+    fp = strtod(p, &next);
+    p = next;
+    while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';') p++;
+    qp = strtod(p, &next);
+    if (next == p) qp = 0.0;
+    if (fp == 0.0) continue;
+    if (id->num_sections == RIIR_MAX_SECTIONS) {
+      *error = path + " has more than " + to_string(RIIR_MAX_SECTIONS) + " sections";
+      fclose(file);
+      return false;
+    }
+    id->section[id->num_sections].fp = fp;
+    id->section[id->num_sections].qp = qp;
+    id->num_sections++;
+  }
+  fclose(file);
+  return true;
+} //end RIIRAPN_read_sections
+
+
+static void RIIRAPN_coefficients(const RIIRAPN_section *s, const double SR, riir_allpass *filter) {
+  //calculates the normalized TF coefficients of a section, as in RIIR_AP1 and RIIR_AP2
+  const double K = 2.0*SR;
+  const double K2 = K*K;
+  //calculate analog domain radian frequency
+  double Wp = 2.0*M_PI*s->fp;
+  if (s->order == 1) {
+    //the real pole from the Fpole specification. Adopted from :
+    //https://ccrma.stanford.edu/~jos/pasp/Classic_Virtual_Analog_Phase.html
+    //  The numerator is RP1*x1 - x, as in RIIR_AP1.
+    const double RP1 = (1.0 - tan( Wp/K ))/(1.0 + tan( Wp/K ));
+    filter->d1 = -RP1;
+    filter->d2 = 0.0;
+    filter->b0 = 0.0;
+    filter->b1 = RP1;
+    filter->b2 = -1.0;
+    return;
+  }
+  //TF coefficient calcs adapted from ACDf LADSPA plugin code:
+  double Aa0, Aa1, Aa2, Ab0, Ab1, Ab2; //analog TF coefficients
+  double Da0, Da1, Da2, Db0, Db1, Db2; //IIR digital TF coefficients
+  //apply pre-warping
+  Wp = K*tan( Wp/K );
+  const double Wp2 = Wp*Wp;
+  //2nd order all-pass filter specified by Fp, and Qp
+  Ab2 = 1.0;
+  Ab1 = -1.0 * Wp/s->qp;
+  Ab0 = Wp2;
+  Aa2 = 1.0;
+  Aa1 = Wp/s->qp;
+  Aa0 = Wp2;
+  //convert the analog TF coefficients to z^-1 domain TF coefficients
+  Db0 = Ab2*K2 + Ab1*K + Ab0;
+  Db1 = 2.0*Ab0 - 2.0*Ab2*K2;
+  Db2 = Ab2*K2 - Ab1*K + Ab0;
+  Da0 = Aa2*K2 + Aa1*K + Aa0;
+  Da1 = 2.0*Aa0 - 2.0*Aa2*K2;
+  Da2 = Aa2*K2 - Aa1*K + Aa0;
+  //convert to normalized form by dividing thru by Da0:
+  filter->b0 = Db0 / Da0;
+  filter->b1 = Db1 / Da0;
+  filter->b2 = Db2 / Da0;
+  filter->d1 = Da1 / Da0;
+  filter->d2 = Da2 / Da0;
+} //end RIIRAPN_coefficients
+
+
+static unsigned short RIIRAPN_num_stages(const double magnitude, const double SNR) {
+  //the required number of stages for a pole, using SNR and ABS(c). The number
+  //  is rounded to the nearest integer. A pole near 0 needs only the 0th stage.
+  const double stages = trunc( 0.5 + log2( -SNR / (20.0*log10( magnitude ) ) ) );
+  return (stages > 0.0) ? (unsigned short)stages : 0;
+}
+
+
+static void RIIRAPN_print_latency(const plugin_data_struct *plugin_data) {
+  const per_instance_data_struct *id = &plugin_data->instance_data;
+  cout << "The latency produced by the reverse-IIR processing will be:" << endl;
+  cout << "   " << id->latency << " samples at at sample rate of " << plugin_data->SR << " Hz, or ";
+  cout << fixed << setprecision(3) << 1000.0* id->latency / plugin_data->SR << " milliseconds." << endl;
+}
+
+
+void RIIRAPN_activate(LADSPA_Handle instance) {
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+  const LADSPA_Data SNR = *(plugin_data->SNR_ptr);
+  const unsigned int file_number = (unsigned int)(*(plugin_data->file_ptr) + 0.5);
+  unsigned int order = 0, s, c;
+  string error;
+
+  //free the storage of a previous activation
+  free(id->arena);
+  id->arena = NULL;
+  id->latency = 0;
+  id->num_chains = 0;
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = 0.0;
+
+  //the sections, from the file or from the ports
+  if (file_number > 0) {
+    if (!RIIRAPN_read_sections(file_number, id, &error)) {
+      cout << "RIIR_APN: ERROR: " << error << ". The output is silent." << endl;
+      return;
+    }
+  } else {
+    id->num_sections = 0;
+    for (unsigned int K = 0; K < RIIRAPN_PORT_SECTIONS; K++) {
+      if (*(plugin_data->fp_ptr[K]) == 0.0) continue;
+      id->section[id->num_sections].fp = *(plugin_data->fp_ptr[K]);
+      id->section[id->num_sections].qp = *(plugin_data->qp_ptr[K]);
+      id->num_sections++;
+    }
+  }
+  for (s = 0; s < id->num_sections; s++) {
+    RIIRAPN_section *section = &id->section[s];
+    if (section->fp <= 0.0 || section->fp >= plugin_data->SR / 2.0 || section->qp < 0.0) {
+      cout << "RIIR_APN: ERROR: section " << s + 1 << " with Fp = " << section->fp << " and Qp = " << section->qp;
+      cout << " is not possible at a sample rate of " << plugin_data->SR << " Hz. The output is silent." << endl;
+      return;
+    }
+    section->order = (section->qp == 0.0) ? 1 : 2;
+    section->x1 = 0.0;
+    section->x2 = 0.0;
+    RIIRAPN_coefficients(section, plugin_data->SR, &id->filter[s]);
+    order += section->order;
+  }
+
+  //without sections the output is the input, which needs no blocks
+  id->mode = ( *(plugin_data->mode_ptr) >= 0.5 && id->num_sections > 0 ) ? RIIR_MODE_BLOCK : RIIR_MODE_CASCADE;
+  char info[TELEMETRY_INFO_SIZE];
+  snprintf(info, sizeof(info), "order %u, %s mode", order, ( id->mode == RIIR_MODE_BLOCK ) ? "block" : "cascade");
+  telemetry_open(&id->meter, "RIIR_APN", info, 1, plugin_data->SR);
+  if ( id->mode == RIIR_MODE_BLOCK ) {
+    //block time reversal of the denominators of all sections, with blocks of block_size samples
+    const unsigned long block_size = riir_block_size(*(plugin_data->block_ptr), id->filter, id->num_sections, SNR);
+    //the blocks delay by 2*block_size and each numerator by its order
+    id->latency = 2*block_size + order;
+    if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+    id->arena = riir_alloc_reverser(&id->reverser, id->filter, id->num_sections, block_size, id->work);
+    if (!id->arena) {
+      cout << "RIIR_APN: ERROR: out of memory for blocks of " << block_size << " samples. The output is silent." << endl;
+      return;
+    }
+    //the blocks start out cleared, so nothing is muted
+    id->startup_samples = 0;
+    //the blocks hold 2*block_size samples and the numerators one per order
+    set_silence_gate(&id->gate, id->latency);
+    cout << "For the RIIR_APN instance with " << id->num_sections << " sections of order " << order << " in block mode:" << endl;
+    cout << "   blocks of " << block_size << " samples use " << riir_reverser_size(block_size, id->num_sections) / 1024;
+    cout << " kB of memory." << endl;
+    RIIRAPN_print_latency(plugin_data);
+    cout << "The error from truncating the impulse response is " << setprecision(1);
+    cout << riir_truncation_dB(id->filter, id->num_sections, block_size) << " dB." << endl;
+    return;
+  }
+
+  //one chain for a real pole or a complex conjugate pair, two for two real poles
+  id->startup_samples = 0;
+  for (s = 0; s < id->num_sections; s++) {
+    RIIRAPN_section *section = &id->section[s];
+    const double d1 = id->filter[s].d1, d2 = id->filter[s].d2;
+    double pole[2];
+    section->first_chain = id->num_chains;
+    section->complex_poles = false;
+    if (section->order == 1) {
+      pole[0] = -d1;
+      section->num_chains = 1;
+    } else if (section->qp > 0.5) {
+      //calculate c = a + i*b from biquad coefficients per Martins' post on the KVR forums
+      pole[0] = -d1/2.0;
+      pole[1] = sqrt(d2 - d1*d1/4.0);
+      section->a_over_b = pole[0] / pole[1];
+      section->complex_poles = true;
+      section->num_chains = 1;
+    } else if (section->qp == 0.5) {
+      //for Q=0.5 the poles are identical
+      pole[0] = pole[1] = -d1/2.0;
+      section->num_chains = 2;
+    } else {
+      pole[0] = -d1/2.0 + sqrt( d1*d1/4.0 - d2 );
+      pole[1] = -d1/2.0 - sqrt( d1*d1/4.0 - d2 );
+      section->num_chains = 2;
+    }
+    for (c = 0; c < section->num_chains; c++) {
+      riir_chain *chain = &id->chain[id->num_chains++];
+      chain->is_complex = section->complex_poles;
+      if (chain->is_complex) chain->num_stages = RIIRAPN_num_stages(abs(complex<double>(pole[0], pole[1])), SNR);
+      else chain->num_stages = RIIRAPN_num_stages(fabs(pole[c]), SNR);
+      //each chain delays by 2^(num_stages+1) - 1 samples
+      id->latency += (2ul << chain->num_stages) - 1;
+      //the number of output samples that should be set to zero at startup
+      id->startup_samples += 1ul << chain->num_stages;
+    }
+  }
+  //and each numerator by its order
+  id->latency += order;
+  //the latency is also reported by run, in case the port is connected later
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  //allocate the stages of all poles and their circular buffers, sized 2^stage_index, in one arena
+  id->arena = riir_alloc_chains(id->chain, id->num_chains, id->work);
+  if (!id->arena) {
+    cout << "RIIR_APN: ERROR: out of memory for the stages of " << id->num_sections << " sections. The output is silent." << endl;
+    return;
+  }
+  //loop over the stages and calculate the coefficients, c^2^N:
+  for (s = 0; s < id->num_sections; s++) {
+    const RIIRAPN_section *section = &id->section[s];
+    const double d1 = id->filter[s].d1, d2 = id->filter[s].d2;
+    for (c = section->first_chain; c < section->first_chain + section->num_chains; c++) {
+      riir_chain *chain = &id->chain[c];
+      for (unsigned int stage_index=0; stage_index<=chain->num_stages; stage_index++) {
+        if (section->complex_poles) {
+          const complex<double> complex_pole(-d1/2.0, sqrt(d2 - d1*d1/4.0));
+          const complex<double> complex_temp = pow( complex_pole, pow( 2, stage_index ) );
+          chain->stage[stage_index].a = real( complex_temp );
+          chain->stage[stage_index].b = imag( complex_temp );
+        } else if (section->order == 1) {
+          chain->stage[stage_index].a = pow( -d1, pow( 2, stage_index ) );
+        } else {
+          const double root = (section->qp == 0.5) ? 0.0 : sqrt( d1*d1/4.0 - d2 );
+          const double pole = (c == section->first_chain) ? -d1/2.0 + root : -d1/2.0 - root;
+          chain->stage[stage_index].a = pow( pole, pow( 2, stage_index ) );
+        }
+      }
+    }
+  }
+  //the response is truncated, so the stages hold only zeros once as many silent
+  //  samples have passed through as the stage buffers and the numerators hold
+  set_silence_gate(&id->gate, id->latency);
+  cout << "For the RIIR_APN instance with " << id->num_sections << " sections of order " << order << " and SNR = " << SNR << ":" << endl;
+  for (s = 0; s < id->num_sections; s++) {
+    const RIIRAPN_section *section = &id->section[s];
+    cout << "   section " << s + 1 << " with Fp = " << section->fp;
+    if (section->order == 1) cout << " (first order) requires ";
+    else cout << " and Qp = " << section->qp << " requires ";
+    for (c = section->first_chain; c < section->first_chain + section->num_chains; c++) {
+      if (c > section->first_chain) cout << " + ";
+      cout << id->chain[c].num_stages;
+    }
+    cout << " stages" << endl;
+  }
+  cout << "   The stages use " << riir_chains_size(id->chain, id->num_chains) / 1024 << " kB of memory." << endl;
+  RIIRAPN_print_latency(plugin_data);
+
+} //end activate_RIIRAPN
+
+
+
+
+static void RIIRAPN_clear(per_instance_data_struct *id) {
+  //clears the stage buffers and the numerators of an instance, as when it was activated
+  if (id->mode == RIIR_MODE_BLOCK) riir_clear_reverser(&id->reverser);
+  else riir_clear_chains(id->chain, id->num_chains);
+  for (unsigned int s = 0; s < id->num_sections; s++) {
+    id->section[s].x1 = 0.0;
+    id->section[s].x2 = 0.0;
+  }
+} //end RIIRAPN_clear
+
+
+CPU_KERNEL_INLINE void RIIRAPN_block(per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain,
+                                     const bool adding) {
+  //filters a block of up to RIIR_BLOCK samples, one stage at a time
+  double *x = id->work[0], *y;
+  unsigned long n;
+  unsigned int s, c;
+  //begin RIIR calculation of poles (denominator of TF)
+  if ( id->mode == RIIR_MODE_BLOCK ) {
+    //all poles at once, by block time reversal
+    riir_run_reverser(&id->reverser, input, x, count);
+  } else {
+    for (n = 0; n < count; n++) x[n] = input[n];
+    for (s = 0; s < id->num_sections; s++) {
+      const RIIRAPN_section *section = &id->section[s];
+      if ( section->complex_poles ) {
+        //two complex conjugate poles. The input is real:
+        y = (x == id->work[0]) ? id->work[1] : id->work[0];
+        for (n = 0; n < count; n++) {
+          y[2*n] = x[n];
+          y[2*n+1] = 0.0;
+        }
+        y = riir_run_chain(&id->chain[section->first_chain], y, x, count);
+        // final combines the real and imaginary outputs:
+        x = (y == id->work[0]) ? id->work[1] : id->work[0];
+        for (n = 0; n < count; n++) x[n] = y[2*n] + section->a_over_b * y[2*n+1];
+      } else {
+        //one or two real poles, in series
+        for (c = section->first_chain; c < section->first_chain + section->num_chains; c++) {
+          x = riir_run_chain(&id->chain[c], x, (x == id->work[0]) ? id->work[1] : id->work[0], count);
+        }
+      }
+    }
+  }
+  //numerators of the TF of each section, into the other buffer
+  for (s = 0; s < id->num_sections; s++) {
+    RIIRAPN_section *section = &id->section[s];
+    y = (x == id->work[0]) ? id->work[1] : id->work[0];
+    const double b0 = id->filter[s].b0, b1 = id->filter[s].b1, b2 = id->filter[s].b2;
+    y[0] = b0 * section->x2 + b1 * section->x1 + b2 * x[0];
+    if (count > 1) y[1] = b0 * section->x1 + b1 * x[0] + b2 * x[1];
+    for (n = 2; n < count; n++) y[n] = b0 * x[n-2] + b1 * x[n-1] + b2 * x[n];
+    //update values for x1, x2
+    section->x2 = (count > 1) ? x[count-2] : section->x1;
+    section->x1 = x[count-1];
+    x = y;
+  }
+  riir_write_output(x, output, count, muted, gain, adding);
+} //end RIIRAPN_block
+
+CPU_DISPATCH_KERNELS(RIIRAPN_block, (per_instance_data_struct *id, const LADSPA_Data *input, LADSPA_Data *output,
+                     const unsigned long count, const unsigned long muted, const LADSPA_Data gain, const bool adding),
+                     (id, input, output, count, muted, gain, adding))
+
+
+static inline void RIIRAPN_process(LADSPA_Handle instance, unsigned long sample_count, const bool adding) {
+  //filters the input. The result replaces the contents of the output buffer
+  //  (run) or is multiplied by the run_adding gain and added to it (run_adding).
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  const LADSPA_Data *input = plugin_data->input_ptr;
+  LADSPA_Data *output = plugin_data->output_ptr;
+  const LADSPA_Data gain = plugin_data->run_adding_gain;
+  unsigned long muted; //number of output samples that are discarded during startup
+  unsigned long count;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+
+  if (plugin_data->latency_ptr) *(plugin_data->latency_ptr) = (LADSPA_Data)id->latency;
+  if (!id->arena) {
+    //not activated, out of memory or the sections cannot be used
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  //the output should be discarded until startup_samples samples have passed through
+  muted = id->startup_samples;
+  if (muted > sample_count) muted = sample_count;
+  id->startup_samples -= muted;
+  if (silence_gate_skip(&id->gate, is_silent(input, sample_count), sample_count)) {
+    write_silence(output, sample_count, adding);
+    return;
+  }
+  void (*kernel)(per_instance_data_struct *, const LADSPA_Data *, LADSPA_Data *, const unsigned long,
+                 const unsigned long, const LADSPA_Data, const bool) = CPU_DISPATCH_SELECT(RIIRAPN_block, plugin_data->isa);
+  for (unsigned long pos = 0; pos < sample_count; pos += count) {
+    count = (sample_count - pos < RIIR_BLOCK) ? sample_count - pos : RIIR_BLOCK;
+    kernel(id, input + pos, output + pos, count, (muted > pos) ? muted - pos : 0, gain, adding);
+  }
+  if (silence_gate_closing(&id->gate)) RIIRAPN_clear(id);
+} //end RIIRAPN_process
+
+
+static inline void RIIRAPN_meter(LADSPA_Handle instance, unsigned long sample_count, const int64_t start) {
+  plugin_data_struct *plugin_data = (plugin_data_struct *)instance;
+  per_instance_data_struct *id = &plugin_data->instance_data;
+  const unsigned int state = id->gate.closed ? TELEMETRY_IDLE : TELEMETRY_ACTIVE;
+  telemetry_update(&id->meter, &plugin_data->output_ptr, sample_count, state, start);
+}
+
+
+void RIIRAPN_run(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAPN_process(instance, sample_count, false);
+  RIIRAPN_meter(instance, sample_count, start);
+} //end run_RIIRAPN.
+
+
+void RIIRAPN_run_adding(LADSPA_Handle instance, unsigned long sample_count) {
+  const int64_t start = telemetry_start(&((plugin_data_struct *)instance)->instance_data.meter);
+  RIIRAPN_process(instance, sample_count, true);
+  RIIRAPN_meter(instance, sample_count, start);
+} //end RIIRAPN_run_adding
+
+
+void RIIRAPN_set_run_adding_gain(LADSPA_Handle instance, LADSPA_Data gain) {
+  ((plugin_data_struct *)instance)->run_adding_gain = gain;
+}
+
+
+
+void RIIRAPN_cleanup(LADSPA_Handle instance) {
+  telemetry_close(&((plugin_data_struct *)instance)->instance_data.meter);
+  //free the stage storage of this instance only
+  free(((plugin_data_struct *)instance)->instance_data.arena);
+  //free memory obtained via malloc for the LADSPA plugin interface
+  free(instance);
+}
+
+
+
+static class Initialiser {
+public:
+  Initialiser() {
+    char **port_names;
+    LADSPA_PortDescriptor *port_descriptors;
+    LADSPA_PortRangeHint *port_range_hints;
+    RIIRAPN_Descriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+    const unsigned long num_ports = 23;
+    string text;
+
+    if (RIIRAPN_Descriptor) {
+      //plugin descriptor info
+      RIIRAPN_Descriptor->UniqueID = 5240;
+      RIIRAPN_Descriptor->Label = "RIIR_APN";
+      RIIRAPN_Descriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
+      RIIRAPN_Descriptor->Name = "Reverse IIR Nth order AllPass Filter";
+      RIIRAPN_Descriptor->Maker = "Charlie Laub, 2025";
+      RIIRAPN_Descriptor->Copyright = "GPL";
+      RIIRAPN_Descriptor->PortCount = num_ports;
+
+      //create storage for port_descriptors, port_range_hints, and port_names
+      port_descriptors = (LADSPA_PortDescriptor *)calloc(num_ports,sizeof(LADSPA_PortDescriptor));
+      RIIRAPN_Descriptor->PortDescriptors = (const LADSPA_PortDescriptor *)port_descriptors;
+      port_range_hints = (LADSPA_PortRangeHint *)calloc(num_ports,sizeof(LADSPA_PortRangeHint));
+      RIIRAPN_Descriptor->PortRangeHints = (const LADSPA_PortRangeHint *)port_range_hints;
+      port_names = (char **)calloc(num_ports, sizeof(char*));
+      RIIRAPN_Descriptor->PortNames = (const char **)port_names;
+      //done creating storage. now set the descriptor, range_hints, and name for each port:
+
+      for (unsigned int K = 0; K < RIIRAPN_PORT_SECTIONS; K++) {
+        //port = pole frequency of section K+1. 0 = not used
+        port_descriptors[RIIRAPN_FP(K)] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "fp" + to_string(K + 1);
+        port_names[RIIRAPN_FP(K)] = strdup(text.c_str());
+        port_range_hints[RIIRAPN_FP(K)].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0;
+        port_range_hints[RIIRAPN_FP(K)].LowerBound = 0.0;
+        port_range_hints[RIIRAPN_FP(K)].UpperBound = 100000.0;
+
+        //port = pole Q of section K+1. 0 = first order
+        port_descriptors[RIIRAPN_QP(K)] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+        text = "qp" + to_string(K + 1);
+        port_names[RIIRAPN_QP(K)] = strdup(text.c_str());
+        port_range_hints[RIIRAPN_QP(K)].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0;
+        port_range_hints[RIIRAPN_QP(K)].LowerBound = 0.0;
+        port_range_hints[RIIRAPN_QP(K)].UpperBound = 20.0;
+      }
+
+      //port = number of the section file. 0 = use the ports
+      port_descriptors[RIIRAPN_FILE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "file";
+      port_names[RIIRAPN_FILE] = strdup(text.c_str());
+      port_range_hints[RIIRAPN_FILE].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAPN_FILE].LowerBound = 0;
+      port_range_hints[RIIRAPN_FILE].UpperBound = RIIRAPN_MAX_FILE_NUMBER;
+
+      //port = Signal to Noise Ratio
+      port_descriptors[RIIRAPN_SNR] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "snr";
+      port_names[RIIRAPN_SNR] = strdup(text.c_str());
+      port_range_hints[RIIRAPN_SNR].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_MIDDLE;
+      port_range_hints[RIIRAPN_SNR].LowerBound = 10.0;
+      port_range_hints[RIIRAPN_SNR].UpperBound = 150.0;
+
+      //port = audio data INPUT
+      port_descriptors[RIIRAPN_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+      text = "Input";
+      port_names[RIIRAPN_INPUT] = strdup(text.c_str());
+
+      //port = audio data OUTPUT
+      port_descriptors[RIIRAPN_OUTPUT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+      text = "Output";
+      port_names[RIIRAPN_OUTPUT] = strdup(text.c_str());
+
+      //port = calculation method, selected at activation
+      port_descriptors[RIIRAPN_MODE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "mode";
+      port_names[RIIRAPN_MODE] = strdup(text.c_str());
+      port_range_hints[RIIRAPN_MODE].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAPN_MODE].LowerBound = RIIR_MODE_CASCADE;
+      port_range_hints[RIIRAPN_MODE].UpperBound = RIIR_MODE_BLOCK;
+
+      //port = block size of block time reversal, in samples
+      port_descriptors[RIIRAPN_BLOCK] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+      text = "block";
+      port_names[RIIRAPN_BLOCK] = strdup(text.c_str());
+      port_range_hints[RIIRAPN_BLOCK].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0;
+      port_range_hints[RIIRAPN_BLOCK].LowerBound = 0;
+      port_range_hints[RIIRAPN_BLOCK].UpperBound = RIIR_MAX_BLOCK;
+
+      //port = latency, the delay of the output in samples
+      port_descriptors[RIIRAPN_LATENCY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+      text = "latency";
+      port_names[RIIRAPN_LATENCY] = strdup(text.c_str());
+      port_range_hints[RIIRAPN_LATENCY].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER;
+      port_range_hints[RIIRAPN_LATENCY].LowerBound = 0;
+
+      RIIRAPN_Descriptor->activate = RIIRAPN_activate;
+      RIIRAPN_Descriptor->cleanup = RIIRAPN_cleanup;
+      RIIRAPN_Descriptor->connect_port = RIIRAPN_connectPort;
+      RIIRAPN_Descriptor->deactivate = NULL;
+      RIIRAPN_Descriptor->instantiate = RIIRAPN_instantiate;
+      RIIRAPN_Descriptor->run = RIIRAPN_run;
+      RIIRAPN_Descriptor->run_adding = RIIRAPN_run_adding;
+      RIIRAPN_Descriptor->set_run_adding_gain = RIIRAPN_set_run_adding_gain;
+    }
+  }
+  ~Initialiser() {
+    if (RIIRAPN_Descriptor) {
+      free((LADSPA_PortDescriptor *)RIIRAPN_Descriptor->PortDescriptors);
+      free((char **)RIIRAPN_Descriptor->PortNames);
+      free((LADSPA_PortRangeHint *)RIIRAPN_Descriptor->PortRangeHints);
+      free(RIIRAPN_Descriptor);
+    }
+  }
+} g_theInitialiser;
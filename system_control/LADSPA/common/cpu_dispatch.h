@@ -0,0 +1,153 @@
+/* cpu_dispatch.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Runtime selection of instruction set specific processing kernels for the
+  GSASysCon LADSPA plugins.
+
+  The plugins are compiled for a generic target so that one binary runs on
+  every CPU of a given architecture. Each plugin compiles its processing
+  kernel several times, once for each instruction set (ISA) listed below, and
+  chooses the fastest one that the CPU supports when the plugin is
+  instantiated:
+    x86/x86_64:  baseline (SSE2), avx2 (AVX2 + FMA), avx512 (AVX-512F/DQ)
+    ARM 32 bit:  baseline, neon
+    ARM 64 bit:  neon (NEON is always present and is the baseline)
+
+  The choice can be overridden for testing by setting the environment variable
+  GSASYSCON_ISA to one of: baseline, avx2, avx512, neon
+  If the requested ISA is not supported by the CPU, a message is printed and
+  the automatic choice is used instead.
+
+  USAGE:
+  Write the kernel as a static function that is always inlined, using the
+  CPU_KERNEL_INLINE macro. Then use CPU_DISPATCH_KERNELS to compile a copy of
+  the kernel for each ISA, and CPU_DISPATCH_SELECT to get a pointer to the
+  copy for the chosen ISA:
+    CPU_KERNEL_INLINE void my_kernel(plugin *p, unsigned long n) { ... }
+    CPU_DISPATCH_KERNELS(my_kernel, (plugin *p, unsigned long n), (p, n))
+    ...
+    p->kernel = CPU_DISPATCH_SELECT(my_kernel, select_cpu_isa("MyPlugin"));
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#if defined(__arm__)
+#include <sys/auxv.h>
+#endif
+
+
+#define CPU_ISA_BASELINE  0
+#define CPU_ISA_AVX2      1
+#define CPU_ISA_AVX512    2
+#define CPU_ISA_NEON      3
+#define CPU_NUM_ISAS      4
+#define CPU_ISA_ENV_VARIABLE "GSASYSCON_ISA"
+
+static const char *cpu_isa_names[CPU_NUM_ISAS] = { "baseline", "avx2", "avx512", "neon" };
+
+//kernels must be inlined into each of the ISA specific functions
+#define CPU_KERNEL_INLINE static inline __attribute__((always_inline))
+
+#if defined(__x86_64__) || defined(__i386__)
+  #define CPU_TARGET_AVX2    __attribute__((target("avx2,fma")))
+  #define CPU_TARGET_AVX512  __attribute__((target("avx512f,avx512dq,avx2,fma")))
+  #define CPU_DISPATCH_KERNELS(name, params, args) \
+    static void name##_baseline params { name args; } \
+    CPU_TARGET_AVX2 static void name##_avx2 params { name args; } \
+    CPU_TARGET_AVX512 static void name##_avx512 params { name args; }
+  #define CPU_DISPATCH_SELECT(name, isa) \
+    ((isa) == CPU_ISA_AVX512 ? name##_avx512 : ((isa) == CPU_ISA_AVX2 ? name##_avx2 : name##_baseline))
+#elif defined(__arm__) && !defined(__ARM_NEON)
+  //32 bit ARM built without NEON, e.g. for the original Raspberry Pi
+  #define CPU_TARGET_NEON    __attribute__((target("fpu=neon")))
+  #define CPU_DISPATCH_KERNELS(name, params, args) \
+    static void name##_baseline params { name args; } \
+    CPU_TARGET_NEON static void name##_neon params { name args; }
+  #define CPU_DISPATCH_SELECT(name, isa) \
+    ((isa) == CPU_ISA_NEON ? name##_neon : name##_baseline)
+#else
+  //the baseline of the target already includes the best available ISA (e.g. NEON on
+  //  64 bit ARM) or the target is not known. Only one kernel is compiled.
+  #define CPU_DISPATCH_KERNELS(name, params, args) \
+    static void name##_baseline params { name args; }
+  #define CPU_DISPATCH_SELECT(name, isa) \
+    ((void)(isa), name##_baseline)
+#endif
+
+
+static inline bool cpu_supports_isa(const int isa) {
+  //returns true if the CPU supports the ISA and a kernel is compiled for it
+  switch (isa) {
+#if defined(__x86_64__) || defined(__i386__)
+  case CPU_ISA_BASELINE:
+    return true;
+  case CPU_ISA_AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case CPU_ISA_AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+        && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(__arm__) && !defined(__ARM_NEON)
+  case CPU_ISA_BASELINE:
+    return true;
+  case CPU_ISA_NEON:
+    return (getauxval(AT_HWCAP) & (1 << 12)) != 0; //HWCAP_NEON
+#elif defined(__ARM_NEON)
+  case CPU_ISA_NEON:
+    return true;
+#else
+  case CPU_ISA_BASELINE:
+    return true;
+#endif
+  default:
+    return false;
+  }
+} //end cpu_supports_isa
+
+
+static inline int select_cpu_isa(const char *plugin_name) {
+  //returns the ISA that the plugin should use. This is the most capable ISA
+  //  supported by the CPU unless another one has been requested through the
+  //  environment variable CPU_ISA_ENV_VARIABLE.
+  int isa, best_isa = CPU_ISA_BASELINE;
+  const int preference[CPU_NUM_ISAS] = { CPU_ISA_AVX512, CPU_ISA_AVX2, CPU_ISA_NEON, CPU_ISA_BASELINE };
+  for (int i = 0; i < CPU_NUM_ISAS; i++) {
+    if (cpu_supports_isa(preference[i])) {
+      best_isa = preference[i];
+      break;
+    }
+  }
+  const char *requested = getenv(CPU_ISA_ENV_VARIABLE);
+  if (requested == NULL || requested[0] == '\0') return best_isa;
+  for (isa = 0; isa < CPU_NUM_ISAS; isa++) {
+    if (strcmp(requested, cpu_isa_names[isa]) == 0) break;
+  }
+  if (isa < CPU_NUM_ISAS && cpu_supports_isa(isa)) {
+    std::cout << plugin_name << ": using the " << cpu_isa_names[isa] << " kernel as requested by ";
+    std::cout << CPU_ISA_ENV_VARIABLE << std::endl;
+    return isa;
+  }
+  std::cout << plugin_name << ": " << CPU_ISA_ENV_VARIABLE << "=" << requested;
+  std::cout << " is not supported on this CPU. Using the " << cpu_isa_names[best_isa] << " kernel." << std::endl;
+  return best_isa;
+} //end select_cpu_isa
+
+#endif
@@ -0,0 +1,92 @@
+/* numbered_file.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Finds the data files of the GSASysCon LADSPA plugins by their number.
+
+  A Gstreamer pipeline can only pass numbers to a LADSPA plugin, so files such
+  as the impulse responses of the Convolver are given by a number. The files
+  are kept in the directories of the environment variable GSASYSCON_IR_PATH,
+  separated by a colon as for LADSPA_PATH, or in NUMBERED_FILE_DEFAULT_PATH if
+  it is not set. The file with the number n is the file whose name starts with
+  n followed by an underscore or a period and that ends in one of the allowed
+  extensions, e.g. 12_left_room_correction.wav.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NUMBERED_FILE_H
+#define NUMBERED_FILE_H
+
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <string>
+
+#define NUMBERED_FILE_PATH_VARIABLE  "GSASYSCON_IR_PATH"
+#define NUMBERED_FILE_DEFAULT_PATH   "/usr/local/share/gsasyscon/ir"
+
+
+static bool has_extension(const char *name, const char *extension) {
+  //case insensitive test of the file name extension
+  const size_t length = strlen(name), ext_length = strlen(extension);
+  return (length > ext_length) && (strcasecmp(name + length - ext_length, extension) == 0);
+}
+
+
+static std::string numbered_file_path() {
+  //returns the directories that are searched, separated by ':'
+  const char *env = getenv(NUMBERED_FILE_PATH_VARIABLE);
+  return (env && env[0]) ? env : NUMBERED_FILE_DEFAULT_PATH;
+}
+
+
+static std::string find_numbered_file(const unsigned int number, const char *extension,
+                                      const char *other_extension = NULL) {
+  //returns the path of the file with the given number and one of the
+  //  extensions, or an empty string. The directories are searched in the order
+  //  of the path. If a directory holds more than one matching file, the first
+  //  one in alphabetical order is used.
+  const std::string path = numbered_file_path();
+  std::string directory, found;
+  size_t start = 0, end;
+  struct dirent *entry;
+  char *rest;
+
+  while (start <= path.length()) {
+    end = path.find(':', start);
+    if (end == std::string::npos) end = path.length();
+    directory = path.substr(start, end - start);
+    start = end + 1;
+    if (directory.empty()) continue;
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) continue;
+    found.clear();
+    while ((entry = readdir(dir)) != NULL) {
+      if (!isdigit((unsigned char)entry->d_name[0])) continue;
+      if (strtoul(entry->d_name, &rest, 10) != number) continue;
+      if (*rest != '_' && *rest != '.') continue;
+      if (!has_extension(entry->d_name, extension) &&
+          !(other_extension && has_extension(entry->d_name, other_extension))) continue;
+      if (found.empty() || found.compare(entry->d_name) > 0) found = entry->d_name;
+    }
+    closedir(dir);
+    if (!found.empty()) return directory + "/" + found;
+  }
+  return "";
+} //end find_numbered_file
+
+#endif
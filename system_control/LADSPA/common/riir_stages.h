@@ -0,0 +1,482 @@
+/* riir_stages.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Storage and kernels of the reverse IIR (RIIR) plugins RIIR_AP1, RIIR_AP2
+  and RIIR_APN. The poles of the filter are applied in reverse time by one of two
+  methods: the cascade of stages by Martin Vicanek, or block time reversal.
+
+  CASCADE OF STAGES:
+
+  A pole is reversed by a chain of stages. Stage k delays its input by 2^k
+  samples and adds the input times c^(2^k), where c is the pole:
+     y[n] = c^(2^k) * x[n] + x[n - 2^k]
+  Each stage holds its last 2^k inputs in a ring buffer. For a complex pole
+  the samples are complex, with the real and imaginary parts interleaved in
+  the ring buffer and in the work buffers. The chains of an instance are
+  stored in a single arena: one block of memory, aligned to RIIR_ALIGNMENT
+  bytes, that holds the two work buffers, the stage data of all chains and
+  all ring buffers, each of which starts on a cache line.
+
+  The stages are feed-forward, so a block of samples is run through a chain
+  one stage at a time: each stage processes the whole block before the next
+  one starts. Only the first 2^k outputs of a block need the ring buffer, the
+  others use the input block itself, and the ring buffer is updated with the
+  last 2^k inputs of the block at the end. The ring buffers are sized to a
+  power of 2, so the wrap around is a mask, and the loops over the samples
+  are contiguous and are vectorized by the compiler (SIMD along time). The
+  plugins compile their block kernel for each ISA with cpu_dispatch.h.
+  The number of stages, and with it the latency and the memory, grow with
+  the SNR and with the time constant of the pole.
+
+  BLOCK TIME REVERSAL:
+  The method of Powell and Chau. The input is divided into blocks of L
+  samples. When a block is complete, the all-pole filter 1/D(z) is run
+  backwards over it, starting from zero. Its response continues into the
+  previous block with zero input. This tail only depends on the final state
+  of the filter, so it is a sum of two fixed responses weighted by the state
+  (state correction); these are calculated when the plugin is activated. The
+  previous block is then finished: its own response plus the tail of the new
+  block. The response of a sample is thereby truncated after L+1 to 2L
+  samples, and the output is delayed by 2L samples. Latency and memory (5
+  blocks) are set by the block size alone and the CPU load is one recursion
+  per sample, independent of the pole. The filter is a cascade of sections
+  D(z) = 1 + d1 z^-1 + d2 z^-2, each holding two real poles, a complex
+  conjugate pair or (d2 = 0) one real pole. The block is run backwards
+  through one section after the other. The tail of the cascade depends on
+  the final states of all sections, two per section, so a block of any
+  number of sections has the same latency of 2L. The memory is 3 + 2 blocks
+  per section.
+  The arena belongs to the instance and is only touched by the thread that
+  runs it, so instances can run in different threads (e.g. in separate
+  Gstreamer streaming threads) without any locking.
+
+  USAGE:
+  Set num_stages and is_complex of each chain and call riir_alloc_chains when
+  the plugin is activated. It sets the stage pointers of the chains and the
+  work buffers and returns the arena, which the plugin frees with free() when
+  it is activated again or cleaned up. The coefficients a and b of the stages
+  are then set by the plugin. In run, copy up to RIIR_BLOCK input samples to
+  a work buffer, run it through the chains with riir_run_chain, calculate the
+  numerator of the filter and write the result with riir_write_output.
+  For block time reversal call riir_alloc_reverser instead, and
+  riir_run_reverser to fill the work buffer. riir_block_size chooses the
+  block size for an SNR and riir_truncation_dB gives the resulting error.
+  The filter is then given as an array of sections, one per biquad.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RIIR_STAGES_H
+#define RIIR_STAGES_H
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <ladspa.h>
+#include "cpu_dispatch.h"
+
+#define RIIR_ALIGNMENT 64  //alignment of the arena and of each ring buffer, in bytes (a cache line)
+#define RIIR_BLOCK   1024  //samples processed at a time, the size of the work buffers
+
+//values of the mode port of the plugins:
+#define RIIR_MODE_CASCADE   0  //cascade of stages, set by the SNR
+#define RIIR_MODE_BLOCK     1  //block time reversal, set by the block size
+#define RIIR_MIN_BLOCK     64  //range of the block size of block time reversal
+#define RIIR_MAX_BLOCK  65536
+#define RIIR_RESPONSE_LIMIT  (1ul << 22)  //longest impulse response followed to find the truncation error
+#define RIIR_MAX_SECTIONS  16  //most sections of one reverser
+
+
+typedef struct {
+  double a; //real part of c^(2^k)
+  double b; //imaginary part of c^(2^k), complex poles only
+  double *ring; //the last cb_size inputs. Real and imaginary parts are interleaved for complex poles
+  unsigned int cb_index; //circular buffer position of the oldest input
+  unsigned int cb_size; //size of circular buffer, 2^k
+} riir_stage;
+
+
+typedef struct {
+  unsigned short num_stages; //index of the last stage; there is a 0th stage
+  bool is_complex; //true for a complex pole, which needs the imag pipeline
+  riir_stage *stage; //num_stages + 1 stages, in the arena
+} riir_chain;
+
+
+static inline size_t riir_aligned(const size_t bytes) {
+  //rounds the size up to a multiple of RIIR_ALIGNMENT
+  return (bytes + RIIR_ALIGNMENT - 1) & ~(size_t)(RIIR_ALIGNMENT - 1);
+}
+
+
+typedef struct {
+  double d1, d2; //the poles of the filter, D(z) = 1 + d1 z^-1 + d2 z^-2
+  double b0, b1, b2; //the numerator of the plugin, which is applied after the poles:
+                     //  out[n] = b0*w[n-2] + b1*w[n-1] + b2*w[n]
+} riir_allpass;
+
+
+typedef struct {
+  unsigned int num_sections;
+  double d[RIIR_MAX_SECTIONS][2]; //d1 and d2 of each section, see riir_allpass
+  unsigned long size; //the block size L
+  unsigned long fill; //samples of the current block received so far
+  double *input; //the current block
+  double *own; //the response of the previous block to its own samples
+  double *output; //the finished block before the previous one, read out while the current block is received
+  double *tail[2 * RIIR_MAX_SECTIONS]; //the response of the cascade over a block to a state of 1 in w[n+1]
+                                       //  (tail[2k]) or w[n+2] (tail[2k+1]) of section k, in reverse time
+} riir_reverser;
+
+
+static size_t riir_chains_size(const riir_chain *chains, const unsigned int num_chains) {
+  //returns the size of the arena of the chains, in bytes
+  size_t size = 2 * riir_aligned(2 * RIIR_BLOCK * sizeof(double)); //the work buffers
+  for (unsigned int c = 0; c < num_chains; c++) {
+    size += riir_aligned((chains[c].num_stages + 1) * sizeof(riir_stage));
+    for (unsigned int k = 0; k <= chains[c].num_stages; k++) {
+      size += (chains[c].is_complex ? 2 : 1) * riir_aligned(((size_t)1 << k) * sizeof(double));
+    }
+  }
+  return size;
+} //end riir_chains_size
+
+
+static void *riir_alloc_chains(riir_chain *chains, const unsigned int num_chains, double *work[2]) {
+  //allocates the arena for the chains and sets their stage pointers and the two
+  //  work buffers of RIIR_BLOCK complex samples. The ring buffers are cleared.
+  //  Returns the arena, or NULL if out of memory.
+  const size_t work_size = riir_aligned(2 * RIIR_BLOCK * sizeof(double));
+  const size_t size = riir_chains_size(chains, num_chains);
+  unsigned int c, k;
+  char *arena, *next;
+
+  if (posix_memalign((void **)&arena, RIIR_ALIGNMENT, size) != 0) return NULL;
+  memset(arena, 0, size);
+  //the work buffers and the stage data of all chains first, then the ring buffers in stage order
+  work[0] = (double *)arena;
+  work[1] = (double *)(arena + work_size);
+  next = arena + 2 * work_size;
+  for (c = 0; c < num_chains; c++) {
+    chains[c].stage = (riir_stage *)next;
+    next += riir_aligned((chains[c].num_stages + 1) * sizeof(riir_stage));
+  }
+  for (c = 0; c < num_chains; c++) {
+    for (k = 0; k <= chains[c].num_stages; k++) {
+      riir_stage *s = &chains[c].stage[k];
+      s->cb_size = 1u << k;
+      s->ring = (double *)next;
+      next += (chains[c].is_complex ? 2 : 1) * riir_aligned(s->cb_size * sizeof(double));
+    }
+  }
+  return arena;
+} //end riir_alloc_chains
+
+
+static void riir_clear_chains(riir_chain *chains, const unsigned int num_chains) {
+  //clears the ring buffers, as when the arena was allocated
+  for (unsigned int c = 0; c < num_chains; c++) {
+    for (unsigned int k = 0; k <= chains[c].num_stages; k++) {
+      riir_stage *s = &chains[c].stage[k];
+      memset(s->ring, 0, (chains[c].is_complex ? 2 : 1) * s->cb_size * sizeof(double));
+      s->cb_index = 0;
+    }
+  }
+} //end riir_clear_chains
+
+
+static size_t riir_reverser_size(const unsigned long block_size, const unsigned int num_sections) {
+  //returns the size of the arena of a reverser, in bytes
+  return 2 * riir_aligned(2 * RIIR_BLOCK * sizeof(double)) + (3 + 2 * num_sections) * riir_aligned(block_size * sizeof(double));
+}
+
+
+static void *riir_alloc_reverser(riir_reverser *r, const riir_allpass *sections, const unsigned int num_sections,
+                                 const unsigned long block_size, double *work[2]) {
+  //allocates the arena for block time reversal of the poles of the sections
+  //  (at most RIIR_MAX_SECTIONS) with blocks of block_size samples, calculates
+  //  the tail responses and sets the two work buffers. Returns the arena, or
+  //  NULL if out of memory.
+  const size_t work_size = riir_aligned(2 * RIIR_BLOCK * sizeof(double));
+  const size_t block_bytes = riir_aligned(block_size * sizeof(double));
+  const size_t size = riir_reverser_size(block_size, num_sections);
+  double w[RIIR_MAX_SECTIONS][2]; //w[n+1] and w[n+2] of each section
+  double u, next;
+  unsigned int j, k;
+  char *arena;
+
+  if (posix_memalign((void **)&arena, RIIR_ALIGNMENT, size) != 0) return NULL;
+  memset(arena, 0, size);
+  work[0] = (double *)arena;
+  work[1] = (double *)(arena + work_size);
+  r->input = (double *)(arena + 2 * work_size);
+  r->own = (double *)(arena + 2 * work_size + block_bytes);
+  r->output = (double *)(arena + 2 * work_size + 2 * block_bytes);
+  for (j = 0; j < 2 * num_sections; j++) r->tail[j] = (double *)(arena + 2 * work_size + (3 + j) * block_bytes);
+  r->size = block_size;
+  r->fill = 0;
+  r->num_sections = num_sections;
+  for (k = 0; k < num_sections; k++) {
+    r->d[k][0] = sections[k].d1;
+    r->d[k][1] = sections[k].d2;
+  }
+  //the responses of the cascade to each state, with zero input. Going backwards
+  //  in time, sample n of the previous block is reached after size - n steps.
+  for (j = 0; j < 2 * num_sections; j++) {
+    memset(w, 0, sizeof(w));
+    w[j / 2][j % 2] = 1.0;
+    for (unsigned long n = block_size; n-- > 0; ) {
+      u = 0.0;
+      for (k = 0; k < num_sections; k++) {
+        next = u - r->d[k][0] * w[k][0] - r->d[k][1] * w[k][1];
+        w[k][1] = w[k][0];
+        w[k][0] = next;
+        u = next;
+      }
+      r->tail[j][n] = u;
+    }
+  }
+  return arena;
+} //end riir_alloc_reverser
+
+
+static void riir_clear_reverser(riir_reverser *r) {
+  //clears the blocks, as when the arena was allocated
+  memset(r->input, 0, r->size * sizeof(double));
+  memset(r->own, 0, r->size * sizeof(double));
+  memset(r->output, 0, r->size * sizeof(double));
+  r->fill = 0;
+}
+
+
+CPU_KERNEL_INLINE void riir_reverse_block(riir_reverser *r) {
+  //called when the input block is complete. Finishes the previous block into
+  //  output and keeps the response of the new block to its own samples.
+  double *block = r->input;
+  double state[2 * RIIR_MAX_SECTIONS] = { 0.0 }; //the final w[n+1], w[n+2] of each section
+  unsigned long n;
+  unsigned int j, k;
+
+  //the response of the block to its own samples, backwards from zero state, in
+  //  place, one section after the other
+  for (k = 0; k < r->num_sections; k++) {
+    const double d1 = r->d[k][0], d2 = r->d[k][1];
+    double w, w1 = 0.0, w2 = 0.0; //w[n], w[n+1], w[n+2] of the section in reverse time
+    for (n = r->size; n-- > 0; ) {
+      w = block[n] - d1 * w1 - d2 * w2;
+      w2 = w1;
+      w1 = w;
+      block[n] = w;
+    }
+    state[2*k] = w1;
+    state[2*k+1] = w2;
+  }
+  //the tail of the response in the previous block, from the final states, finishes it
+  const double *tail0 = r->tail[0], *tail1 = r->tail[1], *own = r->own;
+  double *output = r->output;
+  const double s0 = state[0], s1 = state[1];
+  for (n = 0; n < r->size; n++) output[n] = own[n] + s0 * tail0[n] + s1 * tail1[n];
+  for (j = 2; j < 2 * r->num_sections; j += 2) {
+    const double *tailj0 = r->tail[j], *tailj1 = r->tail[j+1];
+    const double sj0 = state[j], sj1 = state[j+1];
+    for (n = 0; n < r->size; n++) output[n] += sj0 * tailj0[n] + sj1 * tailj1[n];
+  }
+  //the new block is now the own response, the old one is reused for the next input
+  r->input = r->own;
+  r->own = block;
+} //end riir_reverse_block
+
+
+static double riir_truncation_dB(const riir_allpass *sections, const unsigned int num_sections,
+                                 const unsigned long block_size) {
+  //returns the error of block time reversal with blocks of block_size samples
+  //  relative to the output for white noise, in dB. The response of the poles
+  //  is truncated after block_size + 1 samples. The error is the energy of the
+  //  truncated part, after the numerators, relative to the energy of the whole
+  //  response of the filter. The response is followed until it has decayed by 300dB.
+  double h[RIIR_MAX_SECTIONS][3]; //the response after the poles of each section, h[n], h[n-1], h[n-2]
+  double g[RIIR_MAX_SECTIONS][3]; //the response after the numerator of each section
+  double t[RIIR_MAX_SECTIONS][3]; //the truncated response after the numerator of each section
+  double u, v, total = 0.0, error = 0.0, poles = 0.0, state;
+  unsigned int k;
+
+  memset(h, 0, sizeof(h));
+  memset(g, 0, sizeof(g));
+  memset(t, 0, sizeof(t));
+  for (unsigned long n = 0; n < RIIR_RESPONSE_LIMIT; n++) {
+    //the poles of all sections
+    u = (n == 0) ? 1.0 : 0.0;
+    for (k = 0; k < num_sections; k++) {
+      const riir_allpass *s = &sections[k];
+      u = u - s->d1 * h[k][1] - s->d2 * h[k][2];
+      h[k][0] = u;
+    }
+    poles += u * u;
+    //the numerator of each section combines three samples of the response in reverse time
+    v = (n > block_size) ? u : 0.0;
+    for (k = 0; k < num_sections; k++) {
+      const riir_allpass *s = &sections[k];
+      g[k][0] = u;
+      t[k][0] = v;
+      u = s->b2 * g[k][2] + s->b1 * g[k][1] + s->b0 * g[k][0];
+      v = s->b2 * t[k][2] + s->b1 * t[k][1] + s->b0 * t[k][0];
+    }
+    total += u * u;
+    error += v * v;
+    //shift the histories and stop when the poles have decayed
+    state = 0.0;
+    for (k = 0; k < num_sections; k++) {
+      h[k][2] = h[k][1];
+      h[k][1] = h[k][0];
+      g[k][2] = g[k][1];
+      g[k][1] = g[k][0];
+      t[k][2] = t[k][1];
+      t[k][1] = t[k][0];
+      state += h[k][1] * h[k][1] + h[k][2] * h[k][2];
+    }
+    if (n > block_size && state < 1.e-30 * poles) break;
+  }
+  return 10.0 * log10(error / total + 1.e-300);
+} //end riir_truncation_dB
+
+
+static unsigned long riir_block_size(const LADSPA_Data requested, const riir_allpass *sections,
+                                     const unsigned int num_sections, const double SNR) {
+  //returns the block size for block time reversal. 0 requests the smallest
+  //  power of 2 that truncates the response at -SNR dB or below.
+  unsigned long size;
+  if (requested >= 1.0) {
+    size = (unsigned long)requested;
+  } else {
+    for (size = RIIR_MIN_BLOCK; size < RIIR_MAX_BLOCK; size *= 2) {
+      if (riir_truncation_dB(sections, num_sections, size) <= -SNR) break;
+    }
+  }
+  if (size < RIIR_MIN_BLOCK) size = RIIR_MIN_BLOCK;
+  if (size > RIIR_MAX_BLOCK) size = RIIR_MAX_BLOCK;
+  return size;
+} //end riir_block_size
+
+
+CPU_KERNEL_INLINE void riir_run_reverser(riir_reverser *r, const LADSPA_Data *input, double *result,
+                                         unsigned long count) {
+  //stores count input samples and returns in result the output of the
+  //  all-pole filter in reverse time, delayed by 2 blocks
+  while (count) {
+    unsigned long n = r->size - r->fill;
+    if (n > count) n = count;
+    const double *finished = r->output + r->fill;
+    double *block = r->input + r->fill;
+    for (unsigned long i = 0; i < n; i++) {
+      block[i] = input[i];
+      result[i] = finished[i];
+    }
+    r->fill += n;
+    input += n;
+    result += n;
+    count -= n;
+    if (r->fill == r->size) {
+      riir_reverse_block(r);
+      r->fill = 0;
+    }
+  }
+} //end riir_run_reverser
+
+
+CPU_KERNEL_INLINE void riir_real_stage(riir_stage *s, const double *__restrict in, double *__restrict out,
+                                       const unsigned long count) {
+  //runs count samples of a real pole through the stage: out[n] = a*in[n] + in[n-cb_size]
+  const double a = s->a;
+  const unsigned long size = s->cb_size, mask = size - 1;
+  const unsigned long from_ring = (count < size) ? count : size; //outputs that need an input of the previous blocks
+  const double *ring = s->ring;
+  unsigned long done, len, at, n;
+
+  //the first outputs use the ring buffer, in up to two contiguous parts
+  for (done = 0; done < from_ring; done += len) {
+    at = (s->cb_index + done) & mask;
+    len = (from_ring - done < size - at) ? from_ring - done : size - at;
+    for (n = 0; n < len; n++) out[done + n] = a * in[done + n] + ring[at + n];
+  }
+  //the others use the inputs of this block
+  for (n = from_ring; n < count; n++) out[n] = a * in[n] + in[n - size];
+  //keep the last inputs for the next block
+  for (done = count - from_ring; done < count; done += len) {
+    at = (s->cb_index + done) & mask;
+    len = (count - done < size - at) ? count - done : size - at;
+    memcpy(s->ring + at, in + done, len * sizeof(double));
+  }
+  s->cb_index = (s->cb_index + count) & mask;
+} //end riir_real_stage
+
+
+CPU_KERNEL_INLINE void riir_complex_stage(riir_stage *s, const double *__restrict in, double *__restrict out,
+                                          const unsigned long count) {
+  //as riir_real_stage for a complex pole. The samples are complex, with
+  //  interleaved real and imaginary parts: out[n] = (a + ib)*in[n] + in[n-cb_size]
+  const double a = s->a, b = s->b;
+  const unsigned long size = s->cb_size, mask = size - 1;
+  const unsigned long from_ring = (count < size) ? count : size;
+  const double *ring = s->ring;
+  unsigned long done, len, at, n;
+
+  for (done = 0; done < from_ring; done += len) {
+    at = (s->cb_index + done) & mask;
+    len = (from_ring - done < size - at) ? from_ring - done : size - at;
+    const double *x = in + 2*done, *r = ring + 2*at;
+    double *y = out + 2*done;
+    for (n = 0; n < len; n++) {
+      y[2*n]   = a * x[2*n] - b * x[2*n+1] + r[2*n];
+      y[2*n+1] = b * x[2*n] + a * x[2*n+1] + r[2*n+1];
+    }
+  }
+  for (n = from_ring; n < count; n++) {
+    out[2*n]   = a * in[2*n] - b * in[2*n+1] + in[2*(n-size)];
+    out[2*n+1] = b * in[2*n] + a * in[2*n+1] + in[2*(n-size)+1];
+  }
+  for (done = count - from_ring; done < count; done += len) {
+    at = (s->cb_index + done) & mask;
+    len = (count - done < size - at) ? count - done : size - at;
+    memcpy(s->ring + 2*at, in + 2*done, 2 * len * sizeof(double));
+  }
+  s->cb_index = (s->cb_index + count) & mask;
+} //end riir_complex_stage
+
+
+CPU_KERNEL_INLINE double *riir_run_chain(riir_chain *chain, double *block, double *spare, const unsigned long count) {
+  //runs a block of up to RIIR_BLOCK samples through all stages of the chain,
+  //  one stage after the other. The stages alternate between the two buffers.
+  //  Returns the buffer that holds the result, block or spare.
+  for (unsigned int k = 0; k <= chain->num_stages; k++) {
+    if (chain->is_complex) riir_complex_stage(&chain->stage[k], block, spare, count);
+    else riir_real_stage(&chain->stage[k], block, spare, count);
+    double *swap = block;
+    block = spare;
+    spare = swap;
+  }
+  return block;
+} //end riir_run_chain
+
+
+CPU_KERNEL_INLINE void riir_write_output(const double *result, LADSPA_Data *output, const unsigned long count,
+                                         const unsigned long muted, const LADSPA_Data gain, const bool adding) {
+  //writes the result to the output, or multiplies it by the run_adding gain and
+  //  adds it (run_adding). The first muted samples are discarded (startup).
+  unsigned long n = (muted < count) ? muted : count;
+  if (!adding) for (unsigned long i = 0; i < n; i++) output[i] = 0.0;
+  if (adding) for (; n < count; n++) output[n] += gain * result[n];
+  else for (; n < count; n++) output[n] = result[n];
+} //end riir_write_output
+
+#endif
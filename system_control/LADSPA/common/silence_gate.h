@@ -0,0 +1,139 @@
+/* silence_gate.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Silence detection for the GSASysCon LADSPA plugins.
+
+  A GSASysCon system often runs around the clock while the input is digital
+  silence. The filters would still be calculated for every sample and ACDf
+  even adds a tiny square wave (DENORMALKILLER) that keeps the output from
+  ever reaching zero. The silence gate lets a plugin skip the calculation once
+  the input has been silent for long enough that the state of its filters has
+  decayed below SILENCE_THRESHOLD. While the gate is closed the plugin outputs
+  exact zeros (run) or leaves the output buffer unchanged (run_adding). The
+  first block that contains a sample above the threshold opens the gate again
+  and is processed normally, starting from the cleared filter state.
+
+  A sample is silent when its magnitude is below SILENCE_THRESHOLD (-180dB
+  relative to full scale). The LADSPA interface does not pass on the GAP flag
+  of Gstreamer buffers, but a GAP buffer contains neutral data, i.e. zeros for
+  audio, so it is detected as silence from its content.
+
+  USAGE:
+  Set the hold time, i.e. the number of silent input samples after which the
+  state of the filter has decayed, when the plugin is activated. Then, in run:
+    if (silence_gate_skip(&gate, is_silent(input, n), n)) {
+      write_silence(output, n, adding);
+      return;
+    }
+    ...process the block...
+    if (silence_gate_closing(&gate)) ...clear the filter state...
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SILENCE_GATE_H
+#define SILENCE_GATE_H
+
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <ladspa.h>
+
+#define SILENCE_THRESHOLD 1.e-9  //-180dB, the level below which a sample is silent
+#define SILENCE_DECAY     1.e-12 //-240dB, the decay of a filter before its state is cleared
+  //SILENCE_DECAY is 60dB below SILENCE_THRESHOLD to allow for the gain of resonant
+  //  filters and of repeated poles, which decay more slowly than a single pole.
+
+
+typedef struct {
+  unsigned long hold; //number of silent input samples after which the filter state has decayed
+  unsigned long count; //number of silent input samples since the last non-silent one
+  bool closed; //true while the calculation is skipped
+} silence_gate;
+
+
+static inline bool is_silent(const LADSPA_Data *buffer, const unsigned long sample_count) {
+  //returns true if all samples in the buffer are below SILENCE_THRESHOLD. Audio
+  //  that is not silent returns at the first sample, so this is cheap.
+  for (unsigned long pos = 0; pos < sample_count; pos++) {
+    if (fabsf(buffer[pos]) >= (LADSPA_Data)SILENCE_THRESHOLD) return false;
+  }
+  return true;
+}
+
+
+static inline void set_silence_gate(silence_gate *g, const unsigned long hold) {
+  //sets the hold time and opens the gate. Used when the plugin is activated.
+  g->hold = hold;
+  g->count = 0;
+  g->closed = false;
+}
+
+
+static inline bool silence_gate_skip(silence_gate *g, const bool silent, const unsigned long sample_count) {
+  //called at the beginning of each run with the result of is_silent for the
+  //  input. Returns true if the gate is closed and the block does not have to
+  //  be calculated. A block that is not silent opens the gate.
+  if (!silent) {
+    g->count = 0;
+    g->closed = false;
+    return false;
+  }
+  if (g->closed) return true;
+  if (g->count < ULONG_MAX - sample_count) g->count += sample_count;
+  return false;
+}
+
+
+static inline bool silence_gate_closing(silence_gate *g) {
+  //called after a block was calculated. Returns true, once, when the input has
+  //  been silent for the hold time. The caller must then clear the filter state
+  //  so that the calculation resumes from a clean state when the gate opens.
+  if (g->closed || g->count < g->hold) return false;
+  g->closed = true;
+  return true;
+}
+
+
+static inline void write_silence(LADSPA_Data *output, const unsigned long sample_count, const bool adding) {
+  //the output of a closed gate: zeros for run, nothing to add for run_adding
+  if (!adding) memset(output, 0, sample_count * sizeof(LADSPA_Data));
+}
+
+
+static inline unsigned long silence_decay_samples(const double a1, const double a2) {
+  //returns the number of samples after which the response of a first or second
+  //  order filter with the denominator 1 + a1*z^-1 + a2*z^-2 has decayed by
+  //  SILENCE_DECAY, from the radius of its largest pole. Two samples are added
+  //  for the numerator. An unstable filter never decays.
+  double radius, root;
+  root = a1 * a1 - 4.0 * a2;
+  if (root < 0.0) {
+    radius = sqrt(a2);
+  } else {
+    root = sqrt(root);
+    radius = fmax(fabs(-a1 + root), fabs(-a1 - root)) * 0.5;
+  }
+  if (radius >= 1.0) return ULONG_MAX;
+  if (radius < SILENCE_DECAY) return 2;
+  return 2 + (unsigned long)ceil(log(SILENCE_DECAY) / log(radius));
+}
+
+
+static inline unsigned long add_silence_hold(const unsigned long a, const unsigned long b) {
+  //adds two hold times, e.g. of filters in series, without overflowing
+  return (a > ULONG_MAX - b) ? ULONG_MAX : a + b;
+}
+
+#endif
@@ -0,0 +1,383 @@
+/* telemetry.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Level meters of the GSASysCon LADSPA plugins in shared memory.
+
+  When the environment variable GSASYSCON_TELEMETRY is set to 1 for the host
+  process (GSASysCon does this for the system parameter TELEMETRY = true),
+  each plugin instance publishes the peak and RMS level of its outputs, the
+  number of clipped samples and its state in a record of the shared memory
+  segment /dev/shm/gsasyscon_telemetry. The records are read by the program
+  gsasyscon_meters (see ../tools), e.g. from show_client_status_info. All
+  processes on a computer share the segment; each record holds the pid of the
+  process that owns it, and records of processes that have ended are reused.
+
+  run only adds a pass over its output to the levels of the current interval,
+  and once per TELEMETRY_INTERVAL_MS it writes them to its record. The record
+  is protected by a sequence lock: the writer makes the sequence number odd
+  while it changes the record and even again when it is done, and a reader
+  copies the record and accepts the copy only if the sequence number was even
+  and did not change. The writer never waits for a reader. Without
+  GSASYSCON_TELEMETRY no segment is opened and run skips the meters after
+  testing one pointer.
+
+  With GSASYSCON_TELEMETRY=2 (TELEMETRY = timing) the calls of run are timed
+  as well. Each instance counts its calls in a histogram of their duration,
+  with buckets of powers of 2 ns, and sums their time and samples. It also
+  keeps the longest call and the largest load, the ratio of the time of one
+  call to the duration of the samples it processed (the buffer period). A
+  load of 1 or more means that the plugin alone took longer than real time.
+  The sums are kept by the instance and are written to the record together
+  with the levels, so run does not write to shared memory for each call.
+  Timing takes two reads of the clock per call. The sums are plain counters,
+  not relaxed atomics: only the thread that runs the instance writes them
+  (the LADSPA host does not call run of one instance from two threads at
+  once), and readers only see the copy in the record, which the sequence
+  lock already keeps consistent. Atomic counters would add nothing but a
+  locked instruction per counter on some CPUs.
+
+  USAGE:
+    meter.record = NULL                                       in instantiate
+    telemetry_open(&meter, label, info, channels, rate)      in activate
+    start = telemetry_start(&meter)                           at the start of run
+    telemetry_update(&meter, outputs, n, state, start)        at the end of run
+    telemetry_close(&meter)                                   in cleanup
+  info is a short text that identifies the instance, e.g. its parameters.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <ladspa.h>
+
+#define TELEMETRY_ENV_VARIABLE "GSASYSCON_TELEMETRY"
+#define TELEMETRY_SEGMENT      "/gsasyscon_telemetry"  //name for shm_open, the file /dev/shm/gsasyscon_telemetry
+#define TELEMETRY_MAGIC        0x54415347u  //"GSAT"
+#define TELEMETRY_VERSION      2
+#define TELEMETRY_MAX_RECORDS  256  //plugin instances of all processes
+#define TELEMETRY_MAX_CHANNELS   8
+#define TELEMETRY_LABEL_SIZE    24
+#define TELEMETRY_INFO_SIZE     64
+#define TELEMETRY_INTERVAL_MS  100  //time between the updates of a record
+#define TELEMETRY_CLIP_LEVEL   1.0f //samples at or above this level are counted as clipped
+#define TELEMETRY_TIMING_BUCKETS 32  //bucket k of the histogram counts calls of run of 2^k to 2^(k+1)-1 ns
+
+//the state of a plugin instance
+#define TELEMETRY_ACTIVE 0  //processing audio
+#define TELEMETRY_IDLE   1  //the input is silent and the calculation is skipped (see silence_gate.h)
+#define TELEMETRY_OFF    2  //the output is switched off, e.g. by OnOffDelay
+
+
+typedef struct {
+  std::atomic<uint32_t> sequence; //odd while the record is written
+  std::atomic<int32_t> owner; //pid of the process of the instance, 0 if the record is free
+  uint32_t num_channels;
+  uint32_t state;
+  uint32_t rate;
+  uint32_t reserved;
+  uint64_t updates; //number of updates since the record was taken
+  int64_t time; //CLOCK_MONOTONIC time of the last update in ns
+  int64_t opened; //CLOCK_MONOTONIC time at which the record was taken, orders the plugins of a process
+  char label[TELEMETRY_LABEL_SIZE];
+  char info[TELEMETRY_INFO_SIZE];
+  float peak[TELEMETRY_MAX_CHANNELS]; //largest absolute sample of the last interval
+  float rms[TELEMETRY_MAX_CHANNELS]; //RMS level of the last interval
+  uint64_t clips[TELEMETRY_MAX_CHANNELS]; //clipped samples since the record was taken
+  //the timing of run since the record was taken, if timed is 1:
+  uint32_t timed;
+  float worst_load; //largest ratio of the time of a call to the duration of its samples
+  uint64_t calls;
+  uint64_t run_ns; //total time of the calls
+  uint64_t run_samples; //total number of samples processed by the calls
+  uint64_t worst_ns; //time of the longest call
+  uint64_t histogram[TELEMETRY_TIMING_BUCKETS]; //number of calls by their time
+} telemetry_record;
+
+
+typedef struct {
+  std::atomic<uint32_t> magic; //TELEMETRY_MAGIC once the segment has been set up
+  uint32_t version;
+  uint32_t max_records;
+  uint32_t record_size;
+  telemetry_record record[TELEMETRY_MAX_RECORDS];
+} telemetry_segment;
+
+
+typedef struct {
+  telemetry_record *record; //NULL when telemetry is off
+  unsigned int num_channels;
+  unsigned long interval; //samples per update
+  unsigned long count; //samples in the current interval
+  float peak[TELEMETRY_MAX_CHANNELS];
+  double sum[TELEMETRY_MAX_CHANNELS]; //sum of the squared samples
+  uint64_t clips[TELEMETRY_MAX_CHANNELS];
+  bool timed; //run is timed
+  double rate; //samples per ns, to calculate the load
+  float worst_load;
+  uint64_t calls, run_ns, run_samples, worst_ns;
+  uint64_t histogram[TELEMETRY_TIMING_BUCKETS];
+} telemetry_meter;
+
+
+static inline int64_t telemetry_clock() {
+  //monotonic time in ns
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+
+static inline telemetry_segment *telemetry_map(const bool writable) {
+  //maps the segment, creating it if writable is true. Returns NULL on failure.
+  const int flags = writable ? O_RDWR | O_CREAT : O_RDONLY;
+  int file = shm_open(TELEMETRY_SEGMENT, flags, 0666);
+  struct stat status;
+  void *memory;
+  if (file < 0) return NULL;
+  if (writable) {
+    //all users may meter, whatever the umask of the first process is
+    fchmod(file, 0666);
+    if (fstat(file, &status) == 0 && status.st_size < (off_t)sizeof(telemetry_segment)) {
+      if (ftruncate(file, sizeof(telemetry_segment)) != 0) {
+        close(file);
+        return NULL;
+      }
+    }
+  } else if (fstat(file, &status) != 0 || status.st_size < (off_t)sizeof(telemetry_segment)) {
+    close(file);
+    return NULL;
+  }
+  memory = mmap(NULL, sizeof(telemetry_segment), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (memory == MAP_FAILED) return NULL;
+  telemetry_segment *segment = (telemetry_segment *)memory;
+  if (writable && segment->magic.load() != TELEMETRY_MAGIC) {
+    //a new segment is all zeros, i.e. all records are free
+    segment->version = TELEMETRY_VERSION;
+    segment->max_records = TELEMETRY_MAX_RECORDS;
+    segment->record_size = sizeof(telemetry_record);
+    segment->magic.store(TELEMETRY_MAGIC);
+  }
+  if (segment->version != TELEMETRY_VERSION || segment->record_size != sizeof(telemetry_record)) {
+    if (writable) fprintf(stderr, "telemetry: /dev/shm%s was made by another version of the plugins. "
+                                  "Delete it while no pipeline runs.\n", TELEMETRY_SEGMENT);
+    munmap(memory, sizeof(telemetry_segment));
+    return NULL;
+  }
+  return segment;
+} //end telemetry_map
+
+
+static inline telemetry_segment *telemetry_segment_of_process(bool *timed) {
+  //the segment, mapped once per process when telemetry is enabled, else NULL.
+  //  timed is set to true if run is timed as well.
+  static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  static telemetry_segment *segment = NULL;
+  static bool tried = false, timing = false;
+  pthread_mutex_lock(&lock);
+  if (!tried) {
+    const char *enabled = getenv(TELEMETRY_ENV_VARIABLE);
+    tried = true;
+    if (enabled && (strcmp(enabled, "1") == 0 || strcmp(enabled, "2") == 0)) {
+      segment = telemetry_map(true);
+      timing = (enabled[0] == '2');
+    }
+  }
+  pthread_mutex_unlock(&lock);
+  *timed = timing;
+  return segment;
+}
+
+
+static inline bool telemetry_owner_alive(const int32_t pid) {
+  return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+
+static inline void telemetry_open(telemetry_meter *m, const char *label, const char *info,
+                                  const unsigned int num_channels, const unsigned long rate) {
+  //takes a free record for the plugin instance, or keeps its record when it is
+  //  activated again. Records of processes that have ended are free.
+  bool timed;
+  telemetry_segment *segment = telemetry_segment_of_process(&timed);
+  const int32_t pid = getpid();
+  telemetry_record *r = m->record;
+  const bool new_record = (r == NULL); //no record yet, one is claimed below
+  if (!segment) return;
+  for (int i = 0; i < TELEMETRY_MAX_RECORDS && !r; i++) {
+    int32_t owner = segment->record[i].owner.load();
+    if (owner != 0 && telemetry_owner_alive(owner)) continue;
+    if (segment->record[i].owner.compare_exchange_strong(owner, pid)) r = &segment->record[i];
+  }
+  if (!r) return;
+  const uint32_t sequence = r->sequence.load(std::memory_order_relaxed);
+  r->sequence.store(sequence | 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  r->num_channels = (num_channels < TELEMETRY_MAX_CHANNELS) ? num_channels : TELEMETRY_MAX_CHANNELS;
+  r->state = TELEMETRY_ACTIVE;
+  r->rate = rate;
+  r->updates = 0;
+  r->time = telemetry_clock();
+  if (new_record) r->opened = r->time;
+  strncpy(r->label, label, TELEMETRY_LABEL_SIZE - 1);
+  r->label[TELEMETRY_LABEL_SIZE - 1] = '\0';
+  strncpy(r->info, info, TELEMETRY_INFO_SIZE - 1);
+  r->info[TELEMETRY_INFO_SIZE - 1] = '\0';
+  memset(r->peak, 0, sizeof(r->peak));
+  memset(r->rms, 0, sizeof(r->rms));
+  memset(r->clips, 0, sizeof(r->clips));
+  r->timed = timed;
+  r->worst_load = 0.0f;
+  r->calls = r->run_ns = r->run_samples = r->worst_ns = 0;
+  memset(r->histogram, 0, sizeof(r->histogram));
+  r->sequence.store((sequence | 1) + 1, std::memory_order_release);
+
+  memset(m, 0, sizeof(telemetry_meter));
+  m->record = r;
+  m->num_channels = r->num_channels;
+  m->timed = timed;
+  m->rate = rate * 1.e-9;
+  m->interval = (unsigned long)(rate * TELEMETRY_INTERVAL_MS / 1000);
+  if (m->interval == 0) m->interval = 1;
+} //end telemetry_open
+
+
+static inline void telemetry_measure(const LADSPA_Data *x, const unsigned long n, float *peak, double *sum, uint64_t *clips) {
+  //adds the levels of a block of one channel. Written so that the compiler vectorizes it.
+  float block_peak = 0.0f, block_sum = 0.0f;
+  unsigned int block_clips = 0; //a 32 bit count, the same width as the samples, vectorizes better
+  for (unsigned long i = 0; i < n; i++) {
+    const float a = fabsf(x[i]);
+    block_peak = (a > block_peak) ? a : block_peak;
+    block_sum += x[i] * x[i];
+    block_clips += (a >= TELEMETRY_CLIP_LEVEL);
+  }
+  if (block_peak > *peak) *peak = block_peak;
+  *sum += block_sum;
+  *clips += block_clips;
+}
+
+
+static inline void telemetry_publish(telemetry_meter *m, const unsigned int state) {
+  //writes the levels of the interval to the record
+  telemetry_record *r = m->record;
+  const uint32_t sequence = r->sequence.load(std::memory_order_relaxed);
+  r->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (unsigned int ch = 0; ch < m->num_channels; ch++) {
+    r->peak[ch] = m->peak[ch];
+    r->rms[ch] = (float)sqrt(m->sum[ch] / m->count);
+    r->clips[ch] = m->clips[ch];
+    m->peak[ch] = 0.0f;
+    m->sum[ch] = 0.0;
+  }
+  if (m->timed) {
+    r->worst_load = m->worst_load;
+    r->calls = m->calls;
+    r->run_ns = m->run_ns;
+    r->run_samples = m->run_samples;
+    r->worst_ns = m->worst_ns;
+    memcpy(r->histogram, m->histogram, sizeof(r->histogram));
+  }
+  r->state = state;
+  r->updates++;
+  r->time = telemetry_clock();
+  r->sequence.store(sequence + 2, std::memory_order_release);
+  m->count = 0;
+} //end telemetry_publish
+
+
+static inline int64_t telemetry_start(const telemetry_meter *m) {
+  //called at the start of run. Returns the time if run is timed, else 0.
+  return (m->record && m->timed) ? telemetry_clock() : 0;
+}
+
+
+static inline void telemetry_time(telemetry_meter *m, const unsigned long sample_count, const int64_t start) {
+  //adds a call of run that began at start
+  const int64_t elapsed = telemetry_clock() - start;
+  const uint64_t ns = (elapsed > 0) ? elapsed : 0;
+  int bucket = (ns > 0) ? 63 - __builtin_clzll(ns) : 0;
+  if (bucket >= TELEMETRY_TIMING_BUCKETS) bucket = TELEMETRY_TIMING_BUCKETS - 1;
+  m->histogram[bucket]++;
+  m->calls++;
+  m->run_ns += ns;
+  m->run_samples += sample_count;
+  if (ns > m->worst_ns) m->worst_ns = ns;
+  if (sample_count > 0) {
+    const float load = (float)(ns * m->rate / sample_count);
+    if (load > m->worst_load) m->worst_load = load;
+  }
+}
+
+
+static inline void telemetry_update(telemetry_meter *m, LADSPA_Data *const *outputs, const unsigned long sample_count,
+                                    const unsigned int state, const int64_t start) {
+  //called at the end of run with the outputs of the plugin and the result of
+  //  telemetry_start. The outputs of a plugin in the state TELEMETRY_IDLE are
+  //  silent and are not read.
+  if (!m->record) return;
+  if (start) telemetry_time(m, sample_count, start);
+  if (state != TELEMETRY_IDLE) {
+    for (unsigned int ch = 0; ch < m->num_channels; ch++) {
+      telemetry_measure(outputs[ch], sample_count, &m->peak[ch], &m->sum[ch], &m->clips[ch]);
+    }
+  }
+  m->count += sample_count;
+  if (m->count >= m->interval) telemetry_publish(m, state);
+}
+
+
+static inline void telemetry_close(telemetry_meter *m) {
+  //frees the record of the plugin instance
+  if (!m->record) return;
+  m->record->owner.store(0);
+  m->record = NULL;
+}
+
+
+static inline bool telemetry_read(const telemetry_record *r, telemetry_record *copy) {
+  //copies the record for a reader. Returns false if the record is free or the
+  //  writer changed it during the copy; the reader then tries again later.
+  const uint32_t before = r->sequence.load(std::memory_order_acquire);
+  if (before & 1) return false;
+  memcpy((void *)copy, (const void *)r, sizeof(telemetry_record));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (r->sequence.load(std::memory_order_relaxed) != before) return false;
+  return copy->owner.load(std::memory_order_relaxed) != 0;
+}
+
+
+static inline const char *telemetry_state_name(const unsigned int state) {
+  static const char *names[] = { "active", "idle", "off" };
+  return (state <= TELEMETRY_OFF) ? names[state] : "?";
+}
+
+#endif
@@ -0,0 +1,201 @@
+/* gsasyscon_meters
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Shows the level meters of the GSASysCon LADSPA plugins. When the host
+  process runs with GSASYSCON_TELEMETRY=1 (the system parameter TELEMETRY =
+  true in GSASysCon), each plugin instance publishes the peak and RMS level of
+  its outputs, the number of clipped samples and its state in shared memory,
+  see ../common/telemetry.h. This program prints them as a table with one line
+  per channel:
+    PID      the process of the plugin, e.g. gst-launch-1.0
+    PLUGIN   the label of the plugin and INFO, its main parameters
+    CH       the output channel
+    PEAK     the largest sample of the last 100ms, in dBFS
+    RMS      the RMS level of the last 100ms, in dBFS
+    CLIPS    the number of samples at or above full scale since activation
+    STATE    active, idle (the input is silent and the calculation is
+             skipped) or off (the output is switched off by OnOffDelay)
+    AGE      the time since the last update. It grows while the audio stops.
+  With GSASYSCON_TELEMETRY=2 (TELEMETRY = timing) the plugins also time their
+  calls of run. A second table then shows one line per plugin:
+    CALLS    the number of calls of run since activation
+    BLOCK    the average number of samples per call
+    NS/SMP   the average time per sample, in ns
+    CPU%     the time taken by run relative to the duration of the audio it
+             processed, the share of one CPU core the plugin needs
+    P50, P99 the time of a call that 50% and 99% of the calls did not exceed,
+             in us. These come from a histogram with buckets of powers of 2,
+             so they are upper bounds that are up to twice the real value.
+    WORST    the time of the longest call, in us
+    LOAD%    the largest time of a call relative to the duration of its
+             samples, the buffer period. At 100% or more the plugin alone
+             could not keep up with real time during that call.
+  The plugins are listed per process in the order in which they were
+  activated, which is the order of the pipeline. Reading the meters does not
+  affect the audio processing.
+
+  Usage: gsasyscon_meters [-p pid] [-w seconds]
+    -p  only show the plugins of the process pid
+    -w  repeat every seconds until interrupted
+
+  GSASysCon shows the meters of running clients with show_client_status_info.
+  Build and install it from the tools directory with:
+    make
+    sudo make install
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <ladspa.h>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include "telemetry.h"
+using namespace std;
+
+#define METERS_READ_TRIES 100  //attempts to read a record while its plugin updates it
+
+
+static string level_dB(const float level) {
+  //a level in dBFS with one decimal
+  char text[16];
+  if (!(level > 0.0f)) return "-inf";
+  snprintf(text, sizeof(text), "%.1f", 20.0 * log10(level));
+  return text;
+}
+
+
+static bool read_record(const telemetry_record *r, telemetry_record *copy) {
+  //copies a record that is in use. Retries while its plugin is updating it.
+  const struct timespec pause = { 0, 100000 }; //0.1ms
+  for (int i = 0; i < METERS_READ_TRIES; i++) {
+    if (telemetry_read(r, copy)) return true;
+    if (r->owner.load() == 0) return false;
+    nanosleep(&pause, NULL);
+  }
+  return false;
+}
+
+
+static double percentile_us(const telemetry_record *r, const double fraction) {
+  //the upper limit of the histogram bucket that holds the call at fraction, in us
+  const uint64_t rank = (uint64_t)ceil(fraction * r->calls);
+  uint64_t count = 0;
+  for (int k = 0; k < TELEMETRY_TIMING_BUCKETS; k++) {
+    count += r->histogram[k];
+    if (count >= rank) return ldexp(1.0, k + 1) * 1.e-3;
+  }
+  return ldexp(1.0, TELEMETRY_TIMING_BUCKETS) * 1.e-3;
+}
+
+
+static void show_timing(const vector<telemetry_record> &copies, const int count) {
+  //prints the timing of run of the plugins that are timed
+  bool timed = false;
+  for (int i = 0; i < count; i++) timed |= (copies[i].timed && copies[i].calls > 0);
+  if (!timed) return;
+  printf("\n%-8s %-14s %10s %6s %8s %6s %8s %8s %8s %6s  %s\n", "PID", "PLUGIN", "CALLS", "BLOCK", "NS/SMP", "CPU%",
+         "P50 us", "P99 us", "WORST us", "LOAD%", "INFO");
+  for (int i = 0; i < count; i++) {
+    const telemetry_record &r = copies[i];
+    if (!r.timed || r.calls == 0 || r.run_samples == 0) continue;
+    const double ns_per_sample = (double)r.run_ns / r.run_samples;
+    printf("%-8d %-14s %10llu %6.0f %8.2f %6.2f %8.1f %8.1f %8.1f %6.1f  %s\n", r.owner.load(), r.label,
+           (unsigned long long)r.calls, (double)r.run_samples / r.calls, ns_per_sample, ns_per_sample * r.rate * 1.e-7,
+           percentile_us(&r, 0.50), percentile_us(&r, 0.99), r.worst_ns * 1.e-3, r.worst_load * 100.0, r.info);
+  }
+} //end show_timing
+
+
+static int show_meters(const telemetry_segment *segment, const int32_t pid) {
+  //prints the table. Returns the number of plugins shown.
+  vector<const telemetry_record *> records;
+  for (int i = 0; i < TELEMETRY_MAX_RECORDS; i++) {
+    const int32_t owner = segment->record[i].owner.load();
+    if (owner == 0 || !telemetry_owner_alive(owner)) continue;
+    if (pid && owner != pid) continue;
+    records.push_back(&segment->record[i]);
+  }
+  //the plugins of a process are shown in the order in which they were activated
+  sort(records.begin(), records.end(), [](const telemetry_record *a, const telemetry_record *b) {
+    const int32_t owner_a = a->owner.load(), owner_b = b->owner.load();
+    return (owner_a != owner_b) ? owner_a < owner_b : a->opened < b->opened;
+  });
+  const int64_t now = telemetry_clock();
+  vector<telemetry_record> copies(records.size());
+  int shown = 0;
+  if (records.empty()) return 0;
+  printf("%-8s %-14s %3s %9s %9s %7s %-7s %6s  %s\n", "PID", "PLUGIN", "CH", "PEAK dBFS", "RMS dBFS", "CLIPS",
+         "STATE", "AGE", "INFO");
+  for (const telemetry_record *r : records) {
+    telemetry_record &copy = copies[shown];
+    char age[16];
+    if (!read_record(r, &copy)) continue;
+    if (copy.updates == 0) strcpy(age, "-");
+    else snprintf(age, sizeof(age), "%.1fs", (now - copy.time) * 1.e-9);
+    for (unsigned int ch = 0; ch < copy.num_channels && ch < TELEMETRY_MAX_CHANNELS; ch++) {
+      if (ch == 0) {
+        printf("%-8d %-14s ", copy.owner.load(), copy.label);
+      } else {
+        printf("%-8s %-14s ", "", "");
+      }
+      printf("%3u %9s %9s %7llu %-7s %6s  %s\n", ch + 1, level_dB(copy.peak[ch]).c_str(), level_dB(copy.rms[ch]).c_str(),
+             (unsigned long long)copy.clips[ch], telemetry_state_name(copy.state), (ch == 0) ? age : "",
+             (ch == 0) ? copy.info : "");
+    }
+    shown++;
+  }
+  show_timing(copies, shown);
+  return shown;
+} //end show_meters
+
+
+int main(int argc, char **argv) {
+  int32_t pid = 0;
+  double interval = 0.0;
+  int arg;
+
+  for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (!strcmp(argv[arg], "-p") && arg + 1 < argc) pid = atoi(argv[++arg]);
+    else if (!strcmp(argv[arg], "-w") && arg + 1 < argc) interval = atof(argv[++arg]);
+    else break;
+  }
+  if (arg < argc || pid < 0 || interval < 0.0) {
+    fprintf(stderr, "usage: gsasyscon_meters [-p pid] [-w seconds]\n");
+    fprintf(stderr, "  prints the level meters of the GSASysCon LADSPA plugins, only those of the\n");
+    fprintf(stderr, "  process pid with -p. -w repeats this every seconds.\n");
+    return 2;
+  }
+  const telemetry_segment *segment = telemetry_map(false);
+  if (!segment) {
+    fprintf(stderr, "gsasyscon_meters: no meters. Set TELEMETRY = true in the system_configuration file,\n");
+    fprintf(stderr, "  or run the Gstreamer pipeline with %s=1.\n", TELEMETRY_ENV_VARIABLE);
+    return 1;
+  }
+  for (;;) {
+    if (interval > 0.0) printf("\033[H\033[2J"); //clear the terminal
+    if (show_meters(segment, pid) == 0) printf("no plugins are metered%s\n", pid ? " in this process" : "");
+    if (interval <= 0.0) break;
+    fflush(stdout);
+    const struct timespec pause = { (time_t)interval, (long)((interval - (time_t)interval) * 1.e9) };
+    nanosleep(&pause, NULL);
+  }
+  return 0;
+}
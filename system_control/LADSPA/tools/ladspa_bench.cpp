@@ -0,0 +1,446 @@
+/* ladspa_bench
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Measures the CPU time of LADSPA plugins outside of a Gstreamer pipeline, so
+  that a change to a plugin can be compared with the previous version. Each
+  argument names a plugin library and the properties of the plugin, in the
+  form used by gst-launch, except that a property may have a list of values:
+    ladspa_bench './ACDf.so type=1,21,26 fp=1000 qp=0.7'
+  The first word of an argument is the path of the library, optionally
+  followed by :label to select one of its plugins, e.g.
+  ../ACDf_v4.1/ACDfBank.so:ACDfBank3. Without a label all plugins of the
+  library are measured. The other control ports keep their defaults.
+
+  Every combination of the property values, block sizes (-b) and instance
+  counts (-n) is measured. The instances are instantiated, activated and run
+  for BENCH_WARMUP_SECONDS of audio of white noise at -20dBFS. Then all
+  instances are run one after the other, as the elements of a pipeline are,
+  for at least -t seconds. The results are:
+    ns_per_sample           the time per sample frame of one instance
+    msamples_per_second     the sample frames of one instance per second, in millions
+    realtime_instances      the number of instances that one CPU core could run
+                            in real time at the rate -r
+  If the kernel allows perf events (see /proc/sys/kernel/perf_event_paranoid)
+  the CPU cycles, instructions and cache misses of the plugins are counted as
+  well and are given per sample frame. Otherwise perf_events is false.
+
+  The results are written as JSON to stdout, or to the file -o, one result per
+  line so that the files of two commits can be compared with diff. The output
+  of the plugins themselves, e.g. the information they print when they are
+  activated, is discarded. GSASYSCON_ISA (see ../common/cpu_dispatch.h) and
+  GSASYSCON_TELEMETRY (see ../common/telemetry.h) are passed on to the
+  plugins and are recorded in the results.
+
+  The plugin directories build and run it with:
+    make bench
+  which writes bench.json. It can be built alone from the tools directory with:
+    make ladspa_bench
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <ladspa.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include "ladspa_host.h"
+using namespace std;
+
+#define BENCH_BLOCKS          "64,128,256,512,1024,2048,4096,8192"  //default block sizes
+#define BENCH_INSTANCES       "1,4,16"  //default instance counts
+#define BENCH_SECONDS         0.2   //default time per measurement
+#define BENCH_WARMUP_SECONDS  0.5   //seconds of audio run before each measurement
+#define BENCH_MIN_CALLS       16    //smallest number of calls per instance that are measured
+#define BENCH_CLOCK_SAMPLES   8192  //the clock is read after about this many samples
+#define BENCH_NOISE_LEVEL     0.1f  //-20dBFS
+
+typedef struct {
+  string name; //the property, as named by Gstreamer
+  unsigned long port;
+  vector<LADSPA_Data> values;
+} bench_property;
+
+typedef struct {
+  int fd[3]; //cycles, instructions, cache misses, or -1 if not available
+  uint64_t count[3];
+} bench_counters;
+
+static const char *counter_names[3] = { "cycles_per_sample", "instructions_per_sample", "cache_misses_per_sample" };
+
+
+static bool parse_list(const string &text, vector<LADSPA_Data> *values) {
+  //a comma separated list of numbers, or true or false. Returns false if empty.
+  stringstream items(text);
+  string item;
+  values->clear();
+  while (getline(items, item, ',')) {
+    if (item.size() >= 2 && (item[0] == '"' || item[0] == '\'') && item[item.size() - 1] == item[0]) {
+      item = item.substr(1, item.size() - 2);
+    }
+    if (item == "true") values->push_back(1.0);
+    else if (item == "false") values->push_back(0.0);
+    else if (!item.empty()) values->push_back(atof(item.c_str()));
+  }
+  return !values->empty();
+}
+
+
+static string json_text(const string &text) {
+  //a JSON string
+  string result = "\"";
+  for (unsigned int i = 0; i < text.size(); i++) {
+    const char c = text[i];
+    if (c == '"' || c == '\\') result += '\\';
+    if ((unsigned char)c < 0x20) result += ' ';
+    else result += c;
+  }
+  return result + "\"";
+}
+
+
+static double clock_seconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1.e-9;
+}
+
+
+static float noise() {
+  //white noise at BENCH_NOISE_LEVEL
+  static unsigned int state = 12345;
+  state = state * 1664525u + 1013904223u;
+  return BENCH_NOISE_LEVEL * ((int)(state >> 8) * (1.0f / 8388608.0f) - 1.0f);
+}
+
+
+static void open_counters(bench_counters *c) {
+  //opens the hardware counters of this thread in user space. Counters that the
+  //  CPU or the kernel do not allow stay closed.
+  static const uint64_t config[3] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+  for (int k = 0; k < 3; k++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config[k];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    c->fd[k] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+}
+
+
+static bool start_counters(bench_counters *c) {
+  //returns true if any counter is open
+  bool open = false;
+  for (int k = 0; k < 3; k++) {
+    if (c->fd[k] < 0) continue;
+    ioctl(c->fd[k], PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fd[k], PERF_EVENT_IOC_ENABLE, 0);
+    open = true;
+  }
+  return open;
+}
+
+
+static void stop_counters(bench_counters *c, bool valid[3]) {
+  //reads the counters. A counter that shared the CPU with other events is
+  //  scaled to the whole measurement.
+  for (int k = 0; k < 3; k++) {
+    uint64_t data[3]; //value, time enabled, time running
+    valid[k] = false;
+    if (c->fd[k] < 0) continue;
+    ioctl(c->fd[k], PERF_EVENT_IOC_DISABLE, 0);
+    if (read(c->fd[k], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+    c->count[k] = (data[2] < data[1]) ? (uint64_t)((double)data[0] * data[1] / data[2]) : data[0];
+    valid[k] = true;
+  }
+}
+
+
+typedef struct {
+  LADSPA_Handle handle;
+  vector<LADSPA_Data> control;
+  vector<LADSPA_Data> audio; //one block per port
+} bench_instance;
+
+
+static bool measure(FILE *json, bool *first, const string &library, const LADSPA_Descriptor *d,
+                    const vector<bench_property> &properties, const vector<LADSPA_Data> &control,
+                    const unsigned long block, const unsigned long num_instances, const unsigned long rate,
+                    const double seconds, bench_counters *counters) {
+  //measures one combination and writes its result. Returns false if the plugin
+  //  could not be instantiated.
+  const unsigned long num_ports = d->PortCount;
+  vector<bench_instance> instances(num_instances);
+  unsigned long created = 0;
+  for (bench_instance &in : instances) {
+    in.control = control;
+    in.audio.resize(num_ports * block);
+    in.handle = d->instantiate(d, rate);
+    if (!in.handle) break;
+    created++;
+    for (unsigned long p = 0; p < num_ports; p++) {
+      if (LADSPA_IS_PORT_CONTROL(d->PortDescriptors[p])) {
+        d->connect_port(in.handle, p, &in.control[p]);
+        continue;
+      }
+      LADSPA_Data *buffer = &in.audio[p * block];
+      for (unsigned long i = 0; i < block; i++) buffer[i] = LADSPA_IS_PORT_INPUT(d->PortDescriptors[p]) ? noise() : 0.0f;
+      d->connect_port(in.handle, p, buffer);
+    }
+    if (d->activate) d->activate(in.handle);
+  }
+  const bool instantiated = (created == num_instances);
+
+  if (instantiated) {
+    const unsigned long warmup_calls = (unsigned long)(BENCH_WARMUP_SECONDS * rate) / block + 1;
+    for (unsigned long call = 0; call < warmup_calls; call++) {
+      for (bench_instance &in : instances) d->run(in.handle, block);
+    }
+    //the clock is read every calls_per_check calls, so that it does not add to small blocks
+    const unsigned long calls_per_check = BENCH_CLOCK_SAMPLES / (block * num_instances) + 1;
+    unsigned long calls = 0;
+    bool valid[3] = { false, false, false };
+    const bool counted = start_counters(counters);
+    const double start = clock_seconds();
+    double elapsed = 0.0;
+    do {
+      for (unsigned long check = 0; check < calls_per_check; check++) {
+        for (bench_instance &in : instances) d->run(in.handle, block);
+      }
+      calls += calls_per_check;
+      elapsed = clock_seconds() - start;
+    } while (elapsed < seconds || calls < BENCH_MIN_CALLS);
+    if (counted) stop_counters(counters, valid);
+
+    const double samples = (double)calls * block * num_instances;
+    const double ns_per_sample = elapsed * 1.e9 / samples;
+    fprintf(json, "%s\n    {\"library\": %s, \"label\": %s, \"properties\": {", *first ? "" : ",",
+            json_text(library).c_str(), json_text(d->Label).c_str());
+    for (unsigned int j = 0; j < properties.size(); j++) {
+      fprintf(json, "%s%s: %g", j ? ", " : "", json_text(properties[j].name).c_str(), control[properties[j].port]);
+    }
+    fprintf(json, "}, \"block\": %lu, \"instances\": %lu, \"calls\": %lu, \"seconds\": %.4f, \"ns_per_sample\": %.3f, "
+            "\"msamples_per_second\": %.3f, \"realtime_instances\": %.1f", block, num_instances, calls, elapsed,
+            ns_per_sample, 1.e3 / ns_per_sample, 1.e9 / (ns_per_sample * rate));
+    for (int k = 0; k < 3; k++) {
+      if (valid[k]) fprintf(json, ", \"%s\": %.3f", counter_names[k], counters->count[k] / samples);
+    }
+    if (valid[0] && valid[1] && counters->count[0] > 0) {
+      fprintf(json, ", \"ipc\": %.3f", (double)counters->count[1] / counters->count[0]);
+    }
+    fprintf(json, "}");
+    fflush(json);
+    *first = false;
+  }
+
+  for (unsigned long j = 0; j < created; j++) {
+    if (d->deactivate) d->deactivate(instances[j].handle);
+    d->cleanup(instances[j].handle);
+  }
+  return instantiated;
+} //end measure
+
+
+static int bench_argument(FILE *json, bool *first, const string &argument, const vector<unsigned long> &blocks,
+                          const vector<unsigned long> &instance_counts, const unsigned long rate, const double seconds,
+                          bench_counters *counters) {
+  //measures the plugins of one argument. Returns 0, or 1 after an error.
+  stringstream tokens(argument);
+  string path, label, token;
+  tokens >> path;
+  const size_t colon = path.rfind(':');
+  if (colon != string::npos && colon > path.rfind('/')) {
+    label = path.substr(colon + 1);
+    path.erase(colon);
+  }
+  void *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!library) {
+    cerr << "ladspa_bench: " << dlerror() << endl;
+    return 1;
+  }
+  LADSPA_Descriptor_Function descriptor_function = (LADSPA_Descriptor_Function)dlsym(library, "ladspa_descriptor");
+  const string library_name = path.substr(path.rfind('/') + 1);
+  const LADSPA_Descriptor *d;
+  int error = 0, found = 0;
+
+  for (unsigned long i = 0; descriptor_function && (d = descriptor_function(i)); i++) {
+    if (!label.empty() && label != d->Label) continue;
+    found++;
+    const unsigned long num_ports = d->PortCount;
+    vector<LADSPA_Data> control(num_ports);
+    vector<bench_property> properties;
+    for (unsigned long p = 0; p < num_ports; p++) control[p] = default_value(d->PortRangeHints[p], rate);
+    //the properties of the argument, with their lists of values
+    stringstream words(argument);
+    words >> token;
+    while (words >> token) {
+      const size_t equals = token.find('=');
+      bench_property property;
+      if (equals == string::npos) continue;
+      property.name = canonical_name(token.substr(0, equals));
+      for (property.port = 0; property.port < num_ports; property.port++) {
+        const LADSPA_PortDescriptor port = d->PortDescriptors[property.port];
+        if (LADSPA_IS_PORT_INPUT(port) && LADSPA_IS_PORT_CONTROL(port) &&
+            property_name(d->PortNames[property.port]) == property.name) break;
+      }
+      if (property.port == num_ports) {
+        cerr << "ladspa_bench: " << d->Label << " has no property " << property.name << ", it is ignored." << endl;
+        continue;
+      }
+      if (!parse_list(token.substr(equals + 1), &property.values)) {
+        cerr << "ladspa_bench: " << property.name << " has no value, it is ignored." << endl;
+        continue;
+      }
+      properties.push_back(property);
+    }
+
+    //every combination of the values. index counts through them like the digits of a number.
+    vector<unsigned int> index(properties.size(), 0);
+    for (;;) {
+      for (unsigned int j = 0; j < properties.size(); j++) control[properties[j].port] = properties[j].values[index[j]];
+      for (unsigned long block : blocks) {
+        for (unsigned long num_instances : instance_counts) {
+          if (!measure(json, first, library_name, d, properties, control, block, num_instances, rate, seconds, counters)) {
+            cerr << "ladspa_bench: " << d->Label << " could not be instantiated." << endl;
+            error = 1;
+          }
+        }
+      }
+      unsigned int j;
+      for (j = 0; j < properties.size(); j++) {
+        if (++index[j] < properties[j].values.size()) break;
+        index[j] = 0;
+      }
+      if (j == properties.size()) break;
+    }
+  }
+  if (found == 0) {
+    cerr << "ladspa_bench: " << path << " has no plugin" << (label.empty() ? "" : " " + label) << "." << endl;
+    error = 1;
+  }
+  //the library stays loaded, the plugins may have threads that end after cleanup
+  return error;
+} //end bench_argument
+
+
+static bool parse_sizes(const char *text, vector<unsigned long> *sizes) {
+  //a comma separated list of positive integers
+  vector<LADSPA_Data> values;
+  if (!parse_list(text, &values)) return false;
+  sizes->clear();
+  for (LADSPA_Data value : values) {
+    if (!(value >= 1.0f)) return false;
+    sizes->push_back((unsigned long)value);
+  }
+  return true;
+}
+
+
+static string cpu_model() {
+  //the model name of the CPU, or the architecture of the build
+  FILE *cpuinfo = fopen("/proc/cpuinfo", "r");
+  char line[256];
+  string model;
+  while (cpuinfo && fgets(line, sizeof(line), cpuinfo)) {
+    if (strncmp(line, "model name", 10) && strncmp(line, "Model", 5)) continue;
+    const char *colon = strchr(line, ':');
+    if (!colon) continue;
+    model = colon + 1;
+    model.erase(0, model.find_first_not_of(" \t"));
+    model.erase(model.find_last_not_of(" \t\n") + 1);
+    break;
+  }
+  if (cpuinfo) fclose(cpuinfo);
+  return model;
+}
+
+
+int main(int argc, char **argv) {
+  unsigned long rate = 48000;
+  double seconds = BENCH_SECONDS;
+  vector<unsigned long> blocks, instance_counts;
+  const char *output = NULL;
+  bool sizes_valid = parse_sizes(BENCH_BLOCKS, &blocks) && parse_sizes(BENCH_INSTANCES, &instance_counts);
+  int arg, error = 0;
+
+  for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (!strcmp(argv[arg], "-r") && arg + 1 < argc) rate = strtoul(argv[++arg], NULL, 10);
+    else if (!strcmp(argv[arg], "-t") && arg + 1 < argc) seconds = atof(argv[++arg]);
+    else if (!strcmp(argv[arg], "-b") && arg + 1 < argc) sizes_valid &= parse_sizes(argv[++arg], &blocks);
+    else if (!strcmp(argv[arg], "-n") && arg + 1 < argc) sizes_valid &= parse_sizes(argv[++arg], &instance_counts);
+    else if (!strcmp(argv[arg], "-o") && arg + 1 < argc) output = argv[++arg];
+    else break;
+  }
+  if (arg >= argc || rate == 0 || !(seconds > 0.0) || !sizes_valid) {
+    cerr << "usage: ladspa_bench [-r rate] [-t seconds] [-b blocks] [-n instances] [-o file]" << endl;
+    cerr << "                    'library.so[:label] property=value,value ...' ..." << endl;
+    cerr << "  measures the CPU time of the plugins for every combination of the property" << endl;
+    cerr << "  values, block sizes (default " << BENCH_BLOCKS << ") and numbers of" << endl;
+    cerr << "  instances (default " << BENCH_INSTANCES << "), each for at least seconds (default "
+         << BENCH_SECONDS << ")," << endl;
+    cerr << "  at the rate in Hz (default 48000). The results are written as JSON to stdout or file." << endl;
+    return 2;
+  }
+
+  //the results go to the file or the original stdout. What the plugins print
+  //  to stdout is discarded.
+  fflush(stdout);
+  const int json_fd = output ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : dup(STDOUT_FILENO);
+  FILE *json = (json_fd >= 0) ? fdopen(json_fd, "w") : NULL;
+  if (!json) {
+    cerr << "ladspa_bench: " << (output ? output : "stdout") << " could not be opened." << endl;
+    return 1;
+  }
+  const int null_output = open("/dev/null", O_WRONLY);
+  if (null_output >= 0) {
+    dup2(null_output, STDOUT_FILENO);
+    close(null_output);
+  }
+
+  bench_counters counters;
+  open_counters(&counters);
+  const bool perf_events = (counters.fd[0] >= 0 || counters.fd[1] >= 0 || counters.fd[2] >= 0);
+  const char *isa = getenv("GSASYSCON_ISA");
+  const char *telemetry = getenv("GSASYSCON_TELEMETRY");
+  fprintf(json, "{\n  \"rate\": %lu, \"seconds\": %g, \"cpu\": %s, \"isa\": %s, \"telemetry\": %s, \"perf_events\": %s,\n",
+          rate, seconds, json_text(cpu_model()).c_str(), isa ? json_text(isa).c_str() : "null",
+          telemetry ? json_text(telemetry).c_str() : "null", perf_events ? "true" : "false");
+  fprintf(json, "  \"results\": [");
+  bool first = true;
+  for (; arg < argc; arg++) {
+    error |= bench_argument(json, &first, argv[arg], blocks, instance_counts, rate, seconds, &counters);
+  }
+  fprintf(json, "\n  ]\n}\n");
+  fclose(json);
+  for (int k = 0; k < 3; k++) {
+    if (counters.fd[k] >= 0) close(counters.fd[k]);
+  }
+  return error;
+}
@@ -0,0 +1,96 @@
+/* ladspa_host.h
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Helpers shared by the tools that load the GSASysCon LADSPA plugins the way
+  the Gstreamer LADSPA elements do (ladspa_latency and ladspa_bench): the
+  element and property names that Gstreamer derives from the labels and port
+  names of a plugin, and the default values of the control ports. Keep them
+  in this one place so that the tools accept the same names as gst-launch-1.0.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LADSPA_HOST_H
+#define LADSPA_HOST_H
+
+#include <math.h>
+#include <ladspa.h>
+#include <string>
+using namespace std;
+
+
+static string canonical_name(const string &name) {
+  //the names of Gstreamer elements and properties contain only letters, digits and '-'.
+  //  Other characters are replaced by '-'. The case is ignored when names are compared.
+  string result = name;
+  for (unsigned int i = 0; i < result.size(); i++) {
+    const char c = result[i];
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-') continue;
+    if (c >= 'A' && c <= 'Z') result[i] = c - 'A' + 'a';
+    else result[i] = '-';
+  }
+  return result;
+}
+
+
+static string property_name(const char *port_name) {
+  //the property of a port is named after the port, without a trailing " (...)"
+  string name = port_name;
+  const size_t paren = name.rfind(" (");
+  if (paren != string::npos) name.erase(paren);
+  name = canonical_name(name);
+  if (name.empty() || !(name[0] >= 'a' && name[0] <= 'z')) name = "param-" + name;
+  return name;
+}
+
+
+static LADSPA_Data default_value(const LADSPA_PortRangeHint &hint, const unsigned long rate) {
+  //the default value of a control port, from its range hints as in the LADSPA SDK
+  const LADSPA_PortRangeHintDescriptor h = hint.HintDescriptor;
+  double low = hint.LowerBound, high = hint.UpperBound, value;
+  if (LADSPA_IS_HINT_SAMPLE_RATE(h)) {
+    low *= rate;
+    high *= rate;
+  }
+  switch (h & LADSPA_HINT_DEFAULT_MASK) {
+  case LADSPA_HINT_DEFAULT_MINIMUM:
+    return low;
+  case LADSPA_HINT_DEFAULT_LOW:
+    if (LADSPA_IS_HINT_LOGARITHMIC(h)) return exp(log(low) * 0.75 + log(high) * 0.25);
+    return low * 0.75 + high * 0.25;
+  case LADSPA_HINT_DEFAULT_MIDDLE:
+    if (LADSPA_IS_HINT_LOGARITHMIC(h)) return exp(log(low) * 0.5 + log(high) * 0.5);
+    return low * 0.5 + high * 0.5;
+  case LADSPA_HINT_DEFAULT_HIGH:
+    if (LADSPA_IS_HINT_LOGARITHMIC(h)) return exp(log(low) * 0.25 + log(high) * 0.75);
+    return low * 0.25 + high * 0.75;
+  case LADSPA_HINT_DEFAULT_MAXIMUM:
+    return high;
+  case LADSPA_HINT_DEFAULT_0:
+    return 0.0;
+  case LADSPA_HINT_DEFAULT_1:
+    return 1.0;
+  case LADSPA_HINT_DEFAULT_100:
+    return 100.0;
+  case LADSPA_HINT_DEFAULT_440:
+    return 440.0;
+  }
+  //no default. Use the lower bound, or zero if it is in the range.
+  value = 0.0;
+  if (LADSPA_IS_HINT_BOUNDED_BELOW(h) && value < low) value = low;
+  if (LADSPA_IS_HINT_BOUNDED_ABOVE(h) && value > high) value = high;
+  return value;
+}
+
+#endif
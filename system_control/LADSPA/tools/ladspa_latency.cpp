@@ -0,0 +1,198 @@
+/* ladspa_latency
+   Copyright 2025 Charlie Laub, GPLv3
+
+  Reports the latency of LADSPA plugins as they are used in a Gstreamer
+  pipeline. Each argument is one ladspa element with its properties, in the
+  form used by gst-launch, e.g.
+    ladspa_latency -r 48000 'ladspa-riir-ap2-so-riir-ap2 fp=100 qp=0.7 snr=100'
+  The plugin of the element is found in the directories of LADSPA_PATH. It is
+  loaded, its control ports are set to the properties (or their defaults),
+  and it is activated and run once on a buffer of silence. The value of its
+  output control port "latency" is the latency of the element in samples.
+  Plugins without a latency port have no latency. The sum over all elements
+  is printed, or with -l the latency of each element followed by the sum.
+
+  GSASysCon uses it to delay the routes of a client that have less latency
+  than the others, see align_route_latency in GSASysCon.sh.
+
+  Build and install it from the tools directory with:
+    make
+    sudo make install
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <dlfcn.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ladspa.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include "ladspa_host.h"
+using namespace std;
+
+#define LATENCY_DEFAULT_PATH  "/usr/local/lib/ladspa:/usr/lib/ladspa"  //as set by Install.sh
+#define LATENCY_RUN_SAMPLES   1024  //samples of silence passed to run, as in GSASysCon
+
+
+static const LADSPA_Descriptor *find_plugin(const string &element) {
+  //searches the directories of LADSPA_PATH for the plugin of a Gstreamer element.
+  //  Gstreamer names the element ladspa-<library file>-<label>, e.g. the label
+  //  RIIR_AP2 of RIIR_AP2.so is the element ladspa-riir-ap2-so-riir-ap2
+  const char *env = getenv("LADSPA_PATH");
+  stringstream path((env && *env) ? env : LATENCY_DEFAULT_PATH);
+  string dir_name;
+  while (getline(path, dir_name, ':')) {
+    DIR *dir = opendir(dir_name.c_str());
+    if (!dir) continue;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+      const string file = entry->d_name;
+      if (file.size() < 4 || file.compare(file.size() - 3, 3, ".so")) continue;
+      const string prefix = "ladspa-" + canonical_name(file) + "-";
+      if (element.compare(0, prefix.size(), prefix)) continue;
+      void *library = dlopen((dir_name + "/" + file).c_str(), RTLD_NOW | RTLD_LOCAL);
+      if (!library) continue;
+      LADSPA_Descriptor_Function descriptor_function = (LADSPA_Descriptor_Function)dlsym(library, "ladspa_descriptor");
+      const LADSPA_Descriptor *descriptor;
+      for (unsigned long i = 0; descriptor_function && (descriptor = descriptor_function(i)); i++) {
+        if (prefix + canonical_name(descriptor->Label) == element) {
+          closedir(dir);
+          return descriptor;
+        }
+      }
+      dlclose(library);
+    }
+    closedir(dir);
+  }
+  return NULL;
+}
+
+
+static int element_latency(const string &element, const unsigned long rate, unsigned long *latency) {
+  //finds the latency of one element with its properties. Returns 0, or 1 if
+  //  the plugin was not found or could not be instantiated
+  stringstream tokens(element);
+  string name, token;
+  tokens >> name;
+  const LADSPA_Descriptor *d = find_plugin(canonical_name(name));
+  if (!d) {
+    cerr << "ladspa_latency: the plugin of " << name << " was not found in LADSPA_PATH." << endl;
+    return 1;
+  }
+  const unsigned long num_ports = d->PortCount;
+  vector<LADSPA_Data> control(num_ports);
+  vector<LADSPA_Data> audio(LATENCY_RUN_SAMPLES * num_ports, 0.0);
+  long latency_port = -1;
+  for (unsigned long p = 0; p < num_ports; p++) {
+    control[p] = default_value(d->PortRangeHints[p], rate);
+    if (LADSPA_IS_PORT_OUTPUT(d->PortDescriptors[p]) && LADSPA_IS_PORT_CONTROL(d->PortDescriptors[p]) &&
+        !strcmp(d->PortNames[p], "latency")) latency_port = p;
+  }
+  //set the control ports to the properties of the element
+  while (tokens >> token) {
+    const size_t equals = token.find('=');
+    if (equals == string::npos) continue;
+    const string property = canonical_name(token.substr(0, equals));
+    string value = token.substr(equals + 1);
+    if (value.size() >= 2 && (value[0] == '"' || value[0] == '\'') && value[value.size() - 1] == value[0]) {
+      value = value.substr(1, value.size() - 2);
+    }
+    unsigned long p;
+    for (p = 0; p < num_ports; p++) {
+      if (LADSPA_IS_PORT_INPUT(d->PortDescriptors[p]) && LADSPA_IS_PORT_CONTROL(d->PortDescriptors[p]) &&
+          property_name(d->PortNames[p]) == property) break;
+    }
+    if (p == num_ports) {
+      cerr << "ladspa_latency: " << name << " has no property " << property << ", it is ignored." << endl;
+      continue;
+    }
+    if (value == "true") control[p] = 1.0;
+    else if (value == "false") control[p] = 0.0;
+    else control[p] = atof(value.c_str());
+  }
+  *latency = 0;
+  if (latency_port < 0) return 0;
+
+  //the plugins print information when they are activated. Only the result of
+  //  this program is written to stdout.
+  cout.flush();
+  fflush(stdout);
+  const int saved_stdout = dup(STDOUT_FILENO);
+  const int null_output = open("/dev/null", O_WRONLY);
+  if (null_output >= 0) {
+    dup2(null_output, STDOUT_FILENO);
+    close(null_output);
+  }
+  LADSPA_Handle instance = d->instantiate(d, rate);
+  if (instance) {
+    for (unsigned long p = 0; p < num_ports; p++) {
+      if (LADSPA_IS_PORT_CONTROL(d->PortDescriptors[p])) d->connect_port(instance, p, &control[p]);
+      else d->connect_port(instance, p, &audio[p * LATENCY_RUN_SAMPLES]);
+    }
+    if (d->activate) d->activate(instance);
+    //some plugins report the latency only when they run
+    d->run(instance, LATENCY_RUN_SAMPLES);
+    if (d->deactivate) d->deactivate(instance);
+    d->cleanup(instance);
+  }
+  cout.flush();
+  fflush(stdout);
+  if (saved_stdout >= 0) {
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+  }
+  if (!instance) {
+    cerr << "ladspa_latency: " << name << " could not be instantiated." << endl;
+    return 1;
+  }
+  *latency = (unsigned long)(control[latency_port] + 0.5);
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+  unsigned long rate = 48000, latency, total = 0;
+  bool list = false;
+  int arg, error = 0;
+
+  for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (!strcmp(argv[arg], "-l")) list = true;
+    else if (!strcmp(argv[arg], "-r") && arg + 1 < argc) rate = strtoul(argv[++arg], NULL, 10);
+    else break;
+  }
+  if (arg >= argc || rate == 0) {
+    cerr << "usage: ladspa_latency [-l] [-r rate] 'element property=value ...' ..." << endl;
+    cerr << "  prints the total latency in samples of the ladspa elements, at the rate" << endl;
+    cerr << "  in Hz (default 48000). -l also prints the latency of each element." << endl;
+    return 2;
+  }
+  for (; arg < argc; arg++) {
+    if (element_latency(argv[arg], rate, &latency)) {
+      error = 1;
+      continue;
+    }
+    if (list) cout << latency << "\t" << argv[arg] << endl;
+    total += latency;
+  }
+  cout << total << endl;
+  return error;
+}
@@ -810,6 +810,40 @@ function get_system_or_stream_parameter {
     INPUT_CHANNELS)
       INPUT_CHANNELS=$field_contents
       ;;
+    ACDF_CASCADE)
+      #when true, runs of consecutive ACDf filters within a ROUTE are combined into
+      #  a single ACDfCascade element. When block or parallel, the cascades also use
+      #  the block kernel or the parallel form. The only acceptable values are true, 
+      #  block, parallel and false
+      if [[ "$field_contents" == "true" ]]; then
+        ACDF_CASCADE="true"
+      elif [[ "$field_contents" == "block" ]]; then
+        ACDF_CASCADE="true"
+        ACDF_CASCADE_MODE=1
+      elif [[ "$field_contents" == "parallel" ]]; then
+        ACDF_CASCADE="true"
+        ACDF_CASCADE_MODE=2
+      fi
+      ;;
+    ALIGN_ROUTES)
+      #when true (the default), the routes of each client that end at a sink are delayed
+      #  so that all of them have the same latency as the route with the largest latency,
+      #  e.g. a route with RIIR plugins. See align_route_latency. The only acceptable 
+      #  values are true and false
+      if [[ "$field_contents" == "false" ]]; then
+        ALIGN_ROUTES="false"
+      fi
+      ;;
+    TELEMETRY)
+      #when true, the LADSPA plugins of the clients publish the levels of their outputs
+      #  in shared memory. They are shown by show_client_status_info, or on the client
+      #  with gsasyscon_meters (see LADSPA/tools). With timing they also time each call
+      #  of their run function. The only acceptable values are true, timing and false
+      #  (the default)
+      if [[ "$field_contents" == "true" ]] || [[ "$field_contents" == "timing" ]]; then
+        TELEMETRY="$field_contents"
+      fi
+      ;;
   esac
 }
 
@@ -1019,14 +1053,22 @@ function consolidate_existing_client_code {
   #    This function is called at EOF and at the declaration of each new client
   #    Any outstanding (non-empty) ROUTE_CODE must be copied into the CLIENT_CODE string, and placeholders replaced
   #    Variables are reset to empty string upon completion
+  local route
 
    if [[ "$ROUTE_CODE" != "" ]]; then
-      #append the remaining ROUTE_CODE into CLIENT_CODE
-      CLIENT_CODE+="    $ROUTE_CODE"
-      #reset ROUTE_CODE to empty string
-      ROUTE_CODE=""
-      READ_ROUTE_INFO="false"
+      #complete the remaining ROUTE_CODE
+      complete_route
    fi
+   #delay the routes with less latency than the others, if enabled
+   align_route_latency
+   #append the code of the routes into CLIENT_CODE
+   for route in "${!CLIENT_ROUTE_CODE[@]}"; do
+      CLIENT_CODE+="    ${CLIENT_ROUTE_CODE[route]}"
+   done
+   unset CLIENT_ROUTE_CODE
+   unset CLIENT_ROUTE_SOURCE
+   unset CLIENT_ROUTE_TARGET
+   unset CLIENT_ROUTE_END_LENGTH
    if [[ "$CLIENT_CODE" == "" ]]; then
       #if CLIENT_CODE is empty, no ROUTEs were declared and client is invalid. Return an error
       message="No ROUTEs were declared for client ${IP[$CLIENT_INDEX]}. Aborting system launch."
@@ -1042,9 +1084,244 @@ function consolidate_existing_client_code {
 } #end function consolidate_existing_client_code
 
 
+function merge_acdf_cascades {
+  #combines each run of consecutive ACDf filters within ROUTE_CODE into one ACDfCascade
+  #  element that holds up to max_sections filters. This is only done when the system 
+  #  parameter ACDF_CASCADE = true (or block or parallel) has been specified.
+  #  Only ACDf elements with the properties type, polarity, db, fp, qp, fz, qz are combined.
+  #  The section number is appended to each property, e.g. fp=1000 becomes fp2=1000
+  if [[ $ACDF_CASCADE != "true" ]]; then return; fi
+  local acdf_element='ladspa-acdf-so-acdf'
+  local cascade_element='ladspa-acdfcascade-so-acdfcascade'
+  local max_sections=8
+  local remaining="$ROUTE_CODE"
+  local new_route_code=""
+  local separator=""
+  local element
+  local single_element
+  local cascade_properties=""
+  local section_count=0
+  local mergeable
+  local property
+  local -a properties
+
+  #nothing to do if the route does not contain ACDf filters
+  if [[ "$ROUTE_CODE" != *"$acdf_element "* ]]; then return; fi
+
+  #split the route code into elements at each ' ! ' and examine each element in turn 
+  while [[ -n "$remaining" ]] || [[ $section_count -gt 0 ]]; do
+    if [[ -z "$remaining" ]]; then
+      element=""
+    elif [[ "$remaining" == *' ! '* ]]; then
+      element=${remaining%%' ! '*}
+      remaining=${remaining#*' ! '}
+    else
+      element=$remaining
+      remaining=""
+    fi
+    #check if the element is an ACDf filter that can be combined with its neighbors
+    mergeable=false
+    if [[ "$element" == "$acdf_element "* ]]; then
+      mergeable=true
+      IFS=' ' read -ra properties <<< "${element#$acdf_element}"
+      for property in "${properties[@]}"; do
+        if ! [[ "$property" =~ ^(type|polarity|db|fp|qp|fz|qz)= ]]; then mergeable=false; fi
+      done
+    fi
+    #add the element to the current cascade
+    if [[ $mergeable == "true" ]] && [[ $section_count -lt $max_sections ]]; then
+      ((section_count++))
+      if [[ $section_count -eq 1 ]]; then single_element=$element; fi
+      for property in "${properties[@]}"; do
+        cascade_properties+=" ${property%%=*}$section_count=${property#*=}"
+      done
+      if [[ -n "$remaining" ]]; then continue; fi
+      element=""
+    fi
+    #the current cascade, if any, is complete. Add it to the new route code.
+    if [[ $section_count -gt 1 ]]; then
+      new_route_code+="$separator$cascade_element$cascade_properties"
+      if [[ $ACDF_CASCADE_MODE -ne 0 ]]; then new_route_code+=" mode=$ACDF_CASCADE_MODE"; fi
+      separator=' ! '
+    elif [[ $section_count -eq 1 ]]; then
+      #a single ACDf filter is left unchanged
+      new_route_code+="$separator$single_element"
+      separator=' ! '
+    fi
+    cascade_properties=""
+    section_count=0
+    if [[ $mergeable == "true" ]]; then
+      #the cascade was full. Begin a new one with the current element.
+      remaining="$element${remaining:+ ! $remaining}"
+      continue
+    fi
+    if [[ -n "$element" ]]; then
+      new_route_code+="$separator$element"
+      separator=' ! '
+    fi
+  done
+  ROUTE_CODE=$new_route_code
+} #end function merge_acdf_cascades
+
+
+function connect_acdf_filter_bank {
+  #an ACDfBank element has one input and one output per band. Gstreamer delivers the bands
+  #  as an interleaved multichannel stream. When the last element of a route that ends at a 
+  #  tee is an ACDfBank element, the tee is replaced by a deinterleave element with the same
+  #  name, so that other routes can start from the individual bands. A route starts from band
+  #  N of the filter bank when its ROUTE_START is the tee name followed by .N, e.g. xover.2
+  #  This replaces a tee per band split followed by separate filters for each band.
+  #  The ACDfBank element may be followed by a Delay element with the same number of
+  #  channels, which delays all bands in one element for the time alignment of the drivers.
+  local bank_element='ladspa-acdfbank-so-acdfbank'
+  local delay_element='ladspa-delay-so-delay'
+  local elements last_element
+  if [[ "$ROUTE_END_CODE" != 'tee name='* ]]; then return; fi
+  if [[ "$ROUTE_CODE" != *" ! $ROUTE_END_CODE" ]]; then return; fi
+  elements=${ROUTE_CODE%" ! $ROUTE_END_CODE"}
+  last_element=${elements##*' ! '}
+  if [[ "$last_element" == "$delay_element"* ]]; then
+    elements=${elements%' ! '*}
+    last_element=${elements##*' ! '}
+  fi
+  if [[ "$last_element" != "$bank_element"* ]]; then return; fi
+  ROUTE_CODE="${ROUTE_CODE%"$ROUTE_END_CODE"}deinterleave name=${ROUTE_END_CODE#tee name=}"
+} #end function connect_acdf_filter_bank
+
+
+function complete_route {
+  #completes the code of the current ROUTE and stores it, together with the tee or filter
+  #  bank that the route starts from (ROUTE_SOURCE) and the tee or filter bank that it ends
+  #  at (ROUTE_TARGET, empty for a sink), until all routes of the client have been read
+  #combine consecutive ACDf filters into cascade elements, if enabled
+  merge_acdf_cascades
+  #split the output of a filter bank element into its bands
+  connect_acdf_filter_bank
+  CLIENT_ROUTE_CODE+=("$ROUTE_CODE")
+  CLIENT_ROUTE_SOURCE+=("$ROUTE_SOURCE")
+  CLIENT_ROUTE_TARGET+=("$ROUTE_TARGET")
+  CLIENT_ROUTE_END_LENGTH+=(${#ROUTE_END_CODE})
+  #reset ROUTE_CODE to empty string
+  ROUTE_CODE=""
+  READ_ROUTE_INFO="false"
+} #end function complete_route
+
+
+function align_route_latency {
+  #some LADSPA plugins delay their output, e.g. RIIR_AP1 and RIIR_AP2 by up to several 
+  #  seconds. The delay, in samples, is reported by their output port "latency" and is 
+  #  read with the ladspa_latency tool (see LADSPA/tools). The latency of a route is the 
+  #  sum over its ladspa elements, plus the latency of the route that ends at the tee
+  #  or filter bank that it starts from. Each route of the client that ends at a sink
+  #  and has less latency than the others is delayed by the difference, so that all
+  #  channels of the client stay time aligned. DELAY statements are not counted.
+  #  This is done unless the system parameter ALIGN_ROUTES = false has been specified.
+  #  The plugins of a streaming client run on the client, so ladspa_latency is run there,
+  #  through the ACCESS string of the client. If the latency of a route cannot be found
+  #  none of the routes of the client are aligned, and a warning is written to the log.
+  if [[ $ALIGN_ROUTES != "true" ]]; then return; fi
+  local latency_tool='ladspa_latency'
+  local latency_shell='/bin/bash'
+  local latency_host='the server'
+  local latency_command
+  local -a route_latency
+  local -a total_latency
+  local -a elements
+  local route
+  local source_route
+  local pass
+  local element
+  local remaining
+  local rate
+  local client_name=${IP[$CLIENT_INDEX]}
+  local max_latency=0
+  local delay
+  local p
+
+  #nothing to do if no route contains ladspa elements
+  if [[ "${CLIENT_ROUTE_CODE[*]}" != *'ladspa-'* ]]; then return; fi
+  if [[ $client_name == '-1' ]]; then client_name='LOCAL_PLAYBACK'; fi
+  if [[ ${IP[$CLIENT_INDEX]} != '-1' ]] && [[ "${ACCESS[$CLIENT_INDEX]}" != "" ]]; then
+    #the commands are passed on stdin, as for LOCALCMD_RUNREMOTE_BEFORELAUNCH
+    latency_shell="${ACCESS[$CLIENT_INDEX]} /bin/bash"
+    latency_host="client $client_name"
+  fi
+  if ! echo "command -v $latency_tool" | eval $latency_shell > /dev/null 2>&1; then
+    message="WARNING: $latency_tool was not found on $latency_host. The routes of client $client_name "
+    message+="are NOT time aligned. Install $latency_tool on $latency_host from LADSPA/tools."
+    commit_to_log "$message"
+    return
+  fi
+  #the routes of a streaming client are processed at the stream rate
+  rate=${STREAM_RATE[$CLIENT_INDEX]}
+  if [[ ${IP[$CLIENT_INDEX]} == '-1' ]]; then rate=$INPUT_RATE; fi
+
+  #find the latency of the ladspa elements of each route
+  for route in "${!CLIENT_ROUTE_CODE[@]}"; do
+    elements=()
+    remaining=${CLIENT_ROUTE_CODE[route]}
+    while [[ -n "$remaining" ]]; do
+      element=${remaining%%' ! '*}
+      if [[ "$remaining" == *' ! '* ]]; then remaining=${remaining#*' ! '}; else remaining=""; fi
+      element="${element#"${element%%[![:space:]]*}"}" #remove leading whitespace
+      if [[ "$element" == 'ladspa-'* ]]; then elements+=("$element"); fi
+    done
+    route_latency[route]=0
+    if [[ ${#elements[@]} -gt 0 ]]; then
+      #quote the elements, they are parsed again by the shell that runs the tool
+      latency_command=$(printf '%q ' $latency_tool -r "$rate" "${elements[@]}")
+      route_latency[route]=$(echo "$latency_command" | eval $latency_shell 2> /dev/null)
+      if [[ $? -ne 0 ]] || ! [[ ${route_latency[route]} =~ ^[0-9]+$ ]]; then
+        message="WARNING: the latency of one or more of the elements \"${elements[*]}\" could not be found "
+        message+="on $latency_host. The routes of client $client_name are NOT time aligned."
+        commit_to_log "$message"
+        return
+      fi
+    fi
+    total_latency[route]=${route_latency[route]}
+  done
+  #add the latency of the routes that lead to the start of each route. A chain of N 
+  #  routes is complete after N passes.
+  for ((pass = 0; pass < ${#CLIENT_ROUTE_CODE[@]}; pass++)); do
+    for route in "${!CLIENT_ROUTE_CODE[@]}"; do
+      if [[ "${CLIENT_ROUTE_SOURCE[route]}" == "" ]]; then continue; fi
+      for source_route in "${!CLIENT_ROUTE_CODE[@]}"; do
+        if [[ "${CLIENT_ROUTE_TARGET[source_route]}" == "${CLIENT_ROUTE_SOURCE[route]}" ]]; then
+          total_latency[route]=$(( route_latency[route] + total_latency[source_route] ))
+        fi
+      done
+    done
+  done
+  #find the largest latency of the routes that end at a sink
+  for route in "${!CLIENT_ROUTE_CODE[@]}"; do
+    if [[ "${CLIENT_ROUTE_TARGET[route]}" != "" ]]; then continue; fi
+    if [[ ${total_latency[route]} -gt $max_latency ]]; then max_latency=${total_latency[route]}; fi
+  done
+  if [[ $max_latency -eq 0 ]]; then return; fi
+  #delay the other routes that end at a sink with an audioecho element, as for the DELAY 
+  #  statement. The delay in nanoseconds is rounded up, so that it is exactly the 
+  #  difference in samples. It must not exceed max-delay, which is one second by default.
+  for route in "${!CLIENT_ROUTE_CODE[@]}"; do
+    if [[ "${CLIENT_ROUTE_TARGET[route]}" != "" ]]; then continue; fi
+    delay=$(( max_latency - total_latency[route] ))
+    if [[ $delay -le 0 ]]; then continue; fi
+    message="Route $(( route + 1 )) of client $client_name has a latency of ${total_latency[route]} samples. "
+    message+="It is delayed by $delay samples to match the latency of $max_latency samples of the other routes."
+    commit_to_log "$message"
+    delay=$(( (delay * 1000000000 + rate - 1) / rate ))
+    element="audioecho surround-delay=true surround-mask=268435455 max-delay=$delay delay=$delay"
+    #insert the delay just before the ROUTE_END_CODE, as for user-supplied elements
+    p=$(( ${#CLIENT_ROUTE_CODE[route]} - ${CLIENT_ROUTE_END_LENGTH[route]} ))
+    CLIENT_ROUTE_CODE[route]="${CLIENT_ROUTE_CODE[route]:0:p}$element ! ${CLIENT_ROUTE_CODE[route]:p}"
+  done
+} #end function align_route_latency
+
+
 function process_input_mixing_expression {   
    local expression=$1
    local subexpression
+   local mixer_name=""
+   local pad_properties=""
 
    #if the first character of the output_ch_expression is not a + or - prepend a +
    if [[ ${expression:0:1} != '+' ]] && [[ ${expression:0:1} != '-' ]]; then
@@ -1060,9 +1337,10 @@ function process_input_mixing_expression {
    if [ "$subexpression_count" -gt 1 ]; then
       #the channel_expression consists of one or more subexpressions
       #create a MIXER to process the mix expression and prepend this to the ROUTE_END_CODE specified by the user
-      ROUTE_CODE='   audiomixer name=mixer'"$MIXER_INDEX latency=${INTERLEAVE_BUFFER[$CLIENT_INDEX]} ! "$ROUTE_END_CODE
+      mixer_name='mixer'"$MIXER_INDEX"
+      ROUTE_CODE='   audiomixer name='"$mixer_name latency=${INTERLEAVE_BUFFER[$CLIENT_INDEX]} ! "$ROUTE_END_CODE
       #set the target for this route to the mixer that was just created
-      target='mixer'"$MIXER_INDEX"'.'
+      target="$mixer_name."
       ((MIXER_INDEX++))
    else
       #expression is a single channel - no mixer is needed. The target is just the ROUTE_END_CODE specified by the user
@@ -1102,11 +1380,15 @@ function process_input_mixing_expression {
    done
 
    #create gstreamer code from each subexpression, using placeholders for source channels.
+   #When a mixer is used, each subexpression is linked to its own mixer input pad (sink_0, sink_1, ...)
+   #  and a positive scalar of at most 1.0 is applied using the volume of that pad. The mixer 
+   #  scales each input while summing it into its output buffer, so no audioamplify element is needed.
    for (( counter=0 ; counter < subexpression_count ; counter++ ))
    do
       #parse the subexpression into scalar and channel_id components and then gstreamer elements
       #prepend code to existing ROUTE_CODE so that ROUTE_END_CODE remains at end of ROUTE_CODE string
       expression=${subexpression[counter]}
+      if [[ -n "$mixer_name" ]]; then target="$mixer_name.sink_$counter"; fi
       if [[ $expression != *'*'* ]]; then
          channel_id="${expression:1}"
          if [[ "${expression:0:1}" = "+" ]]; then
@@ -1127,10 +1409,21 @@ function process_input_mixing_expression {
          if [[ "${scalar:0:1}" == "+" ]]; then
             scalar="${scalar:1}"
          fi
-         ROUTE_CODE=" SOURCE_FOR_CH$channel_id ! audioamplify amplification=$scalar ! $target$ROUTE_CODE"
+         if [[ -n "$mixer_name" ]] && [[ "$scalar" =~ ^[0-9]*\.?[0-9]+$ ]] && \
+               [[ $(do_awk_math "\"%d\", ($scalar <= 1.0)") -eq 1 ]]; then
+            #apply the scalar using the volume of the mixer pad
+            pad_properties+=" sink_$counter::volume=$scalar"
+            ROUTE_CODE=" SOURCE_FOR_CH$channel_id ! $target$ROUTE_CODE"
+         else
+            ROUTE_CODE=" SOURCE_FOR_CH$channel_id ! audioamplify amplification=$scalar ! $target$ROUTE_CODE"
+         fi
          if [[ ${ROUTE_START:0:1} == [0-9] ]]; then ((SOURCE_USAGE[$channel_id]++)); fi
       fi
    done
+   #add the pad volumes to the mixer element
+   if [[ -n "$pad_properties" ]]; then
+      ROUTE_CODE=${ROUTE_CODE/"audiomixer name=$mixer_name "/"audiomixer name=$mixer_name$pad_properties "}
+   fi
 } #end function process_input_mixing_expression
 
 
@@ -1505,6 +1798,10 @@ function process_system_configuration {
       ROUTE_CODE=""
       CLIENT_CODE=""
       CLIENT_SINK_CODE=""
+      unset CLIENT_ROUTE_CODE #clear the routes of the previous client
+      unset CLIENT_ROUTE_SOURCE
+      unset CLIENT_ROUTE_TARGET
+      unset CLIENT_ROUTE_END_LENGTH
       SINK_INDEX=-1 #reset the sink index to -1 to indicate no existing sinks
       unset SINK_CONNECTIONS #clear the SINK_CONNECTIONS counter
       unset SOURCE_USAGE #clear any existing info regarding the previous client's SOURCE_USAGE
@@ -1524,11 +1821,7 @@ function process_system_configuration {
       #check if the current route should be terminated
       if [[ $field_identifier == "ROUTE" ]] || [[ $field_identifier == "CLIENT" ]] || [[ $field_identifier == "CLIENT_SINK" ]]; then
         #a new ROUTE has been decleared, or a client parameter was found
-        #append the remaining ROUTE_CODE into CLIENT_CODE
-        CLIENT_CODE+="    $ROUTE_CODE" # <<=== NEEDS TO BE REPEATED FOR ROUTE DUPLICATIONS
-        #reset ROUTE_CODE to empty string
-        ROUTE_CODE=""
-        READ_ROUTE_INFO="false"
+        complete_route
       fi
     fi
     if [[ $field_identifier == "ROUTE" ]] && [[ $field_contents != "END" ]]; then
@@ -1557,17 +1850,25 @@ function process_system_configuration {
         ROUTE_END_CODE+=' ! output'$SINK_INDEX'.sink_'${SINK_CONNECTIONS[ROUTE_END]}
         #increment the sink connections counter for the sink specified by ROUTE_END
         (( SINK_CONNECTIONS[ROUTE_END]++ ))
+        ROUTE_TARGET=""
       else
         #the route ends at a tee. Declare the tee as part of the route end code
         ROUTE_END_CODE='tee name='"$ROUTE_END"
+        ROUTE_TARGET=$ROUTE_END
       fi
       #check if route_start refers to an input channel or tee
       if [[ ${ROUTE_START:0:1} == [0-9] ]] || [[ ${ROUTE_START:0:1} == '+' ]] || [[ ${ROUTE_START:0:1} == '-' ]]; then
           #the route starts at an input channel or mixing expression. 
           process_input_mixing_expression "$ROUTE_START"
+          ROUTE_SOURCE=""
+      elif [[ "$ROUTE_START" =~ ^(.+)\.([1-9])$ ]]; then
+          #the route starts at band N of a filter bank. See connect_acdf_filter_bank.
+          ROUTE_CODE=" ${BASH_REMATCH[1]}.src_$(( ${BASH_REMATCH[2]} - 1 )) ! queue ! $ROUTE_END_CODE"
+          ROUTE_SOURCE=${BASH_REMATCH[1]}
       else
           #the route starts at a user tee. The name of the tee is contained in ROUTE_START. 
           ROUTE_CODE=" $ROUTE_START"'. ! queue ! '$ROUTE_END_CODE
+          ROUTE_SOURCE=$ROUTE_START
       fi
       #done processing the ROUTE statement, skip to read next line from file
       continue;
@@ -1686,6 +1987,10 @@ function build_system_configuration_from_file {
   LOCAL_CLIENT_INDEX=""
   GAIN_ADJUST=""
   mixmatrix_string=''
+  ACDF_CASCADE="false"  #ACDf filters are not combined into cascades unless requested
+  ACDF_CASCADE_MODE=0  #calculation mode of the ACDfCascade elements, 0=direct form
+  ALIGN_ROUTES="true"  #routes with less latency are delayed to match the others
+  TELEMETRY="false"  #the plugins do not publish level meters unless requested
 
   #reset the client counter to zero:
   CLIENT_INDEX=-1 #need to initialize to -1 because BASH arrays are zero-offset
@@ -1979,6 +2284,19 @@ function build_gstreamer_pipeline {
 
 
 
+function telemetry_environment {
+  #prints the environment variable that makes the LADSPA plugins publish their level
+  #  meters (TELEMETRY = true) and also their timing (TELEMETRY = timing) in shared
+  #  memory, or nothing. It is put in front of gst-launch-1.0 on the server and on
+  #  the clients. See LADSPA/common/telemetry.h
+  if [[ "$TELEMETRY" == "true" ]]; then
+    echo "GSASYSCON_TELEMETRY=1"
+  elif [[ "$TELEMETRY" == "timing" ]]; then
+    echo "GSASYSCON_TELEMETRY=2"
+  fi
+}
+
+
 function launch_server_pipeline {
   #print out GST_SERVER_CODE for debugging purposes
    if [[ "$DEBUG_MODE" != "" ]]; then
@@ -1988,14 +2306,16 @@ function launch_server_pipeline {
      echo; echo
    fi
  
-  #launch gstreamer pipeline as nohup background and direct output to /dev/null
+  #launch gstreamer pipeline as nohup background and direct output to /dev/null.
+  #  The pipeline holds the LADSPA plugins of a LOCAL_PLAYBACK client, so it gets
+  #  their telemetry setting, see telemetry_environment
   if [[ "$DEBUG_MODE" == "" ]]; then
-    eval nohup gst-launch-1.0 ${GST_SERVER_CODE[@]} 1> /dev/null 2> /dev/null &
+    eval $(telemetry_environment) nohup gst-launch-1.0 ${GST_SERVER_CODE[@]} 1> /dev/null 2> /dev/null &
   fi
   #launch gstreamer pipeline as nohup background and direct debug output to file
   if [[ "$DEBUG_MODE" == "run" ]]; then
     echo 'launching server-side gstreamer pipeline with debug output enabled...'           
-    eval nohup gst-launch-1.0 --gst-debug-level=$GSTREAMER_DEBUG_LEVEL ${GST_SERVER_CODE[@]} 1> gstreamer_output.out 2> gstreamer_output.err &
+    eval $(telemetry_environment) nohup gst-launch-1.0 --gst-debug-level=$GSTREAMER_DEBUG_LEVEL ${GST_SERVER_CODE[@]} 1> gstreamer_output.out 2> gstreamer_output.err &
   fi
   if [[ "$DEBUG_MODE" == "no-run" ]]; then
     echo 'generating server-side gstreamer pipeline. Pipeline execution disabled...'
@@ -2113,11 +2433,12 @@ function launch_system_clients {
     fi
 
     #run gstreamer pipeline on client as nohup background and direct output to file
+    #  with the telemetry setting of the LADSPA plugins, see telemetry_environment
     if [[ "$DEBUG_MODE" == "" ]]; then
-      eval nohup gst-launch-1.0 "${GST_ARGS[@]}" 1> /dev/null 2> /dev/null &
+      eval $(telemetry_environment) nohup gst-launch-1.0 "${GST_ARGS[@]}" 1> /dev/null 2> /dev/null &
     fi
     if [[ "$DEBUG_MODE" == "run" ]]; then
-      eval nohup gst-launch-1.0 --gst-debug-level=$GSTREAMER_DEBUG_LEVEL "${GST_ARGS[@]}" 1> gstreamer_output.out 2> gstreamer_output.err &
+      eval $(telemetry_environment) nohup gst-launch-1.0 --gst-debug-level=$GSTREAMER_DEBUG_LEVEL "${GST_ARGS[@]}" 1> gstreamer_output.out 2> gstreamer_output.err &
     fi  
   
     #give the process some time to start
@@ -2758,9 +3079,9 @@ function show_client_status_info {
     commit_to_log $message
     return
   fi
-  #check if there are any remote clients for this system
-  if [[ ${SYSTEM_CLIENTS_ACCESS_INFO[$1]} == '' ]]; then
-    message='ERROR: there are no remote clients for system #'$1
+  #check if there are any clients for this system
+  if [[ ${SYSTEM_CLIENTS_GSTLAUNCH_PATH[$1]} == '' ]]; then
+    message='ERROR: there are no clients for system #'$1
     echo $message
     sleep 4
     commit_to_log $message
@@ -2787,12 +3108,30 @@ function show_client_status_info {
 
   #separate the semicolon delimited lists into an array:
   IFS=";" read -r -a access_string_all_clients <<< "${SYSTEM_CLIENTS_ACCESS_INFO[$1]}"
+  #a system whose only client is the local playback client has one empty access string
+  if [[ ${#access_string_all_clients[@]} -eq 0 ]]; then access_string_all_clients=(''); fi
   #NOTE:the number of clients for this system is now equal to ${#access_string_all_clients[@]}
   #loop over all clients in the system, if any:
   for (( client_index=0; client_index<${#access_string_all_clients[@]}; client_index++ )); do
     client_access_string=${access_string_all_clients[$client_index]}
     IP_address=${client_access_string#*@}
     printf "%-7s" "   $1"
+    if [[ "${client_access_string// /}" == "" ]]; then
+      #the local playback client has no access string. It is part of the server
+      #  pipeline, whose pid is in the PID file of the system.
+      printf "%-16s" 'LOCAL_PLAYBACK'
+      printf "%-12s" 'LOCAL'
+      pid_of_gstreamer=""
+      if [ -f "${SYSTEM_DIRECTORY_NAME[$1]}/PID" ]; then pid_of_gstreamer=$(cat "${SYSTEM_DIRECTORY_NAME[$1]}/PID"); fi
+      if [[ $pid_of_gstreamer != '' ]] && ps -p $pid_of_gstreamer > /dev/null; then
+        echo 'RUNNING'
+        #show the level meters of the plugins, as for the remote clients below
+        command -v gsasyscon_meters > /dev/null && gsasyscon_meters -p $pid_of_gstreamer 2> /dev/null | sed 's/^/       /'
+      else
+        echo 'NOT RUNNING'
+      fi
+      continue
+    fi
     printf "%-16s" "$IP_address"
     #check that client can be reached via its ip address
     ping -c 1 -w 2 "$IP_address" &>/dev/null
@@ -2809,6 +3148,10 @@ function show_client_status_info {
       if [[ $pid_of_gstreamer != '' ]]
       then
         echo 'RUNNING'
+        #show the level meters of the plugins if the system runs with TELEMETRY = true
+        #  or timing and gsasyscon_meters is installed on the client. This only reads
+        #  shared memory.
+        "${access_string_arr[@]}" "command -v gsasyscon_meters > /dev/null && gsasyscon_meters -p $pid_of_gstreamer 2> /dev/null" | sed 's/^/       /'
       else
         echo 'NOT RUNNING'
       fi
@@ -2991,7 +3334,7 @@ function execute_user_action {
     ;;
   c)
     #show client status info
-    echo; echo "Enter the system number to see the status of its remote clients:"
+    echo; echo "Enter the system number to see the status of its clients:"
     read -t $TIMEOUT_TIME system_counter #wait for user input until TIMEOUT_TIME has passed
     if [ "$?" != "0" ]; then #if read timed out, then...
       echo "A system number was not entered and the option has timed out..."
@@ -3657,7 +4000,7 @@ declare -A permissible_responses
 permissible_responses[h]='display this list of valid user actions'
 permissible_responses[H]='print the GSASysCon help file to the screen'
 permissible_responses[r]='show on/off status for all registered systems'
-permissible_responses[c]="show the status for a system's remote clients" 
+permissible_responses[c]="show the status for a system's clients" 
 permissible_responses[x]='exit GSASysCon'
 permissible_responses[v]='enter volume control environment'
 permissible_responses[m]='enter volume control environment and immediately mute'
@@ -50,6 +50,38 @@ make
 make install
 cd $saved_path
 
+#install the Convolver (FIR) LADSPA plugin
+cd ../LADSPA/Convolver
+make clean
+make
+make install
+cd $saved_path
+
+#install the Delay (fractional delay) LADSPA plugin
+cd ../LADSPA/Delay
+make clean
+make
+make install
+cd $saved_path
+
+#install the RIIR (reverse IIR allpass) LADSPA plugins. RIIR_AP1 and RIIR_AP2 are the
+#  first and second order filters, RIIR_APN cascades them to any order
+for plugin_dir in RIIR_AP1 RIIR_AP2 RIIR_APN; do
+   cd ../LADSPA/$plugin_dir
+   make clean
+   make
+   make install
+   cd $saved_path
+done
+
+#install the tools: ladspa_latency, used to time align routes with plugin latency, and
+#  gsasyscon_meters, which shows the level meters of the plugins
+cd ../LADSPA/tools
+make clean
+make
+make install
+cd $saved_path
+
 clear; echo; echo "The installation has finished."
 echo; echo; read -p "Enter y or Y to run the first-test now, any other key to skip." user_input
 